@@ -0,0 +1,153 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Compares collect and partition_results against the straightforward
+// loops that copy the values out one at a time, growing the output as
+// they go, over 1M element inputs
+
+#include <boost/result/algorithm.hpp>
+#include <boost/result/result.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <string>
+#include <vector>
+#include <iterator>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+using namespace boost::result;
+
+template<class T> T make_value( int i );
+
+template<> int make_value<int>( int i )
+{
+    return i;
+}
+
+template<> std::string make_value<std::string>( int i )
+{
+    return "a string long enough to be allocated #" + std::to_string( i );
+}
+
+template<class T> std::vector< result<T> > make_array( std::size_t n, bool errors )
+{
+    std::vector< result<T> > v;
+    v.reserve( n );
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        // with errors, every eighth element holds one
+
+        if( errors && i % 8 == 7 )
+        {
+            v.push_back( std::error_code( static_cast<int>( i ), std::generic_category() ) );
+        }
+        else
+        {
+            v.push_back( make_value<T>( static_cast<int>( i ) ) );
+        }
+    }
+
+    return v;
+}
+
+template<class T> BOOST_NOINLINE result< std::vector<T> > naive_collect( std::vector< result<T> > const& v )
+{
+    std::vector<T> w;
+
+    for( auto const& r: v )
+    {
+        if( r.has_error() ) return r.error();
+        w.push_back( r.value() );
+    }
+
+    return w;
+}
+
+template<class T> BOOST_NOINLINE result< std::vector<T> > lib_collect( std::vector< result<T> > const& v )
+{
+    return collect( v );
+}
+
+template<class T> BOOST_NOINLINE result< std::vector<T> > lib_collect_move( std::vector< result<T> >&& v )
+{
+    return collect( std::move( v ) );
+}
+
+template<class T> BOOST_NOINLINE std::size_t naive_partition( std::vector< result<T> > const& v )
+{
+    std::vector<T> w;
+    std::vector<std::error_code> e;
+
+    for( auto const& r: v )
+    {
+        if( r.has_value() )
+        {
+            w.push_back( r.value() );
+        }
+        else
+        {
+            e.push_back( r.error() );
+        }
+    }
+
+    return w.size() + e.size();
+}
+
+template<class T> BOOST_NOINLINE std::size_t lib_partition( std::vector< result<T> > const& v )
+{
+    std::vector<T> w;
+    std::vector<std::error_code> e;
+
+    w.reserve( v.size() );
+
+    partition_results( v, std::back_inserter( w ), std::back_inserter( e ) );
+
+    return w.size() + e.size();
+}
+
+std::size_t const N = 1000000;
+int const M = 10;
+
+template<class F> void test_( char const* type, char const* op, F f )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::size_t s = 0;
+
+    for( int j = 0; j < M; ++j )
+    {
+        s += f();
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << std::setw( 14 ) << type << std::setw( 24 ) << op << ": " << std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() << " ms (" << s << ")" << std::endl;
+}
+
+template<class T> void test( char const* type )
+{
+    std::vector< result<T> > v = make_array<T>( N, false );
+
+    test_( type, "naive collect", [&]{ return naive_collect( v )->size(); } );
+    test_( type, "collect", [&]{ return lib_collect( v )->size(); } );
+
+    // the move needs a fresh copy of the input each time; it's made in
+    // the loop for the naive version too, so the two are comparable
+
+    test_( type, "copy + collect", [&]{ auto w = v; return lib_collect( w )->size(); } );
+    test_( type, "copy + collect(move)", [&]{ auto w = v; return lib_collect_move( std::move( w ) )->size(); } );
+
+    std::vector< result<T> > v2 = make_array<T>( N, true );
+
+    test_( type, "naive partition", [&]{ return naive_partition( v2 ); } );
+    test_( type, "partition_results", [&]{ return lib_partition( v2 ); } );
+}
+
+int main()
+{
+    test<int>( "int" );
+    test<std::string>( "std::string" );
+}
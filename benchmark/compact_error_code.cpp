@@ -0,0 +1,60 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Compares the call overhead of result<int> (returned in memory on the
+// SysV ABI) against result<int, compact_error_code> (returned in registers)
+
+#include <boost/result/result.hpp>
+#include <boost/result/compact_error_code.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cerrno>
+
+using namespace boost::result;
+
+template<class E> BOOST_NOINLINE result<int, E> f( int x )
+{
+    if( x % 1000 == 999 )
+    {
+        return E( EINVAL, std::generic_category() );
+    }
+
+    return x;
+}
+
+template<class E> void test( char const* name )
+{
+    int const N = 100000000;
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    long long s = 0;
+
+    for( int i = 0; i < N; ++i )
+    {
+        result<int, E> r = f<E>( i );
+
+        if( r )
+        {
+            s += *r;
+        }
+        else
+        {
+            s -= r.error().value();
+        }
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << std::setw( 24 ) << name << " (" << sizeof( result<int, E> ) << " bytes): " << std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() << " ms; S=" << s << std::endl;
+}
+
+int main()
+{
+    test<std::error_code>( "std::error_code" );
+    test<compact_error_code>( "compact_error_code" );
+}
@@ -0,0 +1,156 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Compares propagating an error through three layers as std::error_code,
+// as context_error_code with a record added per layer, and as an error
+// carrying its context in a std::string, at several error rates
+
+#include <boost/result/context_error_code.hpp>
+#include <boost/result/result.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cerrno>
+
+using namespace boost::result;
+
+struct string_error
+{
+    std::error_code code;
+    std::string context;
+
+    string_error( std::error_code const& ec ): code( ec )
+    {
+    }
+
+    void add_context( char const* operation, std::string const& key = std::string(), std::uint64_t offset = 0 )
+    {
+        if( !context.empty() ) context += ", ";
+
+        context += "in ";
+        context += operation;
+
+        if( !key.empty() )
+        {
+            context += " '";
+            context += key;
+            context += "'";
+        }
+
+        if( offset )
+        {
+            context += " at ";
+            context += std::to_string( offset );
+        }
+    }
+
+    int value() const noexcept
+    {
+        return code.value();
+    }
+};
+
+static std::string const key = "data.bin";
+
+int M = 1000; // one error per M calls
+
+BOOST_NOINLINE result<int> read_block( int x )
+{
+    if( x % M == M - 1 ) return std::error_code( EIO, std::generic_category() );
+    return x;
+}
+
+template<class E> void add_context( E& e, char const* operation, std::uint64_t offset )
+{
+    e.add_context( operation, key, offset );
+}
+
+void add_context( std::error_code&, char const*, std::uint64_t )
+{
+}
+
+template<class E> BOOST_NOINLINE result<int, E> make_error( std::error_code const& ec, char const* operation, std::uint64_t offset )
+{
+    E e( ec );
+    add_context( e, operation, offset );
+
+    return e;
+}
+
+template<class E> BOOST_NOINLINE result<int, E> make_error( E const& e0, char const* operation, std::uint64_t offset )
+{
+    E e( e0 );
+    add_context( e, operation, offset );
+
+    return e;
+}
+
+template<class E, class R> result<int, E> with_context( R&& r, char const* operation, std::uint64_t offset = 0 )
+{
+    if( r ) return *r;
+    return make_error<E>( r.error(), operation, offset );
+}
+
+template<class E> BOOST_NOINLINE result<int, E> read_header( int x )
+{
+    return with_context<E>( read_block( x ), "read_block", x );
+}
+
+template<class E> BOOST_NOINLINE result<int, E> parse_header( int x )
+{
+    return with_context<E>( read_header<E>( x ), "parse_header" );
+}
+
+template<class E> BOOST_NOINLINE result<int, E> load_config( int x )
+{
+    return with_context<E>( parse_header<E>( x ), "load_config" );
+}
+
+template<class E> void test( char const* name )
+{
+    int const N = 20000000;
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    long long s = 0;
+
+    for( int i = 0; i < N; ++i )
+    {
+        error_context_scope scope;
+
+        result<int, E> r = load_config<E>( i );
+
+        if( r )
+        {
+            s += *r;
+        }
+        else
+        {
+            s -= r.error().value();
+        }
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << std::setw( 20 ) << name << " (" << sizeof( result<int, E> ) << " bytes): " << std::setw( 5 ) << std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() << " ms; S=" << s << std::endl;
+}
+
+int main()
+{
+    for( int m: { 1000000, 1000, 10, 1 } )
+    {
+        M = m;
+
+        std::cout << "One error per " << m << " calls:\n";
+
+        test<std::error_code>( "std::error_code" );
+        test<context_error_code>( "context_error_code" );
+        test<string_error>( "string context" );
+
+        std::cout << std::endl;
+    }
+}
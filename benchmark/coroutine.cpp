@@ -0,0 +1,133 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Compares a chain of result-returning coroutines using co_await with the
+// same chain written with BOOST_RESULT_TRY, and counts the heap
+// allocations made on the happy path after the first call
+
+#include <boost/result/coroutine.hpp>
+#include <boost/config/pragma_message.hpp>
+
+#if !defined(BOOST_RESULT_HAS_COROUTINES)
+
+BOOST_PRAGMA_MESSAGE( "Skipping benchmark because BOOST_RESULT_HAS_COROUTINES is not defined" )
+
+int main() {}
+
+#else
+
+#include <boost/result/try.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <new>
+#include <cerrno>
+
+static unsigned long allocations = 0;
+
+void* operator new( std::size_t n )
+{
+    ++allocations;
+
+    if( void* p = std::malloc( n ) ) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete( void* p ) noexcept
+{
+    std::free( p );
+}
+
+void operator delete( void* p, std::size_t ) noexcept
+{
+    std::free( p );
+}
+
+using namespace boost::result;
+
+BOOST_NOINLINE result<int> leaf( int x )
+{
+    if( x < 0 ) return std::error_code( EINVAL, std::generic_category() );
+    return x + 1;
+}
+
+// coroutines
+
+BOOST_NOINLINE result<int> co_1( int x )
+{
+    int y = co_await leaf( x );
+    co_return y * 2;
+}
+
+BOOST_NOINLINE result<int> co_2( int x )
+{
+    int y = co_await co_1( x );
+    int z = co_await leaf( y );
+    co_return y + z;
+}
+
+BOOST_NOINLINE result<int> co_3( int x )
+{
+    int y = co_await co_2( x );
+    co_return y - 1;
+}
+
+// BOOST_RESULT_TRY
+
+BOOST_NOINLINE result<int> try_1( int x )
+{
+    BOOST_RESULT_TRY( int y, leaf( x ) );
+    return y * 2;
+}
+
+BOOST_NOINLINE result<int> try_2( int x )
+{
+    BOOST_RESULT_TRY( int y, try_1( x ) );
+    BOOST_RESULT_TRY( int z, leaf( y ) );
+    return y + z;
+}
+
+BOOST_NOINLINE result<int> try_3( int x )
+{
+    BOOST_RESULT_TRY( int y, try_2( x ) );
+    return y - 1;
+}
+
+int const N = 10000000;
+
+template<class F> void test( char const* name, F f )
+{
+    f( 1 );
+    f( -1 );
+
+    for( int x: { 1, -1 } )
+    {
+        unsigned long a = allocations;
+
+        auto t1 = std::chrono::steady_clock::now();
+
+        long s = 0;
+
+        for( int i = 0; i < N; ++i )
+        {
+            auto r = f( x * ( i & 0xFF ) - ( x < 0 ) );
+            s += r? *r: -1;
+        }
+
+        auto t2 = std::chrono::steady_clock::now();
+
+        std::cout << std::setw( 20 ) << name << ( x > 0? " (values)": " (errors)" ) << ": " << std::setw( 4 ) << std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() << " ms, " << allocations - a << " allocations (" << s << ")" << std::endl;
+    }
+}
+
+int main()
+{
+    test( "co_await", co_3 );
+    test( "BOOST_RESULT_TRY", try_3 );
+}
+
+#endif
@@ -0,0 +1,95 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Compares the per-thread error counters against a shared atomic counter
+// per error and a map protected by a mutex, with 1 to 8 threads counting
+// errors concurrently
+
+#include <boost/result/error_counters.hpp>
+#include <system_error>
+#include <mutex>
+#include <map>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+using namespace boost::result;
+
+int const N = 4000000; // errors per run
+int const K = 8; // distinct error values
+
+struct per_thread_
+{
+    void count( std::error_category const& cat, int v )
+    {
+        count_error( cat, v );
+    }
+};
+
+struct atomic_
+{
+    std::atomic<std::uint64_t> counts[ K ] = {};
+
+    void count( std::error_category const&, int v )
+    {
+        counts[ v ].fetch_add( 1, std::memory_order_relaxed );
+    }
+};
+
+struct mutex_
+{
+    std::mutex mx;
+    std::map<std::pair<std::error_category const*, int>, std::uint64_t> counts;
+
+    void count( std::error_category const& cat, int v )
+    {
+        std::lock_guard<std::mutex> lock( mx );
+        ++counts[ std::make_pair( &cat, v ) ];
+    }
+};
+
+template<class C> void test( char const* name, int k )
+{
+    C c;
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> th;
+
+    for( int i = 0; i < k; ++i )
+    {
+        th.emplace_back( [&]{
+
+            for( int j = 0; j < N / k; ++j )
+            {
+                c.count( std::generic_category(), j % K );
+            }
+        });
+    }
+
+    for( auto& x: th ) x.join();
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << std::setw( 20 ) << name << ", " << k << " threads: " << std::setw( 5 ) << std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() << " ms" << std::endl;
+}
+
+int main()
+{
+    for( int k: { 1, 2, 4, 8 } )
+    {
+        test<per_thread_>( "per-thread counters", k );
+        test<atomic_>( "shared atomics", k );
+        test<mutex_>( "mutex and map", k );
+    }
+
+    std::uint64_t n = 0;
+
+    for( error_count const& e: error_counts() ) n += e.count;
+
+    std::cout << "\nCounted: " << n << std::endl;
+}
@@ -0,0 +1,122 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Compares the cost, on the logging threads, of logging an error result with
+// error_logger against writing it with operator<< to a stream protected by
+// a mutex, with 1 to 8 threads logging concurrently
+
+#define BOOST_RESULT_ERROR_LOGGER_RING_SIZE 65536
+
+#include <boost/result/error_logger.hpp>
+#include <system_error>
+#include <streambuf>
+#include <ostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cerrno>
+
+using namespace boost::result;
+
+int const N = 1000000; // errors per run
+
+// formats, then discards
+
+struct null_buffer: std::streambuf
+{
+    int overflow( int c ) override
+    {
+        return c;
+    }
+};
+
+struct logger_
+{
+    null_buffer nb;
+    std::ostream os;
+    error_logger log;
+
+    logger_(): os( &nb ), log( os )
+    {
+    }
+
+    void write( result<int> const& r )
+    {
+        log.log( r );
+    }
+
+    std::uint64_t dropped()
+    {
+        return log.dropped();
+    }
+};
+
+struct ostream_
+{
+    null_buffer nb;
+    std::ostream os;
+    std::mutex mx;
+
+    ostream_(): os( &nb )
+    {
+    }
+
+    void write( result<int> const& r )
+    {
+        std::lock_guard<std::mutex> lock( mx );
+        os << r << '\n';
+    }
+
+    std::uint64_t dropped()
+    {
+        return 0;
+    }
+};
+
+template<class L> void test( char const* name, int k )
+{
+    L l;
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> th;
+
+    for( int i = 0; i < k; ++i )
+    {
+        th.emplace_back( [&]{
+
+            for( int j = 0; j < N / k; ++j )
+            {
+                l.write( result<int>( EINVAL + j % 8, std::generic_category() ) );
+            }
+        });
+    }
+
+    for( auto& x: th ) x.join();
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << std::setw( 12 ) << name << ", " << k << " threads: " << std::setw( 5 ) << std::chrono::duration_cast<std::chrono::nanoseconds>( t2 - t1 ).count() / N << " ns per error";
+
+    std::uint64_t dropped = l.dropped();
+
+    if( dropped )
+    {
+        std::cout << " (" << dropped << " dropped)";
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    for( int k: { 1, 2, 4, 8 } )
+    {
+        test<logger_>( "error_logger", k );
+        test<ostream_>( "operator<<", k );
+    }
+}
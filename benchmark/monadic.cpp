@@ -0,0 +1,88 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Compares a five stage and_then/transform chain against the equivalent
+// hand-written if-ladder. The code generated for ladder() and chain() can
+// be compared with e.g. `g++ -O2 -S -Iinclude benchmark/monadic.cpp`.
+
+#include <boost/result/result.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cerrno>
+
+using namespace boost::result;
+
+inline result<int> step( int x )
+{
+    if( x % 1000 == 999 )
+    {
+        return std::error_code( EINVAL, std::generic_category() );
+    }
+
+    return x + 1;
+}
+
+inline int scale( int x )
+{
+    return x * 3;
+}
+
+BOOST_NOINLINE result<int> ladder( int x )
+{
+    result<int> r1 = step( x );
+    if( !r1 ) return r1.error();
+
+    result<int> r2 = step( *r1 );
+    if( !r2 ) return r2.error();
+
+    int v3 = scale( *r2 );
+
+    result<int> r4 = step( v3 );
+    if( !r4 ) return r4.error();
+
+    return scale( *r4 );
+}
+
+BOOST_NOINLINE result<int> chain( int x )
+{
+    return step( x ).and_then( step ).transform( scale ).and_then( step ).transform( scale );
+}
+
+template<class F> void test( char const* name, F f )
+{
+    int const N = 100000000;
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    long long s = 0;
+
+    for( int i = 0; i < N; ++i )
+    {
+        result<int> r = f( i );
+
+        if( r )
+        {
+            s += *r;
+        }
+        else
+        {
+            s -= r.error().value();
+        }
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << std::setw( 8 ) << name << ": " << std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() << " ms; S=" << s << std::endl;
+}
+
+int main()
+{
+    test( "ladder", ladder );
+    test( "chain", chain );
+    test( "ladder", ladder );
+    test( "chain", chain );
+}
@@ -0,0 +1,85 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Measures the scaling of parallel_collect and parallel_reduce from one
+// thread to std::thread::hardware_concurrency(), over 1M elements with a
+// CPU-heavy validation function; "early error" places an error at 1% of
+// the input, to show the cancellation of the remaining chunks
+
+#include <boost/result/parallel.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+
+using namespace boost::result;
+
+std::size_t const N = 1000000;
+
+struct validate
+{
+    std::uint32_t bad;
+
+    result<std::uint32_t> operator()( std::uint32_t x ) const
+    {
+        if( x == bad ) return std::error_code( EINVAL, std::generic_category() );
+
+        // stands in for real work, about 100 ns per element
+
+        std::uint32_t h = x;
+
+        for( int i = 0; i < 64; ++i )
+        {
+            h = ( h ^ ( h >> 15 ) ) * 0x2c1b3c6dU;
+        }
+
+        return h;
+    }
+};
+
+static std::uint32_t combine( std::uint32_t x, std::uint32_t y )
+{
+    return x ^ y;
+}
+
+template<class F> void test_( unsigned threads, char const* op, F f )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    bool ok = f();
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << std::setw( 4 ) << threads << " threads" << std::setw( 36 ) << op << ": " << std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() << " ms" << ( ok? "": " (failed)" ) << std::endl;
+}
+
+int main( int argc, char const* argv[] )
+{
+    std::vector<std::uint32_t> v( N );
+
+    for( std::size_t i = 0; i < N; ++i ) v[ i ] = static_cast<std::uint32_t>( i );
+
+    // the maximum thread count can be given on the command line
+
+    unsigned hc = argc > 1? static_cast<unsigned>( std::atoi( argv[ 1 ] ) ): std::thread::hardware_concurrency();
+    if( hc == 0 ) hc = 1;
+
+    std::cout << "hardware_concurrency: " << std::thread::hardware_concurrency() << std::endl;
+
+    for( unsigned t = 1; t <= hc; t *= 2 )
+    {
+        test_( t, "parallel_collect", [&]{ return parallel_collect( v, validate{ 0xFFFFFFFFu }, t ).has_value(); } );
+        test_( t, "parallel_reduce", [&]{ return parallel_reduce( v, validate{ 0xFFFFFFFFu }, 0u, combine, t ).has_value(); } );
+        test_( t, "parallel_collect, early error", [&]{ return parallel_collect( v, validate{ N / 100 }, t ).has_error(); } );
+        test_( t, "parallel_collect_all, early error", [&]{ return parallel_collect_all( v, validate{ N / 100 }, t ).has_error(); } );
+
+        if( t < hc && t * 2 > hc ) t = hc / 2;
+    }
+}
@@ -0,0 +1,220 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Measures the throughput of result_channel, with single and batch
+// operations, against a bounded queue protected by a mutex, with 1 to 16
+// producers and as many consumers
+
+#include <boost/result/result_channel.hpp>
+#include <system_error>
+#include <condition_variable>
+#include <mutex>
+#include <deque>
+#include <iterator>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cerrno>
+
+using namespace boost::result;
+
+std::size_t const capacity = 1024;
+int const N = 2000000; // total items per run
+int const B = 16; // batch size
+
+class mutex_queue
+{
+private:
+
+    std::mutex mx_;
+    std::condition_variable not_full_, not_empty_;
+    std::deque< result<int> > q_;
+    bool closed_ = false;
+
+public:
+
+    void push( result<int> r )
+    {
+        std::unique_lock<std::mutex> lock( mx_ );
+
+        not_full_.wait( lock, [&]{ return q_.size() < capacity; } );
+        q_.push_back( std::move( r ) );
+
+        lock.unlock();
+        not_empty_.notify_one();
+    }
+
+    bool pop( result<int>& r )
+    {
+        std::unique_lock<std::mutex> lock( mx_ );
+
+        not_empty_.wait( lock, [&]{ return !q_.empty() || closed_; } );
+
+        if( q_.empty() ) return false;
+
+        r = std::move( q_.front() );
+        q_.pop_front();
+
+        lock.unlock();
+        not_full_.notify_one();
+
+        return true;
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock( mx_ );
+            closed_ = true;
+        }
+
+        not_empty_.notify_all();
+    }
+};
+
+// every sixteenth item is an error
+
+static result<int> make( int i )
+{
+    if( i % 16 == 0 ) return std::error_code( EINVAL, std::generic_category() );
+    return i;
+}
+
+struct mutex_
+{
+    mutex_queue q;
+
+    void produce( int n )
+    {
+        for( int i = 0; i < n; ++i ) q.push( make( i ) );
+    }
+
+    long consume()
+    {
+        long s = 0;
+        result<int> r;
+
+        while( q.pop( r ) ) s += r? 1: 0;
+
+        return s;
+    }
+
+    void close() { q.close(); }
+};
+
+struct channel_
+{
+    result_channel<int> ch{ capacity };
+
+    void produce( int n )
+    {
+        for( int i = 0; i < n; ++i ) ch.push( make( i ) );
+    }
+
+    long consume()
+    {
+        long s = 0;
+        result<int> r;
+
+        while( ch.pop( r ) ) s += r? 1: 0;
+
+        return s;
+    }
+
+    void close() { ch.close( ECANCELED, std::generic_category() ); }
+};
+
+struct channel_batch_
+{
+    result_channel<int> ch{ capacity };
+
+    void produce( int n )
+    {
+        std::vector< result<int> > v;
+
+        for( int i = 0; i < n; i += B )
+        {
+            v.clear();
+
+            for( int j = i; j < i + B && j < n; ++j ) v.push_back( make( j ) );
+
+            for( std::size_t k = 0; k < v.size(); )
+            {
+                std::size_t m = ch.try_push_n( v.begin() + k, v.size() - k );
+                if( m == 0 ) std::this_thread::yield();
+                k += m;
+            }
+        }
+    }
+
+    long consume()
+    {
+        long s = 0;
+
+        std::vector< result<int> > v;
+        v.reserve( B );
+
+        for( ;; )
+        {
+            v.clear();
+
+            if( ch.try_pop_n( std::back_inserter( v ), B ) == 0 )
+            {
+                result<int> r;
+                channel_status st = ch.try_pop( r );
+
+                if( st == channel_status::closed ) break;
+                if( st == channel_status::empty ) { std::this_thread::yield(); continue; }
+
+                v.push_back( r );
+            }
+
+            for( auto const& r: v ) s += r? 1: 0;
+        }
+
+        return s;
+    }
+
+    void close() { ch.close( ECANCELED, std::generic_category() ); }
+};
+
+template<class Q> void test( char const* name, int k )
+{
+    Q q;
+
+    std::atomic<long> s( 0 );
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> producers, consumers;
+
+    for( int i = 0; i < k; ++i )
+    {
+        producers.emplace_back( [&]{ q.produce( N / k ); } );
+        consumers.emplace_back( [&]{ s += q.consume(); } );
+    }
+
+    for( auto& th: producers ) th.join();
+
+    q.close();
+
+    for( auto& th: consumers ) th.join();
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << std::setw( 16 ) << name << ", " << std::setw( 2 ) << k << " producers/consumers: " << std::setw( 5 ) << std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() << " ms (" << s << ")" << std::endl;
+}
+
+int main()
+{
+    for( int k: { 1, 2, 4, 8, 16 } )
+    {
+        test<mutex_>( "mutex queue", k );
+        test<channel_>( "result_channel", k );
+        test<channel_batch_>( "batches of 16", k );
+    }
+}
@@ -0,0 +1,128 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Measures the round trip latency of handing a result between two
+// threads, one promise/future pair in each direction, against
+// std::promise/std::future with the error carried as an exception; K
+// such thread pairs run at the same time to add contention
+
+#include <boost/result/result_future.hpp>
+#include <system_error>
+#include <stdexcept>
+#include <future>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cerrno>
+
+using namespace boost::result;
+
+int const N = 20000;
+
+// every sixteenth handoff carries an error
+
+struct boost_result_
+{
+    template<class T> using promise = result_promise<T>;
+
+    static void set( promise<int>& p, int i )
+    {
+        if( i % 16 == 0 )
+        {
+            p.set_error( EINVAL, std::generic_category() );
+        }
+        else
+        {
+            p.set_value( i );
+        }
+    }
+
+    static int get( promise<int>& p )
+    {
+        result<int> r = p.get_future().get();
+        return r? *r: -1;
+    }
+};
+
+struct std_
+{
+    template<class T> using promise = std::promise<T>;
+
+    static void set( promise<int>& p, int i )
+    {
+        if( i % 16 == 0 )
+        {
+            p.set_exception( std::make_exception_ptr( std::system_error( EINVAL, std::generic_category() ) ) );
+        }
+        else
+        {
+            p.set_value( i );
+        }
+    }
+
+    static int get( promise<int>& p )
+    {
+        try
+        {
+            return p.get_future().get();
+        }
+        catch( std::system_error const& )
+        {
+            return -1;
+        }
+    }
+};
+
+// the futures are obtained from the promises by the consuming thread
+
+template<class X> void ping_pong()
+{
+    std::vector< typename X::template promise<int> > p1( N ), p2( N );
+
+    std::thread th( [&]{
+
+        for( int i = 0; i < N; ++i )
+        {
+            X::set( p2[ i ], X::get( p1[ i ] ) + 1 );
+        }
+
+    });
+
+    for( int i = 0; i < N; ++i )
+    {
+        X::set( p1[ i ], i );
+        X::get( p2[ i ] );
+    }
+
+    th.join();
+}
+
+template<class X> void test( char const* name, int k )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> th;
+
+    for( int j = 0; j < k; ++j )
+    {
+        th.emplace_back( ping_pong<X> );
+    }
+
+    for( auto& x: th ) x.join();
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << std::setw( 20 ) << name << ", " << k << " pairs: " << std::setw( 6 ) << std::chrono::duration_cast<std::chrono::nanoseconds>( t2 - t1 ).count() / N / k << " ns per round trip" << std::endl;
+}
+
+int main()
+{
+    for( int k: { 1, 2, 4 } )
+    {
+        test<std_>( "std::future", k );
+        test<boost_result_>( "result_future", k );
+    }
+}
@@ -0,0 +1,176 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Measures swap and move assignment over arrays of results holding a mix
+// of values and errors, for the types in test/result_swap.cpp and
+// test/result_move_assign.cpp; "generic swap" is the three move swap
+// that std::swap would do
+
+#include <boost/result/result.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <string>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cerrno>
+
+using namespace boost::result;
+
+// moves may throw
+
+struct X
+{
+    int v_;
+
+    explicit X( int v ): v_( v ) {}
+
+    X( X&& r ): v_( r.v_ ) { r.v_ = 0; }
+
+    X& operator=( X&& r )
+    {
+        v_ = r.v_;
+        r.v_ = 0;
+
+        return *this;
+    }
+};
+
+// moves don't throw
+
+struct Y
+{
+    int v_;
+
+    explicit Y( int v = 0 ): v_( v ) {}
+
+    Y( Y&& r ) noexcept: v_( r.v_ ) { r.v_ = 0; }
+
+    Y& operator=( Y&& r ) noexcept
+    {
+        v_ = r.v_;
+        r.v_ = 0;
+
+        return *this;
+    }
+};
+
+// owns a heap object, declared trivially relocatable
+
+struct Z
+{
+    std::unique_ptr<int> p_;
+
+    explicit Z( int v ): p_( new int( v ) ) {}
+};
+
+namespace boost
+{
+namespace result
+{
+
+template<> struct is_trivially_relocatable<Z>: std::true_type
+{
+};
+
+} // namespace result
+} // namespace boost
+
+template<class R> struct make;
+
+template<class T, class E> struct make< result<T, E> >
+{
+    static result<T, E> value( int i ) { return result<T, E>( in_place_value, i ); }
+    static result<T, E> error( int i ) { return result<T, E>( in_place_error, i ); }
+};
+
+template<class E> struct make< result<std::string, E> >
+{
+    static result<std::string, E> value( int i ) { return result<std::string, E>( in_place_value, std::to_string( i ) ); }
+    static result<std::string, E> error( int i ) { return result<std::string, E>( in_place_error, i ); }
+};
+
+template<class T> struct make< result<T, std::error_code> >
+{
+    static result<T, std::error_code> value( int i ) { return result<T, std::error_code>( in_place_value, i ); }
+    static result<T, std::error_code> error( int i ) { return result<T, std::error_code>( in_place_error, i, std::generic_category() ); }
+};
+
+template<class R> std::vector<R> make_array( std::size_t n )
+{
+    std::vector<R> v;
+    v.reserve( n );
+
+    unsigned x = 1;
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        // a quarter of the elements hold errors
+
+        x = x * 1103515245u + 12345u;
+        v.push_back( ( x >> 16 ) % 4 == 0? make<R>::error( static_cast<int>( i ) ): make<R>::value( static_cast<int>( i ) ) );
+    }
+
+    return v;
+}
+
+template<class R> BOOST_NOINLINE void generic_swap( R& r1, R& r2 )
+{
+    R tmp( std::move( r1 ) );
+    r1 = std::move( r2 );
+    r2 = std::move( tmp );
+}
+
+template<class R> BOOST_NOINLINE void member_swap( R& r1, R& r2 )
+{
+    r1.swap( r2 );
+}
+
+template<class R> BOOST_NOINLINE void move_assign( R& r1, R& r2 )
+{
+    r1 = std::move( r2 );
+}
+
+std::size_t const N = 1000;
+int const M = 20000;
+
+template<class R, class F> void test_( char const* type, char const* op, F f )
+{
+    std::vector<R> v1 = make_array<R>( N );
+    std::vector<R> v2 = make_array<R>( N + 1 );
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    for( int j = 0; j < M; ++j )
+    {
+        for( std::size_t i = 0; i < N; ++i )
+        {
+            f( v1[ i ], v2[ i + j % 2 ] );
+        }
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << std::setw( 36 ) << type << std::setw( 14 ) << op << ": " << std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() << " ms" << std::endl;
+}
+
+template<class R> void test( char const* type )
+{
+    test_<R>( type, "generic swap", generic_swap<R> );
+    test_<R>( type, "swap", member_swap<R> );
+    test_<R>( type, "move assign", move_assign<R> );
+}
+
+int main()
+{
+    test< result<int> >( "result<int>" );
+    test< result<int, int> >( "result<int, int>" );
+    test< result<X> >( "result<X>" );
+    test< result<Y> >( "result<Y>" );
+    test< result<X, Y> >( "result<X, Y>" );
+    test< result<Z, Z> >( "result<Z, Z>" );
+    test< result<std::string, Y> >( "result<std::string, Y>" );
+}
@@ -0,0 +1,86 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Measures the cost of returning errors as traced_error_code, with stack
+// trace capture off and sampled at several rates, against std::error_code
+
+#include <boost/result/traced_error_code.hpp>
+#include <boost/result/result.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cerrno>
+
+using namespace boost::result;
+
+template<class E> BOOST_NOINLINE result<int, E> f( int x )
+{
+    if( x % 10 == 9 )
+    {
+        return E( EINVAL, std::generic_category() );
+    }
+
+    return x;
+}
+
+template<class E> BOOST_NOINLINE result<int, E> g( int x )
+{
+    auto r = f<E>( x );
+
+    if( !r ) return r;
+    return *r + 1;
+}
+
+template<class E> BOOST_NOINLINE result<int, E> h( int x )
+{
+    auto r = g<E>( x );
+
+    if( !r ) return r;
+    return *r + 1;
+}
+
+template<class E> void test( char const* name )
+{
+    int const N = 10000000; // one million errors
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    long long s = 0;
+
+    for( int i = 0; i < N; ++i )
+    {
+        result<int, E> r = h<E>( i );
+
+        if( r )
+        {
+            s += *r;
+        }
+        else
+        {
+            s -= r.error().value();
+        }
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << std::setw( 32 ) << name << ": " << std::setw( 5 ) << std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() << " ms; S=" << s << std::endl;
+}
+
+int main()
+{
+    test<std::error_code>( "std::error_code" );
+
+    test<traced_error_code>( "traced_error_code, off" );
+
+    set_stack_trace_sampling( std::generic_category(), 1000 );
+    test<traced_error_code>( "traced_error_code, 1 in 1000" );
+
+    set_stack_trace_sampling( std::generic_category(), 10 );
+    test<traced_error_code>( "traced_error_code, 1 in 10" );
+
+    set_stack_trace_sampling( std::generic_category(), 1 );
+    test<traced_error_code>( "traced_error_code, always" );
+}
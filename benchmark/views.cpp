@@ -0,0 +1,124 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Compares pipelines over 1M results built from the lazy views against
+// the same pipelines materializing a std::vector after each stage
+
+#include <boost/result/views.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cerrno>
+
+using namespace boost::result;
+
+std::size_t const N = 1000000;
+int const M = 20;
+
+static result<int> check( int x )
+{
+    if( x % 5 == 0 ) return std::error_code( EDOM, std::generic_category() );
+    return x * 3;
+}
+
+BOOST_NOINLINE long materialized_values( std::vector< result<int> > const& v )
+{
+    std::vector<int> w;
+
+    for( auto const& r: v )
+    {
+        if( r ) w.push_back( *r );
+    }
+
+    long s = 0;
+
+    for( int x: w ) s += x;
+
+    return s;
+}
+
+BOOST_NOINLINE long lazy_values( std::vector< result<int> > const& v )
+{
+    long s = 0;
+
+    for( int x: v | views::values ) s += x;
+
+    return s;
+}
+
+BOOST_NOINLINE long materialized_pipeline( std::vector< result<int> > const& v )
+{
+    std::vector< result<int> > w;
+
+    for( auto const& r: v )
+    {
+        w.push_back( r.and_then( check ) );
+    }
+
+    std::vector<int> w2;
+
+    for( auto const& r: w )
+    {
+        if( r ) w2.push_back( *r );
+    }
+
+    long s = 0;
+
+    for( int x: w2 ) s += x;
+
+    return s;
+}
+
+BOOST_NOINLINE long lazy_pipeline( std::vector< result<int> > const& v )
+{
+    long s = 0;
+
+    for( int x: v | views::and_then( check ) | views::values ) s += x;
+
+    return s;
+}
+
+template<class F> void test( char const* op, F f, std::vector< result<int> > const& v )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    long s = 0;
+
+    for( int j = 0; j < M; ++j )
+    {
+        s += f( v );
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << std::setw( 24 ) << op << ": " << std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() << " ms (" << s << ")" << std::endl;
+}
+
+int main()
+{
+    std::vector< result<int> > v;
+    v.reserve( N );
+
+    for( std::size_t i = 0; i < N; ++i )
+    {
+        // every seventh element holds an error
+
+        if( i % 7 == 0 )
+        {
+            v.push_back( std::error_code( EINVAL, std::generic_category() ) );
+        }
+        else
+        {
+            v.push_back( static_cast<int>( i ) );
+        }
+    }
+
+    test( "materialized values", materialized_values, v );
+    test( "views::values", lazy_values, v );
+    test( "materialized pipeline", materialized_pipeline, v );
+    test( "and_then | values", lazy_pipeline, v );
+}
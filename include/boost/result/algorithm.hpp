@@ -0,0 +1,180 @@
+#ifndef BOOST_RESULT_ALGORITHM_HPP_INCLUDED
+#define BOOST_RESULT_ALGORITHM_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result.hpp>
+#include <type_traits>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+//
+
+namespace boost
+{
+namespace result
+{
+
+namespace detail
+{
+
+template<class R> using range_iterator = decltype( std::begin( std::declval<R&>() ) );
+template<class R> using range_element = typename std::iterator_traits< range_iterator<R> >::value_type;
+
+// an element of an rvalue range is moved from, one of an lvalue range is copied
+
+template<class R> using range_moves = std::integral_constant<bool,
+    !std::is_lvalue_reference<R>::value && !std::is_const<typename std::remove_reference<R>::type>::value>;
+
+template<class X> X& forward_element( X& x, std::false_type ) noexcept
+{
+    return x;
+}
+
+template<class X> X&& forward_element( X& x, std::true_type ) noexcept
+{
+    return std::move( x );
+}
+
+// size_hint( r ): the size of r when known without traversing it, or 0
+
+template<class R, class En = void> struct has_size_member: std::false_type
+{
+};
+
+template<class R> struct has_size_member<R, decltype( void( std::declval<R const&>().size() ) )>: std::true_type
+{
+};
+
+template<class R, class C> std::size_t size_hint_( R const& r, std::true_type, C ) noexcept
+{
+    return static_cast<std::size_t>( r.size() );
+}
+
+template<class R> std::size_t size_hint_( R const& r, std::false_type, std::random_access_iterator_tag ) noexcept
+{
+    return static_cast<std::size_t>( std::end( r ) - std::begin( r ) );
+}
+
+template<class R> std::size_t size_hint_( R const&, std::false_type, std::input_iterator_tag ) noexcept
+{
+    return 0;
+}
+
+template<class R> std::size_t size_hint( R const& r ) noexcept
+{
+    using C = typename std::iterator_traits< range_iterator<R const> >::iterator_category;
+    using C2 = typename std::conditional<std::is_base_of<std::random_access_iterator_tag, C>::value, std::random_access_iterator_tag, std::input_iterator_tag>::type;
+
+    return size_hint_( r, has_size_member<R>(), C2() );
+}
+
+} // namespace detail
+
+// collect_into( r, out )
+//
+// Writes the values of the results in the range r to the output iterator
+// out, stopping at the first error. Returns the iterator past the last
+// value written, or the error. The elements of r are moved from when r is
+// an rvalue.
+
+template<class R, class OutIt,
+    class X = detail::range_element<R>,
+    class E = typename detail::is_result<X>::error_type>
+result<OutIt, E> collect_into( R&& r, OutIt out )
+{
+    auto last = std::end( r );
+
+    for( auto first = std::begin( r ); first != last; ++first )
+    {
+        auto&& x = *first;
+
+        if( x.has_value() )
+        {
+            *out = detail::forward_element( *x, detail::range_moves<R>() );
+            ++out;
+        }
+        else
+        {
+            return result<OutIt, E>( in_place_error, detail::forward_element( x.error(), detail::range_moves<R>() ) );
+        }
+    }
+
+    return result<OutIt, E>( in_place_value, out );
+}
+
+// collect( r )
+//
+// Returns a result<std::vector<T>, E> holding the values of the results in
+// the range r, or the first error. Reserves the size of r up front when
+// it's known. The elements of r are moved from when r is an rvalue.
+
+template<class R,
+    class X = detail::range_element<R>,
+    class T = typename detail::is_result<X>::value_type,
+    class E = typename detail::is_result<X>::error_type>
+result<std::vector<T>, E> collect( R&& r )
+{
+    std::vector<T> v;
+    v.reserve( detail::size_hint( r ) );
+
+    auto last = std::end( r );
+
+    for( auto first = std::begin( r ); first != last; ++first )
+    {
+        auto&& x = *first;
+
+        if( x.has_value() )
+        {
+            v.push_back( detail::forward_element( *x, detail::range_moves<R>() ) );
+        }
+        else
+        {
+            return result<std::vector<T>, E>( in_place_error, detail::forward_element( x.error(), detail::range_moves<R>() ) );
+        }
+    }
+
+    return result<std::vector<T>, E>( in_place_value, std::move( v ) );
+}
+
+// partition_results( r, values, errors )
+//
+// Writes the values of the results in the range r to the output iterator
+// values, and the errors to the output iterator errors. Returns the two
+// iterators past the last elements written. The elements of r are moved
+// from when r is an rvalue.
+
+template<class R, class OutIt1, class OutIt2,
+    class X = detail::range_element<R>,
+    class En = typename std::enable_if<detail::is_result<X>::value>::type>
+std::pair<OutIt1, OutIt2> partition_results( R&& r, OutIt1 values, OutIt2 errors )
+{
+    auto last = std::end( r );
+
+    for( auto first = std::begin( r ); first != last; ++first )
+    {
+        auto&& x = *first;
+
+        if( x.has_value() )
+        {
+            *values = detail::forward_element( *x, detail::range_moves<R>() );
+            ++values;
+        }
+        else
+        {
+            *errors = detail::forward_element( x.error(), detail::range_moves<R>() );
+            ++errors;
+        }
+    }
+
+    return std::make_pair( values, errors );
+}
+
+} // namespace result
+} // namespace boost
+
+#endif // #ifndef BOOST_RESULT_ALGORITHM_HPP_INCLUDED
@@ -0,0 +1,218 @@
+#ifndef BOOST_RESULT_COMPACT_ERROR_CODE_HPP_INCLUDED
+#define BOOST_RESULT_COMPACT_ERROR_CODE_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/throw_exception.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <type_traits>
+#include <stdexcept>
+#include <string>
+#include <atomic>
+#include <iosfwd>
+#include <cstdint>
+
+//
+
+#if !defined( BOOST_RESULT_MAX_ERROR_CATEGORIES )
+# define BOOST_RESULT_MAX_ERROR_CATEGORIES 256
+#endif
+
+namespace boost
+{
+namespace result
+{
+
+// category registry
+//
+// Slot 0 holds std::system_category(), so that a zero compact_error_code
+// corresponds to std::error_code(); slot 1 holds std::generic_category().
+// Other categories take the next free slot on first use.
+
+namespace detail
+{
+
+inline std::atomic<std::error_category const*>* error_category_table() noexcept
+{
+    static std::atomic<std::error_category const*> table[ BOOST_RESULT_MAX_ERROR_CATEGORIES ] = {};
+    return table;
+}
+
+} // namespace detail
+
+inline std::uint32_t register_error_category( std::error_category const & cat )
+{
+    if( cat == std::system_category() ) return 0;
+    if( cat == std::generic_category() ) return 1;
+
+    std::atomic<std::error_category const*>* table = detail::error_category_table();
+
+    for( std::uint32_t i = 2; i < BOOST_RESULT_MAX_ERROR_CATEGORIES; ++i )
+    {
+        std::error_category const* p = table[ i ].load( std::memory_order_acquire );
+
+        if( p == 0 && table[ i ].compare_exchange_strong( p, &cat, std::memory_order_acq_rel, std::memory_order_acquire ) )
+        {
+            return i;
+        }
+
+        if( *p == cat )
+        {
+            return i;
+        }
+    }
+
+    boost::throw_exception( std::length_error( "boost::result::register_error_category: too many error categories" ) );
+}
+
+inline std::error_category const & registered_error_category( std::uint32_t id ) noexcept
+{
+    if( id == 0 ) return std::system_category();
+    if( id == 1 ) return std::generic_category();
+
+    return *detail::error_category_table()[ id ].load( std::memory_order_acquire );
+}
+
+// compact_error_code
+//
+// An 8 byte equivalent of std::error_code, holding the error value and
+// the registry index of its category. Converts to and from std::error_code
+// without loss.
+
+class compact_error_code
+{
+private:
+
+    std::int32_t val_;
+    std::uint32_t cat_;
+
+public:
+
+    // constructors
+
+    constexpr compact_error_code() noexcept: val_( 0 ), cat_( 0 )
+    {
+    }
+
+    compact_error_code( int val, std::error_category const & cat ): val_( val ), cat_( register_error_category( cat ) )
+    {
+    }
+
+    compact_error_code( std::error_code const & ec ): compact_error_code( ec.value(), ec.category() )
+    {
+    }
+
+    template<class ErrorCodeEnum, class En = typename std::enable_if<
+        std::is_error_code_enum<ErrorCodeEnum>::value
+        >::type>
+    compact_error_code( ErrorCodeEnum e ): compact_error_code( make_error_code( e ) )
+    {
+    }
+
+    // modifiers
+
+    void assign( int val, std::error_category const & cat )
+    {
+        *this = compact_error_code( val, cat );
+    }
+
+    void clear() noexcept
+    {
+        val_ = 0;
+        cat_ = 0;
+    }
+
+    // observers
+
+    constexpr int value() const noexcept
+    {
+        return val_;
+    }
+
+    std::error_category const & category() const noexcept
+    {
+        return registered_error_category( cat_ );
+    }
+
+    // the index of the category in the registry
+
+    constexpr std::uint32_t category_index() const noexcept
+    {
+        return cat_;
+    }
+
+    std::string message() const
+    {
+        return category().message( val_ );
+    }
+
+    constexpr explicit operator bool() const noexcept
+    {
+        return val_ != 0;
+    }
+
+    // conversions
+
+    operator std::error_code() const noexcept
+    {
+        return std::error_code( val_, category() );
+    }
+
+    // comparisons
+
+    friend constexpr bool operator==( compact_error_code const & e1, compact_error_code const & e2 ) noexcept
+    {
+        return e1.val_ == e2.val_ && e1.cat_ == e2.cat_;
+    }
+
+    friend constexpr bool operator!=( compact_error_code const & e1, compact_error_code const & e2 ) noexcept
+    {
+        return !( e1 == e2 );
+    }
+
+    friend bool operator==( compact_error_code const & e1, std::error_code const & e2 ) noexcept
+    {
+        return e1.value() == e2.value() && e1.category() == e2.category();
+    }
+
+    friend bool operator==( std::error_code const & e1, compact_error_code const & e2 ) noexcept
+    {
+        return e2 == e1;
+    }
+
+    friend bool operator!=( compact_error_code const & e1, std::error_code const & e2 ) noexcept
+    {
+        return !( e1 == e2 );
+    }
+
+    friend bool operator!=( std::error_code const & e1, compact_error_code const & e2 ) noexcept
+    {
+        return !( e1 == e2 );
+    }
+
+    friend constexpr bool operator<( compact_error_code const & e1, compact_error_code const & e2 ) noexcept
+    {
+        return e1.cat_ < e2.cat_ || ( e1.cat_ == e2.cat_ && e1.val_ < e2.val_ );
+    }
+
+    template<class Ch, class Tr> friend std::basic_ostream<Ch, Tr>& operator<<( std::basic_ostream<Ch, Tr>& os, compact_error_code const & e )
+    {
+        os << e.category().name() << ':' << e.value();
+        return os;
+    }
+};
+
+// throw_exception_from_error_code
+
+BOOST_NORETURN inline void throw_exception_from_error_code( compact_error_code const & e )
+{
+    boost::throw_exception( std::system_error( e ) );
+}
+
+} // namespace result
+} // namespace boost
+
+#endif // #ifndef BOOST_RESULT_COMPACT_ERROR_CODE_HPP_INCLUDED
@@ -0,0 +1,545 @@
+#ifndef BOOST_RESULT_CONTEXT_ERROR_CODE_HPP_INCLUDED
+#define BOOST_RESULT_CONTEXT_ERROR_CODE_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/compact_error_code.hpp>
+#include <boost/result/result.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <string>
+#include <new>
+#include <iosfwd>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+//
+// Error context chains
+//
+// context_error_code is a 16 byte error type, a compact_error_code and a
+// pointer to the most recently added error_context record. As an error
+// propagates, each layer can add a record (an operation name, a key and
+// an offset) describing what it was doing:
+//
+//   result<block> read_block( file& f, std::uint64_t offset );
+//
+//   result<config, context_error_code> load_config( char const* path )
+//   {
+//       file f = ...;
+//       auto r = with_context( read_block( f, 0 ), "read_block", path, 0 );
+//       ...
+//   }
+//
+// The records are taken from a per-thread bump arena and form a linked
+// list from the newest to the oldest. Adding a record takes constant time
+// and, once the arena has grown to its working size, doesn't allocate.
+//
+// The arena is reset at request boundaries, by an error_context_scope
+// or by error_context_arena::instance().reset(), which releases all
+// records created since at once. An error whose context is
+// still needed must not outlive the reset, and the errors of a thread
+// refer to the arena of that thread.
+//
+// context_error_code converts to std::error_code, and value() on a result
+// holding one throws std::system_error, its what() including the context.
+//
+
+#if !defined( BOOST_RESULT_ERROR_CONTEXT_BLOCK_SIZE )
+# define BOOST_RESULT_ERROR_CONTEXT_BLOCK_SIZE 4096
+#endif
+
+namespace boost
+{
+namespace result
+{
+
+// error_context
+//
+// A context record. `operation` is not copied and must have static
+// storage duration, as a string literal does; `key` is copied into the
+// arena.
+
+struct error_context
+{
+    error_context const* next;
+
+    char const* operation;
+    char const* key;
+    std::uint64_t offset;
+};
+
+// error_context_arena
+//
+// A per-thread bump allocator for context records. The first block is
+// part of the arena; further blocks are allocated as needed and kept
+// across resets. When an allocation fails, the record is dropped.
+
+class error_context_arena
+{
+private:
+
+    static constexpr std::size_t block_size = BOOST_RESULT_ERROR_CONTEXT_BLOCK_SIZE;
+
+    struct block
+    {
+        block* next;
+        std::size_t size;
+    };
+
+    static constexpr std::size_t alignment = alignof( error_context );
+    static constexpr std::size_t header_size = ( sizeof( block ) + alignment - 1 ) / alignment * alignment;
+
+    union
+    {
+        block first_;
+        unsigned char storage_[ block_size ];
+    };
+
+    block* current_;
+    unsigned char* pos_;
+    unsigned char* end_;
+
+    std::size_t used_;
+    std::size_t dropped_;
+
+private:
+
+    static unsigned char* block_begin( block* p ) noexcept
+    {
+        return reinterpret_cast<unsigned char*>( p ) + header_size;
+    }
+
+    static unsigned char* block_end( block* p ) noexcept
+    {
+        return reinterpret_cast<unsigned char*>( p ) + p->size;
+    }
+
+    void enter( block* p ) noexcept
+    {
+        current_ = p;
+        pos_ = block_begin( p );
+        end_ = block_end( p );
+    }
+
+    BOOST_NOINLINE void* allocate_slow( std::size_t n ) noexcept
+    {
+        // move to the next block that fits, or append a new one
+
+        for( ;; )
+        {
+            if( current_->next == 0 )
+            {
+                std::size_t m = header_size + n;
+                if( m < block_size ) m = block_size;
+
+                void* q = ::operator new( m, std::nothrow );
+
+                if( q == 0 )
+                {
+                    ++dropped_;
+                    return 0;
+                }
+
+                current_->next = ::new( q ) block{ 0, m };
+            }
+
+            enter( current_->next );
+
+            if( static_cast<std::size_t>( end_ - pos_ ) >= n )
+            {
+                void* p = pos_;
+                pos_ += n;
+                used_ += n;
+
+                return p;
+            }
+        }
+    }
+
+public:
+
+    error_context_arena() noexcept: first_{ 0, block_size }, used_( 0 ), dropped_( 0 )
+    {
+        enter( &first_ );
+    }
+
+    error_context_arena( error_context_arena const& ) = delete;
+    error_context_arena& operator=( error_context_arena const& ) = delete;
+
+    ~error_context_arena()
+    {
+        block* p = first_.next;
+
+        while( p )
+        {
+            block* q = p->next;
+            ::operator delete( p );
+            p = q;
+        }
+    }
+
+    // returns 0 when out of memory
+
+    void* allocate( std::size_t n ) noexcept
+    {
+        n = ( n + alignment - 1 ) / alignment * alignment;
+
+        if( static_cast<std::size_t>( end_ - pos_ ) >= n )
+        {
+            void* p = pos_;
+            pos_ += n;
+            used_ += n;
+
+            return p;
+        }
+
+        return allocate_slow( n );
+    }
+
+    // adds a record in front of `next`; returns `next` when out of memory.
+    // Kept out of line, so that the success path of the callers doesn't
+    // pay for it
+
+    BOOST_NOINLINE BOOST_RESULT_COLD error_context const* push( error_context const* next, char const* operation, char const* key, std::size_t key_size, std::uint64_t offset ) noexcept
+    {
+        void* p = allocate( sizeof( error_context ) + key_size + 1 );
+
+        if( p == 0 ) return next;
+
+        char* k = static_cast<char*>( p ) + sizeof( error_context );
+
+        if( key_size != 0 ) std::memcpy( k, key, key_size );
+        k[ key_size ] = 0;
+
+        return ::new( p ) error_context{ next, operation, k, offset };
+    }
+
+    // releases all records, keeping the blocks
+
+    void reset() noexcept
+    {
+        enter( &first_ );
+        used_ = 0;
+    }
+
+    // a position in the arena; rewind( m ) releases the records added
+    // after mark() returned m
+
+    struct position
+    {
+        block* current;
+        unsigned char* pos;
+        std::size_t used;
+    };
+
+    position mark() const noexcept
+    {
+        return { current_, pos_, used_ };
+    }
+
+    void rewind( position m ) noexcept
+    {
+        current_ = m.current;
+        pos_ = m.pos;
+        end_ = block_end( m.current );
+        used_ = m.used;
+    }
+
+    // the number of bytes taken by the records in use, including their
+    // keys and alignment padding, but not the block headers or the space
+    // left unused at the end of a block
+
+    std::size_t size() const noexcept
+    {
+        return used_;
+    }
+
+    // the number of records dropped because of allocation failures
+
+    std::size_t dropped() const noexcept
+    {
+        return dropped_;
+    }
+
+    static error_context_arena& instance() noexcept
+    {
+        static thread_local error_context_arena arena;
+        return arena;
+    }
+};
+
+// error_context_scope
+//
+// Releases the records added to the arena of the current thread during
+// its lifetime; scopes can nest.
+
+class error_context_scope
+{
+private:
+
+    error_context_arena::position m_;
+
+public:
+
+    error_context_scope() noexcept: m_( error_context_arena::instance().mark() )
+    {
+    }
+
+    error_context_scope( error_context_scope const& ) = delete;
+    error_context_scope& operator=( error_context_scope const& ) = delete;
+
+    ~error_context_scope()
+    {
+        error_context_arena::instance().rewind( m_ );
+    }
+};
+
+// context_error_code
+
+class context_error_code
+{
+private:
+
+    compact_error_code code_;
+    error_context const* context_;
+
+public:
+
+    // constructors
+
+    constexpr context_error_code() noexcept: code_(), context_( 0 )
+    {
+    }
+
+    context_error_code( int val, std::error_category const & cat ): code_( val, cat ), context_( 0 )
+    {
+    }
+
+    context_error_code( compact_error_code const & code ) noexcept: code_( code ), context_( 0 )
+    {
+    }
+
+    context_error_code( std::error_code const & ec ): code_( ec ), context_( 0 )
+    {
+    }
+
+    template<class ErrorCodeEnum, class En = typename std::enable_if<
+        std::is_error_code_enum<ErrorCodeEnum>::value
+        >::type>
+    context_error_code( ErrorCodeEnum e ): code_( e ), context_( 0 )
+    {
+    }
+
+    // context
+
+    // a null key is treated as ""
+
+    context_error_code& add_context( char const* operation, char const* key = "", std::uint64_t offset = 0 ) noexcept
+    {
+        context_ = error_context_arena::instance().push( context_, operation, key, key? std::strlen( key ): 0, offset );
+        return *this;
+    }
+
+    context_error_code& add_context( char const* operation, std::string const& key, std::uint64_t offset = 0 ) noexcept
+    {
+        context_ = error_context_arena::instance().push( context_, operation, key.data(), key.size(), offset );
+        return *this;
+    }
+
+    // the most recently added record, or 0
+
+    error_context const* context() const noexcept
+    {
+        return context_;
+    }
+
+    // modifiers
+
+    void assign( int val, std::error_category const & cat )
+    {
+        *this = context_error_code( val, cat );
+    }
+
+    void clear() noexcept
+    {
+        code_.clear();
+        context_ = 0;
+    }
+
+    // observers
+
+    compact_error_code code() const noexcept
+    {
+        return code_;
+    }
+
+    int value() const noexcept
+    {
+        return code_.value();
+    }
+
+    std::error_category const & category() const noexcept
+    {
+        return code_.category();
+    }
+
+    std::string message() const
+    {
+        return code_.message();
+    }
+
+    // the context, from the newest record to the oldest
+
+    std::string context_message() const
+    {
+        std::string r;
+
+        for( error_context const* p = context_; p; p = p->next )
+        {
+            if( p != context_ ) r += ", ";
+
+            r += "in ";
+            r += p->operation;
+
+            if( *p->key )
+            {
+                r += " '";
+                r += p->key;
+                r += "'";
+            }
+
+            if( p->offset )
+            {
+                r += " at ";
+                r += std::to_string( p->offset );
+            }
+        }
+
+        return r;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return static_cast<bool>( code_ );
+    }
+
+    // conversions
+
+    operator std::error_code() const noexcept
+    {
+        return code_;
+    }
+
+    // comparisons; the context is not compared
+
+    friend bool operator==( context_error_code const & e1, context_error_code const & e2 ) noexcept
+    {
+        return e1.code_ == e2.code_;
+    }
+
+    friend bool operator!=( context_error_code const & e1, context_error_code const & e2 ) noexcept
+    {
+        return !( e1 == e2 );
+    }
+
+    friend bool operator==( context_error_code const & e1, std::error_code const & e2 ) noexcept
+    {
+        return e1.code_ == e2;
+    }
+
+    friend bool operator==( std::error_code const & e1, context_error_code const & e2 ) noexcept
+    {
+        return e2 == e1;
+    }
+
+    friend bool operator!=( context_error_code const & e1, std::error_code const & e2 ) noexcept
+    {
+        return !( e1 == e2 );
+    }
+
+    friend bool operator!=( std::error_code const & e1, context_error_code const & e2 ) noexcept
+    {
+        return !( e1 == e2 );
+    }
+
+    template<class Ch, class Tr> friend std::basic_ostream<Ch, Tr>& operator<<( std::basic_ostream<Ch, Tr>& os, context_error_code const & e )
+    {
+        os << e.code_;
+
+        if( e.context_ )
+        {
+            os << " (" << e.context_message().c_str() << ')';
+        }
+
+        return os;
+    }
+};
+
+// throw_exception_from_error_code
+
+BOOST_NORETURN inline void throw_exception_from_error_code( context_error_code const & e )
+{
+    if( e.context() )
+    {
+        boost::throw_exception( std::system_error( e, e.context_message() ) );
+    }
+    else
+    {
+        boost::throw_exception( std::system_error( e ) );
+    }
+}
+
+namespace detail
+{
+
+template<class T, class R> result<T, context_error_code> with_context_value( R&& r, std::false_type )
+{
+    return result<T, context_error_code>( in_place_value, *std::forward<R>( r ) );
+}
+
+template<class T, class R> result<T, context_error_code> with_context_value( R&&, std::true_type )
+{
+    return result<T, context_error_code>( in_place_value );
+}
+
+template<class T, class R, class... A> BOOST_NOINLINE BOOST_RESULT_COLD result<T, context_error_code> with_context_error( R&& r, char const* operation, A&&... a )
+{
+    context_error_code e( std::forward<R>( r ).error() );
+    e.add_context( operation, std::forward<A>( a )... );
+
+    return result<T, context_error_code>( in_place_error, e );
+}
+
+} // namespace detail
+
+// with_context( r, operation, key, offset )
+//
+// Returns r, converted to result<T, context_error_code>, with a context
+// record added to its error, if any.
+
+template<class R, class... A,
+    class T = typename detail::is_result< detail::remove_cvref<R> >::value_type,
+    class E = typename detail::is_result< detail::remove_cvref<R> >::error_type,
+    class En = typename std::enable_if<
+        std::is_constructible<context_error_code, E>::value
+        >::type>
+result<T, context_error_code> with_context( R&& r, char const* operation, A&&... a )
+{
+    if( BOOST_LIKELY( r.has_value() ) )
+    {
+        return detail::with_context_value<T>( std::forward<R>( r ), std::is_void<T>() );
+    }
+
+    return detail::with_context_error<T>( std::forward<R>( r ), operation, std::forward<A>( a )... );
+}
+
+} // namespace result
+} // namespace boost
+
+#endif // #ifndef BOOST_RESULT_CONTEXT_ERROR_CODE_HPP_INCLUDED
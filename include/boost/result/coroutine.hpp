@@ -0,0 +1,325 @@
+#ifndef BOOST_RESULT_COROUTINE_HPP_INCLUDED
+#define BOOST_RESULT_COROUTINE_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result.hpp>
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && defined(__has_include)
+# if __has_include(<coroutine>)
+#  include <coroutine>
+#  define BOOST_RESULT_HAS_COROUTINES
+# endif
+#endif
+
+// The object returned by get_return_object() receives the result of the
+// coroutine, and must be converted to result<T, E> only after the body has
+// run. The standard leaves that unspecified (CWG2563). GCC and MSVC convert
+// on return; Clang 17 does too when, as here, the type of the return object
+// differs from the return type, but earlier versions have converted it
+// immediately, so coroutines are disabled there. test/result_coroutine.cpp
+// checks the order.
+
+#if defined(BOOST_RESULT_HAS_COROUTINES) && defined(__clang__) && __clang_major__ < 17
+# undef BOOST_RESULT_HAS_COROUTINES
+#endif
+
+//
+// Coroutines returning result
+//
+// When BOOST_RESULT_HAS_COROUTINES is defined, a function returning
+// result<T, E> can be a coroutine. In it, `co_await r` on a result r
+// evaluates to the value of r, or, when r holds an error, returns that
+// error from the coroutine, converted as by BOOST_RESULT_TRY:
+//
+//   result<int> f( std::string const& s )
+//   {
+//       int x = co_await parse_int( s );
+//       co_return x + 1;
+//   }
+//
+// `co_return e` accepts anything a result<T, E> can be constructed from;
+// a result<void, E> coroutine ends with `co_return {};`. Only results can
+// be awaited, and the coroutine always runs to completion before
+// returning to its caller. An exception escaping from its body is
+// rethrown to the caller.
+//
+// The coroutine frame is released before the function returns, and never
+// escapes it, which allows Clang to elide its allocation. Compilers that
+// don't do that take it from a small per-thread cache of recently freed
+// frames, so that after the first calls no heap allocation takes place.
+//
+
+#if defined(BOOST_RESULT_HAS_COROUTINES)
+
+#include <type_traits>
+#include <utility>
+#include <new>
+#include <cstddef>
+
+namespace boost
+{
+namespace result
+{
+
+namespace detail
+{
+
+// per-thread cache of coroutine frames, by size in 64 byte steps
+
+class coroutine_frame_cache
+{
+private:
+
+    static constexpr std::size_t granularity = 64;
+    static constexpr std::size_t classes = 16;
+    static constexpr unsigned depth = 8;
+
+    struct node
+    {
+        node* next;
+    };
+
+    node* head_[ classes ] = {};
+    unsigned count_[ classes ] = {};
+
+public:
+
+    coroutine_frame_cache() = default;
+
+    coroutine_frame_cache( coroutine_frame_cache const& ) = delete;
+    coroutine_frame_cache& operator=( coroutine_frame_cache const& ) = delete;
+
+    ~coroutine_frame_cache()
+    {
+        for( std::size_t c = 0; c < classes; ++c )
+        {
+            while( node* p = head_[ c ] )
+            {
+                head_[ c ] = p->next;
+                ::operator delete( p );
+            }
+        }
+    }
+
+    void* allocate( std::size_t n )
+    {
+        std::size_t c = ( n - 1 ) / granularity;
+
+        if( c >= classes )
+        {
+            return ::operator new( n );
+        }
+
+        if( node* p = head_[ c ] )
+        {
+            head_[ c ] = p->next;
+            --count_[ c ];
+
+            return p;
+        }
+
+        return ::operator new( ( c + 1 ) * granularity );
+    }
+
+    void deallocate( void* p, std::size_t n ) noexcept
+    {
+        std::size_t c = ( n - 1 ) / granularity;
+
+        if( c >= classes || count_[ c ] >= depth )
+        {
+            ::operator delete( p );
+            return;
+        }
+
+        node* q = ::new( p ) node;
+
+        q->next = head_[ c ];
+        head_[ c ] = q;
+        ++count_[ c ];
+    }
+
+    static coroutine_frame_cache& instance() noexcept
+    {
+        static thread_local coroutine_frame_cache cache;
+        return cache;
+    }
+};
+
+template<class T, class E> class coroutine_promise;
+
+// the object returned by get_return_object(); the result is written
+// into it by the coroutine, and converted to result<T, E> on return
+
+template<class T, class E> class coroutine_return_object
+{
+private:
+
+    union
+    {
+        result<T, E> r_;
+    };
+
+    bool engaged_;
+
+public:
+
+    explicit coroutine_return_object( coroutine_promise<T, E>& p ) noexcept: engaged_( false )
+    {
+        p.set_return_object( this );
+    }
+
+    coroutine_return_object( coroutine_return_object const& ) = delete;
+    coroutine_return_object& operator=( coroutine_return_object const& ) = delete;
+
+    ~coroutine_return_object()
+    {
+        if( engaged_ ) r_.~result();
+    }
+
+    template<class... A> void emplace( A&&... a )
+    {
+        BOOST_ASSERT( !engaged_ );
+
+        ::new( static_cast<void*>( &r_ ) ) result<T, E>( std::forward<A>( a )... );
+        engaged_ = true;
+    }
+
+    operator result<T, E>()
+    {
+        // fails when the compiler converts the return object before the
+        // body has run; see the top of the file
+        BOOST_ASSERT( engaged_ );
+        return std::move( r_ );
+    }
+};
+
+// the awaiter for co_await r; R is the type of r, a reference when r is
+// an lvalue. The value of an rvalue is returned by value, so that it
+// outlives the result
+
+template<class R> class coroutine_awaiter
+{
+private:
+
+    R&& r_;
+
+    using value_type = typename std::conditional<std::is_reference<R>::value, decltype( *std::declval<R&&>() ), result_value_type<R>>::type;
+
+public:
+
+    explicit coroutine_awaiter( R&& r ) noexcept: r_( std::forward<R>( r ) )
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return r_.has_value();
+    }
+
+    template<class P> void await_suspend( std::coroutine_handle<P> h )
+    {
+        h.promise().propagate( std::forward<R>( r_ ) );
+
+        // the coroutine doesn't resume; destroying it returns control to
+        // the caller, which picks up the error from the return object
+
+        h.destroy();
+    }
+
+    value_type await_resume()
+    {
+        return static_cast<value_type>( *std::forward<R>( r_ ) );
+    }
+};
+
+template<class T, class E> class coroutine_promise
+{
+private:
+
+    coroutine_return_object<T, E>* ro_ = nullptr;
+
+public:
+
+    static void* operator new( std::size_t n )
+    {
+        return coroutine_frame_cache::instance().allocate( n );
+    }
+
+    static void operator delete( void* p, std::size_t n ) noexcept
+    {
+        coroutine_frame_cache::instance().deallocate( p, n );
+    }
+
+    void set_return_object( coroutine_return_object<T, E>* p ) noexcept
+    {
+        ro_ = p;
+    }
+
+    coroutine_return_object<T, E> get_return_object() noexcept
+    {
+        return coroutine_return_object<T, E>( *this );
+    }
+
+    std::suspend_never initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    std::suspend_never final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    // the exception leaves the coroutine before it returns for the first
+    // time, which destroys the frame and propagates it to the caller
+
+    void unhandled_exception()
+    {
+        throw;
+    }
+
+    template<class U, class En = typename std::enable_if<
+        std::is_constructible<result<T, E>, U>::value
+        >::type>
+    void return_value( U&& u )
+    {
+        ro_->emplace( std::forward<U>( u ) );
+    }
+
+    void return_value( result<T, E> r )
+    {
+        ro_->emplace( std::move( r ) );
+    }
+
+    template<class R, class En = typename std::enable_if<
+        is_result< remove_cvref<R> >::value
+        >::type>
+    coroutine_awaiter<R> await_transform( R&& r ) noexcept
+    {
+        return coroutine_awaiter<R>( std::forward<R>( r ) );
+    }
+
+    template<class R> void propagate( R&& r )
+    {
+        ro_->emplace( propagate_error( std::forward<R>( r ) ) );
+    }
+};
+
+} // namespace detail
+
+} // namespace result
+} // namespace boost
+
+template<class T, class E, class... A> struct std::coroutine_traits< boost::result::result<T, E>, A... >
+{
+    using promise_type = boost::result::detail::coroutine_promise<T, E>;
+};
+
+#endif // #if defined(BOOST_RESULT_HAS_COROUTINES)
+
+#endif // #ifndef BOOST_RESULT_COROUTINE_HPP_INCLUDED
@@ -0,0 +1,163 @@
+#ifndef BOOST_RESULT_DETAIL_PROBES_HPP_INCLUDED
+#define BOOST_RESULT_DETAIL_PROBES_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/config.hpp>
+#include <system_error>
+#include <type_traits>
+
+//
+// USDT probes
+//
+// When BOOST_RESULT_ENABLE_PROBES is defined, result has two static probes
+// of the provider boost_result, for bpftrace, perf or SystemTap:
+//
+//   error( char const* category, int value )
+//
+//     fires when a result is constructed in the error state, or is assigned
+//     an error (but not when an error is propagated)
+//
+//   throw( char const* category, int value )
+//
+//     fires when value() is about to throw the error
+//
+// for the error types that have category() and value() members, as
+// std::error_code does, and for the error code enums. The first argument is
+// category().name().
+//
+// On x86-64 ELF, the .note.stapsdt records are emitted directly, with a
+// semaphore per probe. Otherwise, the probes are defined with STAP_PROBE2
+// from <sys/sdt.h> when available, with semaphores only when
+// _SDT_HAS_SEMAPHORES is defined. On other platforms, the probes are not
+// available and BOOST_RESULT_HAS_PROBES is not defined.
+//
+// A tracer increments the semaphore of a probe when it attaches to it. The
+// probe is a single NOP, and its arguments are computed, on the out of line
+// error path, only when the semaphore is nonzero; without a tracer, the
+// cost of a probe is a test of the semaphore. The error constructors of
+// result stay constexpr.
+//
+// Example:
+//
+//   bpftrace -e 'usdt:./server:boost_result:error { @[str(arg0), arg1] = count(); }'
+//
+
+#if defined( __GNUC__ ) && defined( __x86_64__ ) && defined( __ELF__ )
+
+// The layout of the note matches that of <sys/sdt.h> version 3: the address
+// of the NOP, the address of the .stapsdt.base section, for prelink, the
+// address of the semaphore, and the provider, name and argument strings.
+
+# define BOOST_RESULT_HAS_PROBES
+# define BOOST_RESULT_HAS_PROBE_SEMAPHORES
+
+# define BOOST_RESULT_PROBE2( name, a1, a2 ) \
+    __asm__ __volatile__ ( \
+        "990: nop\n" \
+        ".pushsection .note.stapsdt,\"?\",\"note\"\n" \
+        ".balign 4\n" \
+        ".4byte 992f-991f, 994f-993f, 3\n" \
+        "991: .asciz \"stapsdt\"\n" \
+        "992: .balign 4\n" \
+        "993: .8byte 990b\n" \
+        ".8byte _.stapsdt.base\n" \
+        ".8byte boost_result_" #name "_semaphore\n" \
+        ".asciz \"boost_result\"\n" \
+        ".asciz \"" #name "\"\n" \
+        ".asciz \"8@%0 -4@%1\"\n" \
+        "994: .balign 4\n" \
+        ".popsection\n" \
+        ".ifndef _.stapsdt.base\n" \
+        ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n" \
+        ".weak _.stapsdt.base\n" \
+        ".hidden _.stapsdt.base\n" \
+        "_.stapsdt.base: .space 1\n" \
+        ".size _.stapsdt.base, 1\n" \
+        ".popsection\n" \
+        ".endif\n" \
+        :: "nor"( static_cast<char const*>( a1 ) ), "nor"( static_cast<int>( a2 ) ) )
+
+#elif defined( __has_include )
+# if __has_include(<sys/sdt.h>)
+#  include <sys/sdt.h>
+#  define BOOST_RESULT_HAS_PROBES
+#  if defined( _SDT_HAS_SEMAPHORES )
+#   define BOOST_RESULT_HAS_PROBE_SEMAPHORES
+#  endif
+#  define BOOST_RESULT_PROBE2( name, a1, a2 ) STAP_PROBE2( boost_result, name, a1, a2 )
+# endif
+#endif
+
+#if defined( BOOST_RESULT_HAS_PROBE_SEMAPHORES )
+
+// The semaphores are named, and placed in the .probes section, as
+// <sys/sdt.h> expects; one per executable or shared library
+
+extern "C"
+{
+
+__attribute__(( weak, visibility( "hidden" ), section( ".probes" ) )) volatile unsigned short boost_result_error_semaphore = 0;
+__attribute__(( weak, visibility( "hidden" ), section( ".probes" ) )) volatile unsigned short boost_result_throw_semaphore = 0;
+
+} // extern "C"
+
+# define BOOST_RESULT_PROBE_ENABLED( name ) BOOST_UNLIKELY( ::boost_result_ ## name ## _semaphore != 0 )
+
+#else
+
+# define BOOST_RESULT_PROBE_ENABLED( name ) true
+
+#endif
+
+#if defined( BOOST_RESULT_HAS_PROBES )
+
+namespace boost
+{
+namespace result
+{
+namespace detail
+{
+
+struct probe_error_tag {};
+struct probe_throw_tag {};
+
+inline void fire_probe( probe_error_tag, std::error_category const& cat, int value ) noexcept
+{
+    BOOST_RESULT_PROBE2( error, cat.name(), value );
+}
+
+inline void fire_probe( probe_throw_tag, std::error_category const& cat, int value ) noexcept
+{
+    BOOST_RESULT_PROBE2( throw, cat.name(), value );
+}
+
+template<class Tag, class E> void probe_error_enum( Tag tag, E const& e, std::true_type ) noexcept
+{
+    std::error_code ec = make_error_code( e );
+    detail::fire_probe( tag, ec.category(), ec.value() );
+}
+
+template<class Tag, class E> void probe_error_enum( Tag, E const&, std::false_type ) noexcept
+{
+}
+
+template<class Tag, class E> auto probe_error_impl( Tag tag, E const& e, int ) noexcept -> decltype( void( e.category() ), void( e.value() ) )
+{
+    detail::fire_probe( tag, e.category(), e.value() );
+}
+
+template<class Tag, class E> void probe_error_impl( Tag tag, E const& e, long ) noexcept
+{
+    detail::probe_error_enum( tag, e, std::is_error_code_enum<E>() );
+}
+
+} // namespace detail
+} // namespace result
+} // namespace boost
+
+#endif // #if defined( BOOST_RESULT_HAS_PROBES )
+
+#endif // #ifndef BOOST_RESULT_DETAIL_PROBES_HPP_INCLUDED
@@ -0,0 +1,710 @@
+#ifndef BOOST_RESULT_DETAIL_RESULT_STORAGE_HPP_INCLUDED
+#define BOOST_RESULT_DETAIL_RESULT_STORAGE_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/niche_traits.hpp>
+#include <boost/result/is_trivially_relocatable.hpp>
+#include <boost/variant2/variant.hpp>
+#include <boost/mp11/algorithm.hpp>
+#include <boost/mp11/utility.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/config.hpp>
+#include <type_traits>
+#include <utility>
+#include <memory>
+#include <new>
+#include <cstring>
+#include <cstddef>
+
+//
+
+namespace boost
+{
+namespace result
+{
+namespace detail
+{
+
+// trivially_*
+
+#if defined( BOOST_LIBSTDCXX_VERSION ) && BOOST_LIBSTDCXX_VERSION < 50000
+
+template<class T> struct is_trivially_copy_constructible: mp11::mp_bool<std::is_copy_constructible<T>::value && std::has_trivial_copy_constructor<T>::value>
+{
+};
+
+template<class T> struct is_trivially_copy_assignable: mp11::mp_bool<std::is_copy_assignable<T>::value && std::has_trivial_copy_assign<T>::value>
+{
+};
+
+template<class T> struct is_trivially_move_constructible: mp11::mp_bool<std::is_move_constructible<T>::value && std::is_trivial<T>::value>
+{
+};
+
+template<class T> struct is_trivially_move_assignable: mp11::mp_bool<std::is_move_assignable<T>::value && std::is_trivial<T>::value>
+{
+};
+
+#else
+
+using std::is_trivially_copy_constructible;
+using std::is_trivially_copy_assignable;
+using std::is_trivially_move_constructible;
+using std::is_trivially_move_assignable;
+
+#endif
+
+// is_nothrow_swappable
+
+namespace swap_ns
+{
+
+using std::swap;
+
+template<class T> struct is_nothrow_swappable: mp11::mp_bool<noexcept( swap( std::declval<T&>(), std::declval<T&>() ) )>
+{
+};
+
+} // namespace swap_ns
+
+using swap_ns::is_nothrow_swappable;
+
+// niche_fits<X, O>
+//
+// X declares a niche that leaves room in its storage for an O
+
+template<class X, class O, bool = niche_traits<X>::value> struct niche_fits: std::false_type
+{
+};
+
+template<class X, class O> struct niche_fits<X, O, true>: mp11::mp_bool<
+    std::is_empty<O>::value ||
+    ( sizeof( O ) <= niche_traits<X>::offset && alignof( O ) <= alignof( X ) )
+>
+{
+};
+
+// is_assignable_from<U, A...>: a single argument that U is assignable from
+
+template<class U, class... A> struct is_assignable_from: std::false_type
+{
+};
+
+template<class U, class A> struct is_assignable_from<U, A>: std::is_assignable<U&, A>
+{
+};
+
+// result_union
+
+struct no_init_t
+{
+};
+
+template<class T, class E, bool = std::is_trivially_destructible<T>::value && std::is_trivially_destructible<E>::value> union result_union
+{
+    T t_;
+    E e_;
+
+    explicit result_union( no_init_t ) noexcept
+    {
+    }
+
+    template<class... A> constexpr explicit result_union( variant2::in_place_index_t<0>, A&&... a ): t_( std::forward<A>(a)... )
+    {
+    }
+
+    template<class... A> constexpr explicit result_union( variant2::in_place_index_t<1>, A&&... a ): e_( std::forward<A>(a)... )
+    {
+    }
+};
+
+template<class T, class E> union result_union<T, E, false>
+{
+    T t_;
+    E e_;
+
+    explicit result_union( no_init_t ) noexcept
+    {
+    }
+
+    template<class... A> constexpr explicit result_union( variant2::in_place_index_t<0>, A&&... a ): t_( std::forward<A>(a)... )
+    {
+    }
+
+    template<class... A> constexpr explicit result_union( variant2::in_place_index_t<1>, A&&... a ): e_( std::forward<A>(a)... )
+    {
+    }
+
+    ~result_union()
+    {
+    }
+};
+
+// result_storage_data
+//
+// The two alternatives share a single union. N is the index of the
+// alternative whose spare representations record which one is active,
+// or result_index_byte when a separate index is kept instead.
+
+constexpr std::size_t result_index_byte = 2;
+
+template<class T, class E, std::size_t N> struct result_storage_data
+{
+    using X = mp11::mp_at_c<mp11::mp_list<T, E>, N>;
+
+    result_union<T, E> u_;
+
+    explicit result_storage_data( no_init_t ) noexcept: u_( no_init_t() )
+    {
+    }
+
+    template<class... A> constexpr explicit result_storage_data( variant2::in_place_index_t<N>, A&&... a ): u_( variant2::in_place_index_t<N>(), std::forward<A>(a)... )
+    {
+    }
+
+    template<class... A> explicit result_storage_data( variant2::in_place_index_t<1 - N>, A&&... a ): u_( variant2::in_place_index_t<1 - N>(), std::forward<A>(a)... )
+    {
+        niche_traits<X>::set_spare( &u_ );
+    }
+
+    std::size_t index() const noexcept
+    {
+        return niche_traits<X>::is_spare( &u_ )? 1 - N: N;
+    }
+
+    void set_index( std::size_t i ) noexcept
+    {
+        if( i != N )
+        {
+            niche_traits<X>::set_spare( &u_ );
+        }
+    }
+};
+
+template<class T, class E> struct result_storage_data<T, E, result_index_byte>
+{
+    result_union<T, E> u_;
+    unsigned char ix_;
+
+    explicit result_storage_data( no_init_t ) noexcept: u_( no_init_t() ), ix_( 0 )
+    {
+    }
+
+    template<std::size_t I, class... A> constexpr explicit result_storage_data( variant2::in_place_index_t<I>, A&&... a ): u_( variant2::in_place_index_t<I>(), std::forward<A>(a)... ), ix_( I )
+    {
+    }
+
+    constexpr std::size_t index() const noexcept
+    {
+        return ix_;
+    }
+
+    void set_index( std::size_t i ) noexcept
+    {
+        ix_ = static_cast<unsigned char>( i );
+    }
+};
+
+// result_storage_core
+//
+// Raw construction, destruction and replacement of the active alternative
+
+template<class T, class E, std::size_t N> struct result_storage_core: result_storage_data<T, E, N>
+{
+    using result_storage_data<T, E, N>::result_storage_data;
+
+    constexpr T const* get( mp11::mp_size_t<0> ) const noexcept
+    {
+        return &this->u_.t_;
+    }
+
+    BOOST_CXX14_CONSTEXPR T* get( mp11::mp_size_t<0> ) noexcept
+    {
+        return &this->u_.t_;
+    }
+
+    constexpr E const* get( mp11::mp_size_t<1> ) const noexcept
+    {
+        return &this->u_.e_;
+    }
+
+    BOOST_CXX14_CONSTEXPR E* get( mp11::mp_size_t<1> ) noexcept
+    {
+        return &this->u_.e_;
+    }
+
+    // requires: no alternative is active
+    template<std::size_t I, class... A> void construct( A&&... a )
+    {
+        using U = mp11::mp_at_c<mp11::mp_list<T, E>, I>;
+
+        ::new( static_cast<void*>( get( mp11::mp_size_t<I>() ) ) ) U( std::forward<A>(a)... );
+        this->set_index( I );
+    }
+
+    template<std::size_t I> void destroy_( mp11::mp_size_t<I> ) noexcept
+    {
+        using U = mp11::mp_at_c<mp11::mp_list<T, E>, I>;
+        get( mp11::mp_size_t<I>() )->~U();
+    }
+
+    void destroy() noexcept
+    {
+        if( this->index() == 0 )
+        {
+            destroy_( mp11::mp_size_t<0>() );
+        }
+        else
+        {
+            destroy_( mp11::mp_size_t<1>() );
+        }
+    }
+
+    // puts back an alternative moved aside by emplace_from_backup; if
+    // this throws, there is no alternative left to hold, so terminate
+    template<std::size_t I, class U> void restore( U&& u ) noexcept
+    {
+        construct<I>( std::move( u ) );
+    }
+
+    template<std::size_t J, class J2, class... A> void emplace_from_backup( J2, A&&... a )
+    {
+        using U = mp11::mp_at_c<mp11::mp_list<T, E>, J2::value>;
+
+        U backup( std::move( *get( J2() ) ) );
+        destroy_( J2() );
+
+        BOOST_TRY
+        {
+            construct<J>( std::forward<A>(a)... );
+        }
+        BOOST_CATCH(...)
+        {
+            restore<J2::value>( std::move( backup ) );
+            BOOST_RETHROW
+        }
+        BOOST_CATCH_END
+    }
+
+    // nothrow construction
+    template<std::size_t J, class... A> void emplace_( mp11::mp_true, mp11::mp_true, A&&... a )
+    {
+        this->destroy();
+        construct<J>( std::forward<A>(a)... );
+    }
+
+    // construct a temporary, then nothrow move it in place
+    template<std::size_t J, class... A> void emplace_( mp11::mp_false, mp11::mp_true, A&&... a )
+    {
+        using U = mp11::mp_at_c<mp11::mp_list<T, E>, J>;
+
+        U tmp( std::forward<A>(a)... );
+
+        this->destroy();
+        construct<J>( std::move( tmp ) );
+    }
+
+    // move the current alternative aside, restore it on failure
+    template<std::size_t J, class... A> void emplace_( mp11::mp_false, mp11::mp_false, A&&... a )
+    {
+        if( this->index() == 0 )
+        {
+            emplace_from_backup<J>( mp11::mp_size_t<0>(), std::forward<A>(a)... );
+        }
+        else
+        {
+            emplace_from_backup<J>( mp11::mp_size_t<1>(), std::forward<A>(a)... );
+        }
+    }
+
+    // Replaces the active alternative with a J constructed from a...
+    //
+    // Strong guarantee when the new alternative is nothrow constructible
+    // from a... or nothrow move constructible, or when the old alternative
+    // is nothrow move constructible. If neither alternative can be moved
+    // without throwing and restoring the old one throws, std::terminate
+    // is called.
+    template<std::size_t J, class... A> void emplace( A&&... a )
+    {
+        using U = mp11::mp_at_c<mp11::mp_list<T, E>, J>;
+
+        emplace_<J>(
+            mp11::mp_bool<std::is_nothrow_constructible<U, A&&...>::value>(),
+            mp11::mp_bool<std::is_nothrow_constructible<U, A&&...>::value || std::is_nothrow_move_constructible<U>::value>(),
+            std::forward<A>(a)... );
+    }
+
+    // assign into the active alternative
+    template<std::size_t J, class A> void assign_( mp11::mp_true, A&& a )
+    {
+        if( this->index() == J )
+        {
+            *get( mp11::mp_size_t<J>() ) = std::forward<A>(a);
+        }
+        else
+        {
+            emplace<J>( std::forward<A>(a) );
+        }
+    }
+
+    template<std::size_t J, class... A> void assign_( mp11::mp_false, A&&... a )
+    {
+        emplace<J>( std::forward<A>(a)... );
+    }
+
+    // Makes J the active alternative, with the value a... When J is
+    // already active and is assignable from a single argument, assigns
+    // to it, keeping the resources it owns; replaces it otherwise.
+    template<std::size_t J, class... A> void assign( A&&... a )
+    {
+        using U = mp11::mp_at_c<mp11::mp_list<T, E>, J>;
+
+        assign_<J>( is_assignable_from<U, A&&...>(), std::forward<A>(a)... );
+    }
+};
+
+// result_storage_cc
+//
+// copy and move construction
+
+template<class T, class E, std::size_t N, bool =
+    is_trivially_copy_constructible<T>::value && is_trivially_copy_constructible<E>::value &&
+    is_trivially_move_constructible<T>::value && is_trivially_move_constructible<E>::value
+> struct result_storage_cc: result_storage_core<T, E, N>
+{
+    using result_storage_core<T, E, N>::result_storage_core;
+};
+
+template<class T, class E, std::size_t N> struct result_storage_cc<T, E, N, false>: result_storage_core<T, E, N>
+{
+    using result_storage_core<T, E, N>::result_storage_core;
+
+    result_storage_cc( result_storage_cc const& r ): result_storage_core<T, E, N>( no_init_t() )
+    {
+        if( r.index() == 0 )
+        {
+            this->template construct<0>( *r.get( mp11::mp_size_t<0>() ) );
+        }
+        else
+        {
+            this->template construct<1>( *r.get( mp11::mp_size_t<1>() ) );
+        }
+    }
+
+    result_storage_cc( result_storage_cc&& r )
+        noexcept( std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_constructible<E>::value )
+        : result_storage_core<T, E, N>( no_init_t() )
+    {
+        if( r.index() == 0 )
+        {
+            this->template construct<0>( std::move( *r.get( mp11::mp_size_t<0>() ) ) );
+        }
+        else
+        {
+            this->template construct<1>( std::move( *r.get( mp11::mp_size_t<1>() ) ) );
+        }
+    }
+
+    result_storage_cc& operator=( result_storage_cc const& ) = default;
+    result_storage_cc& operator=( result_storage_cc&& ) = default;
+};
+
+// result_storage_dt
+//
+// destruction
+
+template<class T, class E, std::size_t N, bool = std::is_trivially_destructible<T>::value && std::is_trivially_destructible<E>::value> struct result_storage_dt: result_storage_cc<T, E, N>
+{
+    using result_storage_cc<T, E, N>::result_storage_cc;
+};
+
+template<class T, class E, std::size_t N> struct result_storage_dt<T, E, N, false>: result_storage_cc<T, E, N>
+{
+    using result_storage_cc<T, E, N>::result_storage_cc;
+
+    result_storage_dt( result_storage_dt const& ) = default;
+    result_storage_dt( result_storage_dt&& ) = default;
+
+    result_storage_dt& operator=( result_storage_dt const& ) = default;
+    result_storage_dt& operator=( result_storage_dt&& ) = default;
+
+    ~result_storage_dt()
+    {
+        this->destroy();
+    }
+};
+
+// result_storage_as
+//
+// copy and move assignment
+
+template<class T, class E, std::size_t N, bool =
+    std::is_trivially_destructible<T>::value && std::is_trivially_destructible<E>::value &&
+    is_trivially_copy_constructible<T>::value && is_trivially_copy_constructible<E>::value &&
+    is_trivially_move_constructible<T>::value && is_trivially_move_constructible<E>::value &&
+    is_trivially_copy_assignable<T>::value && is_trivially_copy_assignable<E>::value &&
+    is_trivially_move_assignable<T>::value && is_trivially_move_assignable<E>::value
+> struct result_storage_as: result_storage_dt<T, E, N>
+{
+    using result_storage_dt<T, E, N>::result_storage_dt;
+};
+
+template<class T, class E, std::size_t N> struct result_storage_as<T, E, N, false>: result_storage_dt<T, E, N>
+{
+    using result_storage_dt<T, E, N>::result_storage_dt;
+
+    result_storage_as( result_storage_as const& ) = default;
+    result_storage_as( result_storage_as&& ) = default;
+
+    result_storage_as& operator=( result_storage_as const& r )
+    {
+        if( r.index() == 0 )
+        {
+            this->template assign<0>( *r.get( mp11::mp_size_t<0>() ) );
+        }
+        else
+        {
+            this->template assign<1>( *r.get( mp11::mp_size_t<1>() ) );
+        }
+
+        return *this;
+    }
+
+    result_storage_as& operator=( result_storage_as&& r )
+        noexcept(
+            std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_constructible<E>::value &&
+            std::is_nothrow_move_assignable<T>::value && std::is_nothrow_move_assignable<E>::value )
+    {
+        if( r.index() == 0 )
+        {
+            this->template assign<0>( std::move( *r.get( mp11::mp_size_t<0>() ) ) );
+        }
+        else
+        {
+            this->template assign<1>( std::move( *r.get( mp11::mp_size_t<1>() ) ) );
+        }
+
+        return *this;
+    }
+};
+
+// special member control
+//
+// delete the copy and move operations that the alternatives don't support
+
+template<bool B> struct cc_control
+{
+};
+
+template<> struct cc_control<false>
+{
+    cc_control() = default;
+    cc_control( cc_control const& ) = delete;
+    cc_control( cc_control&& ) = default;
+    cc_control& operator=( cc_control const& ) = default;
+    cc_control& operator=( cc_control&& ) = default;
+};
+
+template<bool B> struct mc_control
+{
+};
+
+template<> struct mc_control<false>
+{
+    mc_control() = default;
+    mc_control( mc_control const& ) = default;
+    mc_control( mc_control&& ) = delete;
+    mc_control& operator=( mc_control const& ) = default;
+    mc_control& operator=( mc_control&& ) = default;
+};
+
+template<bool B> struct ca_control
+{
+};
+
+template<> struct ca_control<false>
+{
+    ca_control() = default;
+    ca_control( ca_control const& ) = default;
+    ca_control( ca_control&& ) = default;
+    ca_control& operator=( ca_control const& ) = delete;
+    ca_control& operator=( ca_control&& ) = default;
+};
+
+template<bool B> struct ma_control
+{
+};
+
+template<> struct ma_control<false>
+{
+    ma_control() = default;
+    ma_control( ma_control const& ) = default;
+    ma_control( ma_control&& ) = default;
+    ma_control& operator=( ma_control const& ) = default;
+    ma_control& operator=( ma_control&& ) = delete;
+};
+
+// in_place_error_hook_t<H>
+//
+// Constructs the error, then calls H::on_error( e ), which returns true
+
+template<class H> struct in_place_error_hook_t
+{
+};
+
+// the last base of result_storage, which calls the hook from the member
+// initializer list, as a constexpr constructor has to in C++11
+
+struct result_error_hook
+{
+    result_error_hook() = default;
+
+    constexpr explicit result_error_hook( bool ) noexcept
+    {
+    }
+};
+
+// result_storage
+
+template<class T, class E, std::size_t N> class result_storage:
+    result_storage_as<T, E, N>,
+    cc_control<std::is_copy_constructible<T>::value && std::is_copy_constructible<E>::value>,
+    mc_control<std::is_move_constructible<T>::value && std::is_move_constructible<E>::value>,
+    ca_control<std::is_copy_constructible<T>::value && std::is_copy_constructible<E>::value && std::is_copy_assignable<T>::value && std::is_copy_assignable<E>::value>,
+    ma_control<std::is_move_constructible<T>::value && std::is_move_constructible<E>::value && std::is_move_assignable<T>::value && std::is_move_assignable<E>::value>,
+    result_error_hook
+{
+private:
+
+    using base = result_storage_as<T, E, N>;
+
+    template<std::size_t I, class T2, class E2, std::size_t N2> friend BOOST_CXX14_CONSTEXPR mp11::mp_at_c<mp11::mp_list<T2, E2>, I>* get_if( result_storage<T2, E2, N2>* p ) noexcept;
+    template<std::size_t I, class T2, class E2, std::size_t N2> friend constexpr mp11::mp_at_c<mp11::mp_list<T2, E2>, I> const* get_if( result_storage<T2, E2, N2> const* p ) noexcept;
+
+public:
+
+    template<std::size_t I, class... A> constexpr explicit result_storage( variant2::in_place_index_t<I> i, A&&... a ): base( i, std::forward<A>(a)... )
+    {
+    }
+
+    template<class H, class... A> constexpr explicit result_storage( in_place_error_hook_t<H>, A&&... a ):
+        base( variant2::in_place_index_t<1>(), std::forward<A>(a)... ),
+        result_error_hook( H::on_error( *static_cast<base const&>( *this ).get( mp11::mp_size_t<1>() ) ) )
+    {
+    }
+
+    using base::index;
+    using base::assign;
+
+private:
+
+    // both alternatives can be moved by copying bytes; so can the storage
+    void swap_( mp11::mp_true, result_storage& r ) noexcept
+    {
+        unsigned char tmp[ sizeof( result_storage ) ];
+
+        std::memcpy( tmp, static_cast<void*>( this ), sizeof( result_storage ) );
+        std::memcpy( static_cast<void*>( this ), static_cast<void*>( &r ), sizeof( result_storage ) );
+        std::memcpy( static_cast<void*>( &r ), tmp, sizeof( result_storage ) );
+    }
+
+    // requires: this holds a T, r holds an E
+    void swap_mixed( mp11::mp_true, result_storage& r ) noexcept
+    {
+        T tmp( std::move( *this->get( mp11::mp_size_t<0>() ) ) );
+        this->destroy_( mp11::mp_size_t<0>() );
+
+        this->template construct<1>( std::move( *r.get( mp11::mp_size_t<1>() ) ) );
+        r.destroy_( mp11::mp_size_t<1>() );
+
+        r.template construct<0>( std::move( tmp ) );
+    }
+
+    // requires: this holds a T, r holds an E
+    void swap_mixed( mp11::mp_false, result_storage& r )
+    {
+        result_storage tmp( std::move( *this ) );
+
+        *this = std::move( r );
+        r = std::move( tmp );
+    }
+
+    void swap_( mp11::mp_false, result_storage& r )
+    {
+        using mixed_nothrow = mp11::mp_bool<std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_constructible<E>::value>;
+
+        if( index() == r.index() )
+        {
+            using std::swap;
+
+            if( index() == 0 )
+            {
+                swap( *this->get( mp11::mp_size_t<0>() ), *r.get( mp11::mp_size_t<0>() ) );
+            }
+            else
+            {
+                swap( *this->get( mp11::mp_size_t<1>() ), *r.get( mp11::mp_size_t<1>() ) );
+            }
+        }
+        else if( index() == 0 )
+        {
+            swap_mixed( mixed_nothrow(), r );
+        }
+        else
+        {
+            r.swap_mixed( mixed_nothrow(), *this );
+        }
+    }
+
+public:
+
+    // Swaps the bytes when T and E are trivially relocatable; otherwise,
+    // swaps the alternatives when they are the same, and moves each across
+    // when they differ
+    void swap( result_storage& r )
+        noexcept(
+            ( is_trivially_relocatable<T>::value && is_trivially_relocatable<E>::value ) || (
+            std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_constructible<E>::value &&
+            is_nothrow_swappable<T>::value && is_nothrow_swappable<E>::value ) )
+    {
+        swap_( mp11::mp_bool<is_trivially_relocatable<T>::value && is_trivially_relocatable<E>::value>(), r );
+    }
+
+    friend constexpr bool operator==( result_storage const & r1, result_storage const & r2 )
+        noexcept( noexcept( std::declval<T const&>() == std::declval<T const&>() ) && noexcept( std::declval<E const&>() == std::declval<E const&>() ) )
+    {
+        return r1.index() == r2.index() && ( r1.index() == 0?
+            *r1.get( mp11::mp_size_t<0>() ) == *r2.get( mp11::mp_size_t<0>() ):
+            *r1.get( mp11::mp_size_t<1>() ) == *r2.get( mp11::mp_size_t<1>() ) );
+    }
+};
+
+template<std::size_t I, class T, class E, std::size_t N> BOOST_CXX14_CONSTEXPR mp11::mp_at_c<mp11::mp_list<T, E>, I>* get_if( result_storage<T, E, N>* p ) noexcept
+{
+    return p->index() == I? p->get( mp11::mp_size_t<I>() ): 0;
+}
+
+template<std::size_t I, class T, class E, std::size_t N> constexpr mp11::mp_at_c<mp11::mp_list<T, E>, I> const* get_if( result_storage<T, E, N> const* p ) noexcept
+{
+    return p->index() == I? p->get( mp11::mp_size_t<I>() ): 0;
+}
+
+// result_variant<T, E>
+//
+// the storage of result<T, E>; indexed by a niche of T or E when it leaves
+// room for the other alternative, by a separate byte otherwise
+
+template<class T, class E> using result_variant = mp11::mp_cond<
+    niche_fits<T, E>, result_storage<T, E, 0>,
+    niche_fits<E, T>, result_storage<T, E, 1>,
+    mp11::mp_true, result_storage<T, E, result_index_byte>
+>;
+
+} // namespace detail
+} // namespace result
+} // namespace boost
+
+#endif // #ifndef BOOST_RESULT_DETAIL_RESULT_STORAGE_HPP_INCLUDED
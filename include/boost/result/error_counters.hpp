@@ -0,0 +1,368 @@
+#ifndef BOOST_RESULT_ERROR_COUNTERS_HPP_INCLUDED
+#define BOOST_RESULT_ERROR_COUNTERS_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <type_traits>
+#include <algorithm>
+#include <utility>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <ostream>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+//
+// Error counters
+//
+// count_error( cat, value ) increments a counter for the error ( cat, value )
+// in a table owned by the calling thread. Each thread has its own table,
+// aligned to a cache line, and only the owning thread writes to it, with a
+// relaxed load and store, so counting needs no atomic read-modify-write
+// operations and causes no cache line transfers.
+//
+// When BOOST_RESULT_ENABLE_ERROR_COUNTERS is defined, result calls
+// count_error for every error it constructs from arguments, in place or
+// assigned, when the error type has category() and value() members, as
+// std::error_code does, or is an error code enum. Propagating an error
+// with BOOST_RESULT_TRY, co_await, and_then or transform doesn't count it
+// again. Other error types aren't affected. The error constructors of
+// result stay constexpr, and count only when evaluated at run time; before
+// C++20, a counted error can't be constructed in a constant expression.
+//
+// error_counts() returns the totals of all threads, live and exited, and
+// write_prometheus_error_counts writes them in the Prometheus text format:
+//
+//   # TYPE boost_result_errors_total counter
+//   boost_result_errors_total{category="generic",value="22",message="Invalid argument"} 17
+//
+// A thread's table holds BOOST_RESULT_ERROR_COUNTER_SLOTS distinct errors;
+// errors beyond these are counted with a null category.
+//
+
+#if !defined( BOOST_RESULT_ERROR_COUNTER_SLOTS )
+# define BOOST_RESULT_ERROR_COUNTER_SLOTS 128
+#endif
+
+namespace boost
+{
+namespace result
+{
+
+struct error_count
+{
+    std::error_category const* category; // 0 for the errors that didn't fit
+    int value;
+    std::uint64_t count;
+};
+
+namespace detail
+{
+
+class error_counter_table;
+
+// the live tables, and the totals of the exited threads
+
+class error_counter_registry
+{
+private:
+
+    std::mutex mx_;
+    std::vector<error_counter_table*> live_;
+    std::map<std::pair<std::error_category const*, int>, std::uint64_t> retired_;
+
+public:
+
+    void add( error_counter_table* p )
+    {
+        std::lock_guard<std::mutex> lock( mx_ );
+        live_.push_back( p );
+    }
+
+    inline void remove( error_counter_table* p ) noexcept;
+
+    inline std::vector<error_count> snapshot();
+
+    static error_counter_registry& instance()
+    {
+        static error_counter_registry r;
+        return r;
+    }
+};
+
+class alignas( 64 ) error_counter_table
+{
+private:
+
+    static constexpr std::size_t slots = BOOST_RESULT_ERROR_COUNTER_SLOTS;
+
+    static_assert( ( slots & ( slots - 1 ) ) == 0, "BOOST_RESULT_ERROR_COUNTER_SLOTS must be a power of two" );
+
+    struct entry
+    {
+        std::atomic<std::error_category const*> category;
+        std::atomic<int> value;
+        std::atomic<std::uint64_t> count;
+    };
+
+    entry entries_[ slots ];
+    std::atomic<std::uint64_t> overflow_;
+
+    static void increment( std::atomic<std::uint64_t>& c ) noexcept
+    {
+        // only the owning thread writes
+        c.store( c.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+    }
+
+    static std::size_t hash( std::error_category const* cat, int value ) noexcept
+    {
+        std::uint64_t h = ( static_cast<std::uint64_t>( reinterpret_cast<std::uintptr_t>( cat ) ) >> 4 ) ^ static_cast<std::uint32_t>( value );
+
+        h *= 0x9E3779B97F4A7C15ull;
+
+        return static_cast<std::size_t>( h >> 32 );
+    }
+
+public:
+
+    error_counter_table()
+    {
+        for( std::size_t i = 0; i < slots; ++i )
+        {
+            entries_[ i ].category.store( 0, std::memory_order_relaxed );
+            entries_[ i ].value.store( 0, std::memory_order_relaxed );
+            entries_[ i ].count.store( 0, std::memory_order_relaxed );
+        }
+
+        overflow_.store( 0, std::memory_order_relaxed );
+
+        error_counter_registry::instance().add( this );
+    }
+
+    error_counter_table( error_counter_table const& ) = delete;
+    error_counter_table& operator=( error_counter_table const& ) = delete;
+
+    ~error_counter_table()
+    {
+        error_counter_registry::instance().remove( this );
+    }
+
+    void count( std::error_category const* cat, int value ) noexcept
+    {
+        std::size_t h = hash( cat, value );
+
+        for( std::size_t i = 0; i < slots; ++i )
+        {
+            entry& e = entries_[ ( h + i ) & ( slots - 1 ) ];
+
+            std::error_category const* c = e.category.load( std::memory_order_relaxed );
+
+            if( c == cat && e.value.load( std::memory_order_relaxed ) == value )
+            {
+                increment( e.count );
+                return;
+            }
+
+            if( c == 0 )
+            {
+                // the category is published last, for the readers
+
+                e.value.store( value, std::memory_order_relaxed );
+                e.count.store( 1, std::memory_order_relaxed );
+                e.category.store( cat, std::memory_order_release );
+
+                return;
+            }
+        }
+
+        increment( overflow_ );
+    }
+
+    // calls f( cat, value, count ) for the used entries; may be called
+    // from any thread
+
+    template<class F> void visit( F f ) const
+    {
+        for( std::size_t i = 0; i < slots; ++i )
+        {
+            entry const& e = entries_[ i ];
+
+            std::error_category const* c = e.category.load( std::memory_order_acquire );
+
+            if( c != 0 )
+            {
+                f( c, e.value.load( std::memory_order_relaxed ), e.count.load( std::memory_order_relaxed ) );
+            }
+        }
+
+        std::uint64_t n = overflow_.load( std::memory_order_relaxed );
+
+        if( n != 0 )
+        {
+            f( static_cast<std::error_category const*>( 0 ), 0, n );
+        }
+    }
+
+    static error_counter_table& instance()
+    {
+        static thread_local error_counter_table table;
+        return table;
+    }
+};
+
+inline void error_counter_registry::remove( error_counter_table* p ) noexcept
+{
+    std::lock_guard<std::mutex> lock( mx_ );
+
+    live_.erase( std::remove( live_.begin(), live_.end(), p ), live_.end() );
+
+    BOOST_TRY
+    {
+        p->visit( [&]( std::error_category const* c, int v, std::uint64_t n ){ retired_[ std::make_pair( c, v ) ] += n; } );
+    }
+    BOOST_CATCH(...)
+    {
+        // out of memory; the counts of this thread are lost
+    }
+    BOOST_CATCH_END
+}
+
+inline std::vector<error_count> error_counter_registry::snapshot()
+{
+    std::lock_guard<std::mutex> lock( mx_ );
+
+    std::map<std::pair<std::error_category const*, int>, std::uint64_t> m( retired_ );
+
+    for( error_counter_table* p: live_ )
+    {
+        p->visit( [&]( std::error_category const* c, int v, std::uint64_t n ){ m[ std::make_pair( c, v ) ] += n; } );
+    }
+
+    std::vector<error_count> r;
+    r.reserve( m.size() );
+
+    for( auto const& x: m )
+    {
+        error_count e = { x.first.first, x.first.second, x.second };
+        r.push_back( e );
+    }
+
+    return r;
+}
+
+} // namespace detail
+
+// count_error( cat, value )
+
+BOOST_NOINLINE inline void count_error( std::error_category const & cat, int value ) noexcept
+{
+    BOOST_TRY
+    {
+        detail::error_counter_table::instance().count( &cat, value );
+    }
+    BOOST_CATCH(...)
+    {
+        // the table of this thread couldn't be registered; try again next time
+    }
+    BOOST_CATCH_END
+}
+
+// error_counts()
+//
+// Returns the error counts of all threads, ordered by category address and
+// value.
+
+inline std::vector<error_count> error_counts()
+{
+    return detail::error_counter_registry::instance().snapshot();
+}
+
+namespace detail
+{
+
+inline void write_prometheus_label( std::ostream& os, std::string const& s )
+{
+    for( char ch: s )
+    {
+        switch( ch )
+        {
+        case '\\': os << "\\\\"; break;
+        case '"': os << "\\\""; break;
+        case '\n': os << "\\n"; break;
+        default: os << ch;
+        }
+    }
+}
+
+} // namespace detail
+
+// write_prometheus_error_counts( os, name )
+//
+// Writes the error counts as a Prometheus counter with the labels category,
+// value and message.
+
+inline void write_prometheus_error_counts( std::ostream& os, char const* name = "boost_result_errors_total" )
+{
+    os << "# HELP " << name << " Errors constructed by result, by category and value.\n";
+    os << "# TYPE " << name << " counter\n";
+
+    for( error_count const& e: error_counts() )
+    {
+        os << name << "{category=\"";
+
+        if( e.category )
+        {
+            detail::write_prometheus_label( os, e.category->name() );
+            os << "\",value=\"" << e.value << "\",message=\"";
+            detail::write_prometheus_label( os, e.category->message( e.value ) );
+        }
+        else
+        {
+            os << "(other)\",value=\"\",message=\"";
+        }
+
+        os << "\"} " << e.count << '\n';
+    }
+}
+
+// write_prometheus_error_counts( path, name )
+//
+// Writes the counts to a temporary file and renames it to path, so that a
+// collector reading the file never sees a partial one. Returns false on
+// failure.
+
+inline bool write_prometheus_error_counts( char const* path, char const* name = "boost_result_errors_total" )
+{
+    std::string tmp = std::string( path ) + ".tmp";
+
+    {
+        std::ofstream os( tmp.c_str() );
+
+        write_prometheus_error_counts( os, name );
+
+        os.close();
+
+        if( !os )
+        {
+            std::remove( tmp.c_str() );
+            return false;
+        }
+    }
+
+    return std::rename( tmp.c_str(), path ) == 0;
+}
+
+} // namespace result
+} // namespace boost
+
+#endif // #ifndef BOOST_RESULT_ERROR_COUNTERS_HPP_INCLUDED
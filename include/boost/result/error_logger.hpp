@@ -0,0 +1,769 @@
+#ifndef BOOST_RESULT_ERROR_LOGGER_HPP_INCLUDED
+#define BOOST_RESULT_ERROR_LOGGER_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <type_traits>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+#if defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_IX86 ) )
+# include <intrin.h>
+#endif
+
+//
+// error_logger
+//
+// A logger for error results that keeps formatting off the calling thread.
+// log( r ) stores a fixed size record - the time, the category, the value,
+// and the source location, if any - in a ring buffer owned by the calling
+// thread, without locking or allocating; a background thread drains the
+// rings, formats the records and writes them to the stream given to the
+// constructor, one per line:
+//
+//   2021-06-01 12:00:00.123456 generic:22 Invalid argument at server.cpp:42 in handle()
+//
+// Identical errors - same category, value and source location - are written
+// at most once per interval. The ones suppressed in between are reported
+// by a single line, when the interval ends, with the last of them and their
+// number:
+//
+//   2021-06-01 12:00:00.998001 generic:22 Invalid argument (1733 suppressed)
+//
+// A ring holds BOOST_RESULT_ERROR_LOGGER_RING_SIZE records; when it's full,
+// log() drops the record and returns false. The number of dropped records
+// is written periodically and is returned by dropped().
+//
+// On x86, the records are timestamped with the time stamp counter, which is
+// several times cheaper to read than the system clock. The background thread
+// converts the counter to steady_clock time, at a rate measured against
+// steady_clock, and orders and deduplicates the records by it; the system
+// clock is only used to display the times, so stepping it doesn't affect
+// either. This assumes an invariant TSC, which all x86 processors of the
+// last decade have.
+//
+// The destructor writes the remaining records and the pending suppressed
+// counts. Records are logged from any thread; the stream is only used by the
+// background thread until the logger is destroyed.
+//
+
+#if !defined( BOOST_RESULT_ERROR_LOGGER_RING_SIZE )
+# define BOOST_RESULT_ERROR_LOGGER_RING_SIZE 1024
+#endif
+
+namespace boost
+{
+namespace result
+{
+
+namespace detail
+{
+
+struct error_log_record
+{
+    std::int64_t time; // error_log_ticks() when logged, steady_clock nanoseconds when drained
+    std::error_category const* category;
+    int value;
+    unsigned line;
+    char const* file;
+    char const* function;
+};
+
+inline std::int64_t error_log_steady_time() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+#if ( defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) ) ) || ( defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_IX86 ) ) )
+
+BOOST_CONSTEXPR_OR_CONST bool error_log_ticks_are_steady_time = false;
+
+inline std::uint64_t error_log_ticks() noexcept
+{
+#if defined( _MSC_VER )
+
+    return __rdtsc();
+
+#else
+
+    return __builtin_ia32_rdtsc();
+
+#endif
+}
+
+#else
+
+BOOST_CONSTEXPR_OR_CONST bool error_log_ticks_are_steady_time = true;
+
+inline std::uint64_t error_log_ticks() noexcept
+{
+    return static_cast<std::uint64_t>( error_log_steady_time() );
+}
+
+#endif
+
+// a single producer, single consumer ring
+
+class error_log_ring
+{
+private:
+
+    static constexpr std::size_t size = BOOST_RESULT_ERROR_LOGGER_RING_SIZE;
+
+    static_assert( ( size & ( size - 1 ) ) == 0, "BOOST_RESULT_ERROR_LOGGER_RING_SIZE must be a power of two" );
+
+    // the ring is allocated with new, so the producer and the consumer
+    // fields are kept on separate cache lines by padding rather than by
+    // alignas, which needs C++17
+
+    // written by the producer
+
+    std::atomic<std::size_t> head_;
+    std::size_t tail_cache_;
+    std::atomic<std::uint64_t> dropped_;
+
+    char pad1_[ 64 ];
+
+    // written by the consumer
+
+    std::atomic<std::size_t> tail_;
+
+    char pad2_[ 64 ];
+
+    // set when the thread exits, and when the logger is destroyed
+
+    std::atomic<bool> abandoned_;
+    std::atomic<bool> closed_;
+
+    error_log_record records_[ size ];
+
+public:
+
+    error_log_ring() noexcept: tail_cache_( 0 )
+    {
+        head_.store( 0, std::memory_order_relaxed );
+        dropped_.store( 0, std::memory_order_relaxed );
+        tail_.store( 0, std::memory_order_relaxed );
+        abandoned_.store( false, std::memory_order_relaxed );
+        closed_.store( false, std::memory_order_relaxed );
+    }
+
+    error_log_ring( error_log_ring const& ) = delete;
+    error_log_ring& operator=( error_log_ring const& ) = delete;
+
+    bool push( error_log_record const& r ) noexcept
+    {
+        std::size_t h = head_.load( std::memory_order_relaxed );
+
+        if( h - tail_cache_ == size )
+        {
+            tail_cache_ = tail_.load( std::memory_order_acquire );
+
+            if( h - tail_cache_ == size )
+            {
+                // only the producer writes
+                dropped_.store( dropped_.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+                return false;
+            }
+        }
+
+        records_[ h & ( size - 1 ) ] = r;
+        head_.store( h + 1, std::memory_order_release );
+
+        return true;
+    }
+
+    // called by the consumer; returns false when the thread has exited
+    // and the ring is empty
+
+    template<class F> bool drain( F f )
+    {
+        bool abandoned = abandoned_.load( std::memory_order_acquire );
+
+        std::size_t t = tail_.load( std::memory_order_relaxed );
+        std::size_t h = head_.load( std::memory_order_acquire );
+
+        for( ; t != h; ++t )
+        {
+            f( records_[ t & ( size - 1 ) ] );
+        }
+
+        tail_.store( t, std::memory_order_release );
+
+        return !abandoned;
+    }
+
+    std::uint64_t dropped() const noexcept
+    {
+        return dropped_.load( std::memory_order_relaxed );
+    }
+
+    void abandon() noexcept
+    {
+        abandoned_.store( true, std::memory_order_release );
+    }
+
+    void close() noexcept
+    {
+        closed_.store( true, std::memory_order_relaxed );
+    }
+
+    bool closed() const noexcept
+    {
+        return closed_.load( std::memory_order_relaxed );
+    }
+};
+
+// the rings of the calling thread, by logger id
+
+class error_log_thread_rings
+{
+private:
+
+    struct entry
+    {
+        std::uint64_t id;
+        std::shared_ptr<error_log_ring> ring;
+    };
+
+    std::vector<entry> v_;
+
+public:
+
+    error_log_thread_rings() = default;
+
+    error_log_thread_rings( error_log_thread_rings const& ) = delete;
+    error_log_thread_rings& operator=( error_log_thread_rings const& ) = delete;
+
+    ~error_log_thread_rings()
+    {
+        for( entry const& e: v_ )
+        {
+            e.ring->abandon();
+        }
+    }
+
+    // also forgets the rings of the destroyed loggers that it passes, so
+    // that their memory is freed
+
+    error_log_ring* find( std::uint64_t id ) noexcept
+    {
+        for( auto it = v_.begin(); it != v_.end(); )
+        {
+            if( it->id == id ) return it->ring.get();
+
+            if( it->ring->closed() )
+            {
+                it = v_.erase( it );
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        return 0;
+    }
+
+    void add( std::uint64_t id, std::shared_ptr<error_log_ring> const& p )
+    {
+        // forget the rings of the destroyed loggers
+
+        v_.erase( std::remove_if( v_.begin(), v_.end(), []( entry const& e ){ return e.ring->closed(); } ), v_.end() );
+
+        entry e = { id, p };
+        v_.push_back( e );
+    }
+
+    static error_log_thread_rings& instance()
+    {
+        static thread_local error_log_thread_rings rings;
+        return rings;
+    }
+};
+
+// 2021-06-01 12:00:00.123456
+
+inline void write_error_log_time( std::ostream& os, std::int64_t t )
+{
+    std::int64_t us = t / 1000;
+
+    std::int64_t s = us / 1000000;
+    us %= 1000000;
+
+    if( us < 0 ) { us += 1000000; --s; }
+
+    std::int64_t z = s / 86400;
+    s %= 86400;
+
+    if( s < 0 ) { s += 86400; --z; }
+
+    // civil_from_days, by Howard Hinnant
+
+    z += 719468;
+
+    std::int64_t era = ( z >= 0? z: z - 146096 ) / 146097;
+    std::int64_t doe = z - era * 146097;
+    std::int64_t yoe = ( doe - doe / 1460 + doe / 36524 - doe / 146096 ) / 365;
+    std::int64_t doy = doe - ( 365 * yoe + yoe / 4 - yoe / 100 );
+    std::int64_t mp = ( 5 * doy + 2 ) / 153;
+
+    std::int64_t d = doy - ( 153 * mp + 2 ) / 5 + 1;
+    std::int64_t m = mp < 10? mp + 3: mp - 9;
+    std::int64_t y = yoe + era * 400 + ( m <= 2 );
+
+    char buffer[ 32 ];
+
+    int n = std::snprintf( buffer, sizeof( buffer ), "%04lld-%02d-%02d %02d:%02d:%02d.%06d",
+        static_cast<long long>( y ), static_cast<int>( m ), static_cast<int>( d ),
+        static_cast<int>( s / 3600 ), static_cast<int>( s / 60 % 60 ), static_cast<int>( s % 60 ), static_cast<int>( us ) );
+
+    os.write( buffer, n );
+}
+
+template<class E> auto error_log_parts( E const& e, int ) noexcept -> decltype( std::make_pair( &e.category(), static_cast<int>( e.value() ) ) )
+{
+    return std::make_pair( &e.category(), static_cast<int>( e.value() ) );
+}
+
+template<class E> std::pair<std::error_category const*, int> error_log_parts_enum( E const& e, std::true_type ) noexcept
+{
+    std::error_code ec = make_error_code( e );
+    return std::make_pair( &ec.category(), ec.value() );
+}
+
+template<class E> std::pair<std::error_category const*, int> error_log_parts_enum( E const&, std::false_type ) noexcept
+{
+    return std::pair<std::error_category const*, int>( static_cast<std::error_category const*>( 0 ), 0 );
+}
+
+template<class E> std::pair<std::error_category const*, int> error_log_parts( E const& e, long ) noexcept
+{
+    return detail::error_log_parts_enum( e, std::is_error_code_enum<E>() );
+}
+
+} // namespace detail
+
+class error_logger
+{
+private:
+
+    using record = detail::error_log_record;
+    using key = std::tuple<std::error_category const*, int, char const*, unsigned>;
+
+    struct state
+    {
+        std::int64_t written;
+        std::uint64_t suppressed;
+        record last;
+    };
+
+    std::uint64_t const id_;
+
+    std::ostream& os_;
+    std::int64_t const interval_;
+
+    // for converting the ticks to steady_clock time
+
+    std::uint64_t const ticks0_;
+    std::int64_t const time0_;
+
+    // system_clock minus steady_clock, for display; updated on each pass
+
+    std::int64_t display_offset_;
+
+    std::mutex mx_;
+    std::condition_variable cv_;
+    std::condition_variable cv_flushed_;
+
+    std::vector<std::shared_ptr<detail::error_log_ring>> rings_;
+
+    std::uint64_t dropped_retired_;
+    std::uint64_t dropped_written_;
+
+    std::uint64_t flush_requested_;
+    std::uint64_t flush_done_;
+    bool stopping_;
+
+    // used by the background thread only
+
+    std::vector<record> batch_;
+    std::map<key, state> states_;
+
+    std::thread thread_;
+
+private:
+
+    static std::uint64_t next_id() noexcept
+    {
+        static std::atomic<std::uint64_t> id( 0 );
+        return ++id;
+    }
+
+    static std::int64_t system_time() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::system_clock::now().time_since_epoch() ).count();
+    }
+
+    BOOST_NOINLINE detail::error_log_ring* register_thread() noexcept
+    {
+        BOOST_TRY
+        {
+            std::shared_ptr<detail::error_log_ring> p( new detail::error_log_ring );
+
+            detail::error_log_thread_rings::instance().add( id_, p );
+
+            std::lock_guard<std::mutex> lock( mx_ );
+            rings_.push_back( p );
+
+            return p.get();
+        }
+        BOOST_CATCH(...)
+        {
+            return 0;
+        }
+        BOOST_CATCH_END
+    }
+
+    void write( record const& r, std::uint64_t suppressed )
+    {
+        detail::write_error_log_time( os_, r.time + display_offset_ );
+
+        os_ << ' ' << r.category->name() << ':' << r.value << ' ' << r.category->message( r.value );
+
+        if( r.file )
+        {
+            os_ << " at " << r.file << ':' << r.line;
+
+            if( r.function && *r.function )
+            {
+                os_ << " in " << r.function;
+            }
+        }
+
+        if( suppressed )
+        {
+            os_ << " (" << suppressed << " suppressed)";
+        }
+
+        os_ << '\n';
+    }
+
+    void write_suppressed( state& st )
+    {
+        if( st.suppressed )
+        {
+            write( st.last, st.suppressed );
+            st.suppressed = 0;
+        }
+    }
+
+    void process( record const& r )
+    {
+        key k( r.category, r.value, r.file, r.line );
+
+        auto it = states_.find( k );
+
+        if( it == states_.end() )
+        {
+            state st = { r.time, 0, r };
+            states_.insert( std::make_pair( k, st ) );
+
+            write( r, 0 );
+        }
+        else if( r.time - it->second.written < interval_ )
+        {
+            ++it->second.suppressed;
+            it->second.last = r;
+        }
+        else
+        {
+            write_suppressed( it->second );
+            write( r, 0 );
+
+            it->second.written = r.time;
+        }
+    }
+
+    // writes the suppressed counts of the intervals that have ended, or all
+    // of them, and forgets the errors not seen for a while
+
+    void expire( std::int64_t t, bool all )
+    {
+        for( auto it = states_.begin(); it != states_.end(); )
+        {
+            state& st = it->second;
+
+            if( all || t - st.written >= interval_ )
+            {
+                if( st.suppressed )
+                {
+                    write_suppressed( st );
+                    st.written = t;
+                }
+                else if( t - st.written >= 64 * interval_ )
+                {
+                    it = states_.erase( it );
+                    continue;
+                }
+            }
+
+            ++it;
+        }
+    }
+
+    void write_dropped( std::uint64_t dropped )
+    {
+        if( dropped != dropped_written_ )
+        {
+            detail::write_error_log_time( os_, system_time() );
+            os_ << ' ' << dropped - dropped_written_ << " error records dropped\n";
+
+            dropped_written_ = dropped;
+        }
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock( mx_ );
+
+        for( ;; )
+        {
+            bool stopping = stopping_;
+            std::uint64_t flush_requested = flush_requested_;
+
+            std::vector<std::shared_ptr<detail::error_log_ring>> rings( rings_ );
+
+            lock.unlock();
+
+            // the nanoseconds per tick since the logger was created, both
+            // measured on steady_clock; the conversion is anchored to the
+            // current time, so its error is proportional to the age of the
+            // record
+
+            std::uint64_t ticks = detail::error_log_ticks();
+            std::int64_t time = detail::error_log_steady_time();
+
+            display_offset_ = system_time() - time;
+
+            double rate = 1.0;
+
+            if( !detail::error_log_ticks_are_steady_time && ticks > ticks0_ && time > time0_ )
+            {
+                rate = static_cast<double>( time - time0_ ) / static_cast<double>( ticks - ticks0_ );
+            }
+
+            batch_.clear();
+
+            std::vector<detail::error_log_ring*> exited;
+            std::uint64_t dropped = 0;
+
+            BOOST_TRY
+            {
+                for( auto const& p: rings )
+                {
+                    if( !p->drain( [&]( record const& r ){
+
+                        batch_.push_back( r );
+
+                        std::int64_t age = static_cast<std::int64_t>( ticks - static_cast<std::uint64_t>( r.time ) );
+                        batch_.back().time = time - static_cast<std::int64_t>( static_cast<double>( age ) * rate );
+
+                    } ) )
+                    {
+                        exited.push_back( p.get() );
+                    }
+
+                    dropped += p->dropped();
+                }
+
+                std::stable_sort( batch_.begin(), batch_.end(), []( record const& r1, record const& r2 ){ return r1.time < r2.time; } );
+
+                for( record const& r: batch_ )
+                {
+                    process( r );
+                }
+
+                expire( time, stopping );
+            }
+            BOOST_CATCH(...)
+            {
+                // out of memory, or the stream has thrown; the records are lost
+            }
+            BOOST_CATCH_END
+
+            lock.lock();
+
+            // the rings of the exited threads have been drained for the
+            // last time
+
+            for( detail::error_log_ring* p: exited )
+            {
+                dropped_retired_ += p->dropped();
+                dropped -= p->dropped();
+
+                rings_.erase( std::remove_if( rings_.begin(), rings_.end(), [&]( std::shared_ptr<detail::error_log_ring> const& q ){ return q.get() == p; } ), rings_.end() );
+            }
+
+            BOOST_TRY
+            {
+                write_dropped( dropped_retired_ + dropped );
+                os_.flush();
+            }
+            BOOST_CATCH(...)
+            {
+            }
+            BOOST_CATCH_END
+
+            flush_done_ = flush_requested;
+            cv_flushed_.notify_all();
+
+            if( stopping ) break;
+
+            cv_.wait_for( lock, std::chrono::milliseconds( 10 ), [&]{ return stopping_ || flush_requested_ != flush_requested; } );
+        }
+    }
+
+public:
+
+    explicit error_logger( std::ostream& os, std::chrono::milliseconds interval = std::chrono::seconds( 1 ) ):
+        id_( next_id() ), os_( os ), interval_( std::chrono::duration_cast<std::chrono::nanoseconds>( interval ).count() ),
+        ticks0_( detail::error_log_ticks() ), time0_( detail::error_log_steady_time() ), display_offset_( 0 ),
+        dropped_retired_( 0 ), dropped_written_( 0 ), flush_requested_( 0 ), flush_done_( 0 ), stopping_( false )
+    {
+        thread_ = std::thread( [this]{ run(); } );
+    }
+
+    error_logger( error_logger const& ) = delete;
+    error_logger& operator=( error_logger const& ) = delete;
+
+    ~error_logger()
+    {
+        {
+            std::lock_guard<std::mutex> lock( mx_ );
+            stopping_ = true;
+        }
+
+        cv_.notify_one();
+        thread_.join();
+
+        for( auto const& p: rings_ )
+        {
+            p->close();
+        }
+    }
+
+    // log( cat, value, file, line, function )
+    //
+    // file and function must point to strings with static storage duration,
+    // such as __FILE__ and __func__; the record keeps the pointers.
+
+    bool log( std::error_category const& cat, int value, char const* file = 0, unsigned line = 0, char const* function = 0 ) noexcept
+    {
+        detail::error_log_ring* p = detail::error_log_thread_rings::instance().find( id_ );
+
+        if( BOOST_UNLIKELY( p == 0 ) )
+        {
+            p = register_thread();
+            if( p == 0 ) return false;
+        }
+
+        record r = { static_cast<std::int64_t>( detail::error_log_ticks() ), &cat, value, line, file, function };
+        return p->push( r );
+    }
+
+    // log( e )
+    //
+    // Logs an error code, or an error code enum; returns false for the
+    // other error types.
+
+    template<class E> bool log( E const& e ) noexcept
+    {
+        std::pair<std::error_category const*, int> x = detail::error_log_parts( e, 0 );
+        return x.first? log( *x.first, x.second ): false;
+    }
+
+    // log( r )
+    //
+    // Logs the error of r, along with its source location, when
+    // BOOST_RESULT_HAS_SOURCE_LOCATION is defined; returns false when r
+    // holds a value.
+
+    template<class T, class E> bool log( result<T, E> const& r ) noexcept
+    {
+        if( r.has_value() ) return false;
+
+        std::pair<std::error_category const*, int> x = detail::error_log_parts( r.error(), 0 );
+
+        if( !x.first ) return false;
+
+#if defined( BOOST_RESULT_HAS_SOURCE_LOCATION )
+
+        std::source_location loc = r.error_location();
+
+        if( loc.line() != 0 )
+        {
+            return log( *x.first, x.second, loc.file_name(), loc.line(), loc.function_name() );
+        }
+
+#endif
+
+        return log( *x.first, x.second );
+    }
+
+    // flush()
+    //
+    // Waits until the records logged before the call have been written.
+
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock( mx_ );
+
+        std::uint64_t n = ++flush_requested_;
+
+        cv_.notify_one();
+        cv_flushed_.wait( lock, [&]{ return flush_done_ >= n; } );
+    }
+
+    // dropped()
+    //
+    // Returns the number of records dropped because a ring was full.
+
+    std::uint64_t dropped()
+    {
+        std::lock_guard<std::mutex> lock( mx_ );
+
+        std::uint64_t r = dropped_retired_;
+
+        for( auto const& p: rings_ )
+        {
+            r += p->dropped();
+        }
+
+        return r;
+    }
+};
+
+} // namespace result
+} // namespace boost
+
+#endif // #ifndef BOOST_RESULT_ERROR_LOGGER_HPP_INCLUDED
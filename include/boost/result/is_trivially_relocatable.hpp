@@ -0,0 +1,46 @@
+#ifndef BOOST_RESULT_IS_TRIVIALLY_RELOCATABLE_HPP_INCLUDED
+#define BOOST_RESULT_IS_TRIVIALLY_RELOCATABLE_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/config.hpp>
+#include <type_traits>
+
+//
+
+namespace boost
+{
+namespace result
+{
+
+// is_trivially_relocatable
+//
+// A specialization of is_trivially_relocatable<T> deriving from
+// std::true_type declares that moving a T to another address and then
+// destroying the original is equivalent to copying its bytes, as is the
+// case for most types that don't store pointers into themselves (e.g.
+// std::unique_ptr or std::vector, but not std::string in libstdc++.)
+// result<T, E> then swaps by exchanging the bytes of the two objects.
+//
+// Trivially copyable types are trivially relocatable.
+
+#if defined( BOOST_LIBSTDCXX_VERSION ) && BOOST_LIBSTDCXX_VERSION < 50000
+
+template<class T> struct is_trivially_relocatable: std::integral_constant<bool, std::is_trivial<T>::value>
+{
+};
+
+#else
+
+template<class T> struct is_trivially_relocatable: std::integral_constant<bool, std::is_trivially_copyable<T>::value>
+{
+};
+
+#endif
+
+} // namespace result
+} // namespace boost
+
+#endif // #ifndef BOOST_RESULT_IS_TRIVIALLY_RELOCATABLE_HPP_INCLUDED
@@ -0,0 +1,82 @@
+#ifndef BOOST_RESULT_NICHE_TRAITS_HPP_INCLUDED
+#define BOOST_RESULT_NICHE_TRAITS_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <cstddef>
+#include <cstring>
+
+//
+
+namespace boost
+{
+namespace result
+{
+
+// niche_traits
+//
+// A specialization of niche_traits<T> declares that T has spare object
+// representations, bit patterns that no T object ever holds. result<T, E>
+// (and result<T2, T>) then records which alternative is active by storing
+// such a pattern into the storage of T, instead of keeping a separate index.
+//
+// A specialization that enables the optimization has the members
+//
+//   static constexpr bool value = true;
+//
+//   // Bytes of T before `offset` are never accessed by set_spare or
+//   // is_spare, so an alternative of up to `offset` bytes can share the
+//   // storage of T.
+//   static constexpr std::size_t offset = ...;
+//
+//   // Writes a spare pattern into the storage of T pointed to by p,
+//   // touching only bytes at `offset` or above.
+//   static void set_spare( void* p ) noexcept;
+//
+//   // Returns true when the storage pointed to by p holds a spare pattern.
+//   static bool is_spare( void const* p ) noexcept;
+
+template<class T> struct niche_traits
+{
+    static constexpr bool value = false;
+};
+
+// niche_at<T, Offset, M, V>
+//
+// The member of type M at byte offset Offset in T never has the value V.
+
+template<class T, std::size_t Offset, class M, M V> struct niche_at
+{
+    static_assert( Offset + sizeof( M ) <= sizeof( T ), "The niche must be within T" );
+
+    static constexpr bool value = true;
+    static constexpr std::size_t offset = Offset;
+
+    static void set_spare( void* p ) noexcept
+    {
+        M const v = V;
+        std::memcpy( static_cast<unsigned char*>( p ) + Offset, &v, sizeof( M ) );
+    }
+
+    static bool is_spare( void const* p ) noexcept
+    {
+        M v;
+        std::memcpy( &v, static_cast<unsigned char const*>( p ) + Offset, sizeof( M ) );
+        return v == V;
+    }
+};
+
+// niche_value<T, V>
+//
+// T never has the value V; for enumerations, integers and pointers.
+
+template<class T, T V> struct niche_value: niche_at<T, 0, T, V>
+{
+};
+
+} // namespace result
+} // namespace boost
+
+#endif // #ifndef BOOST_RESULT_NICHE_TRAITS_HPP_INCLUDED
@@ -0,0 +1,410 @@
+#ifndef BOOST_RESULT_PARALLEL_HPP_INCLUDED
+#define BOOST_RESULT_PARALLEL_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result.hpp>
+#include <type_traits>
+#include <iterator>
+#include <utility>
+#include <algorithm>
+#include <exception>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <cstddef>
+
+//
+// Parallel collect and reduce over a random access range, applying a
+// function that returns a result to each element.
+//
+// The range is split into chunks that the threads take in increasing
+// order. In the short-circuit variants (parallel_collect, parallel_reduce)
+// the first error lowers a shared stop index, and the elements past it
+// are no longer visited; the error returned is always the one at the
+// lowest index, regardless of the thread count and the scheduling. The
+// _all variants visit every element and return all errors, ordered by
+// index, along with their indices.
+//
+// The thread count argument includes the calling thread; 0 means
+// std::thread::hardware_concurrency(). An exception thrown by the function
+// stops the remaining chunks and is rethrown from the calling thread.
+//
+
+namespace boost
+{
+namespace result
+{
+
+template<class E> using indexed_errors = std::vector< std::pair<std::size_t, E> >;
+
+namespace detail
+{
+
+// the function is called on the elements of the range and returns a result
+
+template<class R, class F> using parallel_invoke_result = remove_cvref<decltype( std::declval<F&>()( *std::begin( std::declval<R const&>() ) ) )>;
+
+struct parallel_plan
+{
+    std::size_t n;
+    std::size_t grain;
+    std::size_t chunks;
+    unsigned threads;
+
+    parallel_plan( std::size_t n_, unsigned threads_ ): n( n_ )
+    {
+        if( threads_ == 0 )
+        {
+            threads_ = std::thread::hardware_concurrency();
+            if( threads_ == 0 ) threads_ = 1;
+        }
+
+        // several chunks per thread, so that an early error cancels most
+        // of the work and an uneven chunk doesn't hold up the rest
+
+        grain = n / ( threads_ * 16u );
+        if( grain == 0 ) grain = 1;
+
+        chunks = ( n + grain - 1 ) / grain;
+
+        threads = chunks < threads_? static_cast<unsigned>( chunks ): threads_;
+        if( threads == 0 ) threads = 1;
+    }
+
+    std::size_t first( std::size_t c ) const noexcept
+    {
+        return c * grain;
+    }
+
+    std::size_t last( std::size_t c ) const noexcept
+    {
+        return c + 1 < chunks? ( c + 1 ) * grain: n;
+    }
+};
+
+// body( t, c ) processes chunk c on thread t, returns false to stop the thread
+
+template<class Body> void parallel_run( parallel_plan const& plan, Body& body )
+{
+    std::atomic<std::size_t> next( 0 );
+    std::vector<std::exception_ptr> ex( plan.threads );
+
+    auto worker = [&]( unsigned t )
+    {
+        try
+        {
+            for( ;; )
+            {
+                std::size_t c = next.fetch_add( 1, std::memory_order_relaxed );
+
+                if( c >= plan.chunks || !body( t, c ) ) break;
+            }
+        }
+        catch( ... )
+        {
+            ex[ t ] = std::current_exception();
+            next.store( plan.chunks, std::memory_order_relaxed );
+        }
+    };
+
+    std::vector<std::thread> th;
+    th.reserve( plan.threads );
+
+    try
+    {
+        for( unsigned t = 1; t < plan.threads; ++t )
+        {
+            th.emplace_back( worker, t );
+        }
+    }
+    catch( ... )
+    {
+        next.store( plan.chunks, std::memory_order_relaxed );
+
+        for( auto& x: th ) x.join();
+        throw;
+    }
+
+    worker( 0 );
+
+    for( auto& x: th ) x.join();
+
+    for( auto& e: ex )
+    {
+        if( e ) std::rethrow_exception( e );
+    }
+}
+
+inline void lower_stop_index( std::atomic<std::size_t>& stop, std::size_t i ) noexcept
+{
+    std::size_t s = stop.load( std::memory_order_relaxed );
+    while( i < s && !stop.compare_exchange_weak( s, i, std::memory_order_relaxed ) );
+}
+
+// the errors of each thread are in increasing index order
+
+template<class E> indexed_errors<E> merge_errors( std::vector< indexed_errors<E> >& errors )
+{
+    indexed_errors<E> r;
+
+    for( auto& v: errors )
+    {
+        for( auto& x: v ) r.push_back( std::move( x ) );
+    }
+
+    std::stable_sort( r.begin(), r.end(), []( std::pair<std::size_t, E> const& x, std::pair<std::size_t, E> const& y ){ return x.first < y.first; } );
+
+    return r;
+}
+
+template<class E> E lowest_error( std::vector< indexed_errors<E> >& errors )
+{
+    std::size_t k = 0;
+
+    for( std::size_t t = 1; t < errors.size(); ++t )
+    {
+        if( !errors[ t ].empty() && ( errors[ k ].empty() || errors[ t ].front().first < errors[ k ].front().first ) )
+        {
+            k = t;
+        }
+    }
+
+    return std::move( errors[ k ].front().second );
+}
+
+// collects the values into v and the errors into the per-thread lists;
+// in short-circuit mode, each thread stops at its first error
+//
+// v, and partials below, are arrays rather than std::vector<T>, because the
+// threads write to neighbouring elements, and std::vector<bool> packs them
+// into the same word
+
+template<bool ShortCircuit, class R, class F, class T, class E>
+void parallel_collect_( R const& r, F& f, parallel_plan const& plan, T* v, std::vector< indexed_errors<E> >& errors )
+{
+    auto it = std::begin( r );
+    std::atomic<std::size_t> stop( plan.n );
+
+    auto body = [&]( unsigned t, std::size_t c ) -> bool
+    {
+        for( std::size_t i = plan.first( c ), last = plan.last( c ); i < last; ++i )
+        {
+            if( ShortCircuit && i > stop.load( std::memory_order_relaxed ) ) return false;
+
+            auto q = f( it[ i ] );
+
+            if( q.has_value() )
+            {
+                v[ i ] = std::move( *q );
+            }
+            else
+            {
+                errors[ t ].emplace_back( i, std::move( q ).error() );
+
+                if( ShortCircuit )
+                {
+                    lower_stop_index( stop, i );
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    };
+
+    parallel_run( plan, body );
+}
+
+// reduces each chunk into partials[ c ], or collects the errors as above
+
+template<bool ShortCircuit, class R, class F, class T, class E, class Op>
+void parallel_reduce_( R const& r, F& f, Op& op, parallel_plan const& plan, T* partials, std::vector< indexed_errors<E> >& errors )
+{
+    auto it = std::begin( r );
+    std::atomic<std::size_t> stop( plan.n );
+
+    auto body = [&]( unsigned t, std::size_t c ) -> bool
+    {
+        bool has_error = false;
+
+        for( std::size_t i = plan.first( c ), first = i, last = plan.last( c ); i < last; ++i )
+        {
+            if( ShortCircuit && i > stop.load( std::memory_order_relaxed ) ) return false;
+
+            auto q = f( it[ i ] );
+
+            if( q.has_error() )
+            {
+                errors[ t ].emplace_back( i, std::move( q ).error() );
+                has_error = true;
+
+                if( ShortCircuit )
+                {
+                    lower_stop_index( stop, i );
+                    return false;
+                }
+            }
+            else if( !has_error )
+            {
+                // once the chunk has an error, its partial result is no longer needed
+
+                partials[ c ] = i == first? std::move( *q ): op( std::move( partials[ c ] ), std::move( *q ) );
+            }
+        }
+
+        return true;
+    };
+
+    parallel_run( plan, body );
+}
+
+template<class T> std::vector<T> move_to_vector( std::unique_ptr<T[]>& p, std::size_t n )
+{
+    std::vector<T> r;
+    r.reserve( n );
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        r.push_back( std::move( p[ i ] ) );
+    }
+
+    return r;
+}
+
+template<class E> bool has_errors( std::vector< indexed_errors<E> > const& errors ) noexcept
+{
+    for( auto const& v: errors )
+    {
+        if( !v.empty() ) return true;
+    }
+
+    return false;
+}
+
+} // namespace detail
+
+// parallel_collect( r, f, threads )
+//
+// Returns a result<std::vector<T>, E> holding f( x ) for the elements x of
+// the random access range r, where f returns result<T, E>, or the error at
+// the lowest index. T must be default constructible.
+
+template<class R, class F,
+    class Q = detail::parallel_invoke_result<R, F>,
+    class T = typename detail::is_result<Q>::value_type,
+    class E = typename detail::is_result<Q>::error_type>
+result<std::vector<T>, E> parallel_collect( R const& r, F f, unsigned threads = 0 )
+{
+    detail::parallel_plan plan( static_cast<std::size_t>( std::end( r ) - std::begin( r ) ), threads );
+
+    std::unique_ptr<T[]> v( new T[ plan.n ]() );
+    std::vector< indexed_errors<E> > errors( plan.threads );
+
+    detail::parallel_collect_<true>( r, f, plan, v.get(), errors );
+
+    if( detail::has_errors( errors ) )
+    {
+        return result<std::vector<T>, E>( in_place_error, detail::lowest_error( errors ) );
+    }
+
+    return result<std::vector<T>, E>( in_place_value, detail::move_to_vector( v, plan.n ) );
+}
+
+// parallel_collect_all( r, f, threads )
+//
+// As parallel_collect, but visits every element and returns all errors
+// along with their indices.
+
+template<class R, class F,
+    class Q = detail::parallel_invoke_result<R, F>,
+    class T = typename detail::is_result<Q>::value_type,
+    class E = typename detail::is_result<Q>::error_type>
+result<std::vector<T>, indexed_errors<E>> parallel_collect_all( R const& r, F f, unsigned threads = 0 )
+{
+    detail::parallel_plan plan( static_cast<std::size_t>( std::end( r ) - std::begin( r ) ), threads );
+
+    std::unique_ptr<T[]> v( new T[ plan.n ]() );
+    std::vector< indexed_errors<E> > errors( plan.threads );
+
+    detail::parallel_collect_<false>( r, f, plan, v.get(), errors );
+
+    if( detail::has_errors( errors ) )
+    {
+        return result<std::vector<T>, indexed_errors<E>>( in_place_error, detail::merge_errors( errors ) );
+    }
+
+    return result<std::vector<T>, indexed_errors<E>>( in_place_value, detail::move_to_vector( v, plan.n ) );
+}
+
+// parallel_reduce( r, f, init, op, threads )
+//
+// Returns op( ... op( op( init, v0 ), v1 ) ..., vn ), where vi is the value
+// of f( xi ), or the error at the lowest index. op must be associative,
+// as the chunks are reduced separately before being combined in order.
+// T must be default constructible.
+
+template<class R, class F, class Op,
+    class Q = detail::parallel_invoke_result<R, F>,
+    class T = typename detail::is_result<Q>::value_type,
+    class E = typename detail::is_result<Q>::error_type>
+result<T, E> parallel_reduce( R const& r, F f, typename detail::is_result<Q>::value_type init, Op op, unsigned threads = 0 )
+{
+    detail::parallel_plan plan( static_cast<std::size_t>( std::end( r ) - std::begin( r ) ), threads );
+
+    std::unique_ptr<T[]> partials( new T[ plan.chunks ]() );
+    std::vector< indexed_errors<E> > errors( plan.threads );
+
+    detail::parallel_reduce_<true>( r, f, op, plan, partials.get(), errors );
+
+    if( detail::has_errors( errors ) )
+    {
+        return result<T, E>( in_place_error, detail::lowest_error( errors ) );
+    }
+
+    for( std::size_t c = 0; c < plan.chunks; ++c )
+    {
+        init = op( std::move( init ), std::move( partials[ c ] ) );
+    }
+
+    return result<T, E>( in_place_value, std::move( init ) );
+}
+
+// parallel_reduce_all( r, f, init, op, threads )
+//
+// As parallel_reduce, but visits every element and returns all errors
+// along with their indices.
+
+template<class R, class F, class Op,
+    class Q = detail::parallel_invoke_result<R, F>,
+    class T = typename detail::is_result<Q>::value_type,
+    class E = typename detail::is_result<Q>::error_type>
+result<T, indexed_errors<E>> parallel_reduce_all( R const& r, F f, typename detail::is_result<Q>::value_type init, Op op, unsigned threads = 0 )
+{
+    detail::parallel_plan plan( static_cast<std::size_t>( std::end( r ) - std::begin( r ) ), threads );
+
+    std::unique_ptr<T[]> partials( new T[ plan.chunks ]() );
+    std::vector< indexed_errors<E> > errors( plan.threads );
+
+    detail::parallel_reduce_<false>( r, f, op, plan, partials.get(), errors );
+
+    if( detail::has_errors( errors ) )
+    {
+        return result<T, indexed_errors<E>>( in_place_error, detail::merge_errors( errors ) );
+    }
+
+    for( std::size_t c = 0; c < plan.chunks; ++c )
+    {
+        init = op( std::move( init ), std::move( partials[ c ] ) );
+    }
+
+    return result<T, indexed_errors<E>>( in_place_value, std::move( init ) );
+}
+
+} // namespace result
+} // namespace boost
+
+#endif // #ifndef BOOST_RESULT_PARALLEL_HPP_INCLUDED
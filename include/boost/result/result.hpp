@@ -5,148 +5,1751 @@
 // Distributed under the Boost Software License, Version 1.0.
 // https://www.boost.org/LICENSE_1_0.txt
 
+#include <boost/result/detail/result_storage.hpp>
+#include <boost/result/niche_traits.hpp>
+#include <boost/result/is_trivially_relocatable.hpp>
 #include <boost/variant2/variant.hpp>
 #include <boost/throw_exception.hpp>
 #include <boost/assert.hpp>
 #include <boost/config.hpp>
 #include <system_error>
+#include <exception>
 #include <type_traits>
 #include <utility>
 #include <iosfwd>
 
+#if defined( BOOST_RESULT_ENABLE_ERROR_COUNTERS )
+# include <boost/result/error_counters.hpp>
+#endif
+
+#if defined( BOOST_RESULT_ENABLE_PROBES )
+# include <boost/result/detail/probes.hpp>
+#endif
+
+//
+
+// Source locations
+//
+// When BOOST_RESULT_ENABLE_SOURCE_LOCATION is defined and std::source_location
+// is available, a result records the site at which its error was constructed,
+// by the error constructors, as std::source_location, retrievable with
+// error_location(). std::source_location is a pointer to a static record on
+// libstdc++ and libc++, so this costs a pointer per result. The error site
+// is kept when the error is propagated by BOOST_RESULT_TRY, co_await,
+// and_then, transform and transform_error. Constructing from more than two
+// error arguments, emplace_error and the error assignment leave the site
+// empty.
+//
+// Otherwise, result is not affected in any way.
+
+#if defined( BOOST_RESULT_ENABLE_SOURCE_LOCATION ) && defined( __has_include )
+# if __has_include(<source_location>)
+#  include <source_location>
+#  if defined( __cpp_lib_source_location ) && __cpp_lib_source_location >= 201907L
+#   define BOOST_RESULT_HAS_SOURCE_LOCATION
+#  endif
+# endif
+#endif
+
+#if defined( BOOST_RESULT_HAS_SOURCE_LOCATION )
+
+# define BOOST_RESULT_SITE_PARAM , std::source_location boost_result_site = std::source_location::current()
+# define BOOST_RESULT_IN_PLACE_ERROR_PARAM detail::in_place_error_site boost_result_site
+# define BOOST_RESULT_SITE_INIT( site ) , loc_( site )
+# define BOOST_RESULT_SITE_RESET() loc_ = std::source_location()
+# define BOOST_RESULT_SITE_SWAP( r ) std::swap( loc_, r.loc_ )
+# define BOOST_RESULT_IN_PLACE_ERROR_FROM( r ) detail::in_place_error_site( in_place_error, (r).error_location() )
+
+#else
+
+# define BOOST_RESULT_SITE_PARAM
+# define BOOST_RESULT_IN_PLACE_ERROR_PARAM in_place_error_t
+# define BOOST_RESULT_SITE_INIT( site )
+# define BOOST_RESULT_SITE_RESET() ((void)0)
+# define BOOST_RESULT_SITE_SWAP( r ) ((void)0)
+# define BOOST_RESULT_IN_PLACE_ERROR_FROM( r ) in_place_error
+
+#endif
+
+// Error counters, see error_counters.hpp, and probes, see detail/probes.hpp
+
+#if defined( BOOST_RESULT_ENABLE_ERROR_COUNTERS ) || defined( BOOST_RESULT_HAS_PROBES )
+
+# define BOOST_RESULT_IN_PLACE_ERROR_HOOK detail::in_place_error_hook_t<detail::result_error_hook_fn>()
+# define BOOST_RESULT_ON_ERROR() detail::on_result_error( *detail::get_if<1>( &v_ ), detail::is_error_code_like<E>() );
+# define BOOST_RESULT_PASS_ERROR( R2, r ) R2( detail::propagate_error( std::forward<R>( r ) ) )
+
+#else
+
+# define BOOST_RESULT_IN_PLACE_ERROR_HOOK in_place_error
+# define BOOST_RESULT_ON_ERROR()
+# define BOOST_RESULT_PASS_ERROR( R2, r ) R2( BOOST_RESULT_IN_PLACE_ERROR_FROM( r ), std::forward<R>( r ).error() )
+
+#endif
+
+#if defined( BOOST_COLD )
+# define BOOST_RESULT_COLD BOOST_COLD
+#elif defined( __GNUC__ )
+# define BOOST_RESULT_COLD __attribute__(( cold ))
+#else
+# define BOOST_RESULT_COLD
+#endif
+
+namespace boost
+{
+namespace result
+{
+
+// throw_exception_from_error_code
+
+BOOST_NORETURN BOOST_RESULT_COLD inline void throw_exception_from_error_code( std::error_code const & e )
+{
+    boost::throw_exception( std::system_error( e ) );
+}
+
+// bad_result_access
+
+template<class E> class bad_result_access;
+
+template<> class bad_result_access<void>: public std::exception
+{
+public:
+
+    char const* what() const noexcept
+    {
+        return "bad_result_access";
+    }
+};
+
+template<class E> class bad_result_access: public bad_result_access<void>
+{
+private:
+
+    E e_;
+
+public:
+
+    explicit bad_result_access( E const& e ): e_( e )
+    {
+    }
+
+    E const& error() const noexcept
+    {
+        return e_;
+    }
+};
+
+// throw_exception_from_error
+//
+// Called, unqualified, by value() when the result holds an error, so that
+// overloads for user-defined error types are found by argument dependent
+// lookup. The generic version calls throw_exception_from_error_code( e )
+// when that is valid, and otherwise throws bad_result_access<E>.
+
+BOOST_NORETURN BOOST_RESULT_COLD inline void throw_exception_from_error( std::error_code const & e )
+{
+    boost::throw_exception( std::system_error( e ) );
+}
+
+BOOST_NORETURN BOOST_RESULT_COLD inline void throw_exception_from_error( std::errc const & e )
+{
+    boost::throw_exception( std::system_error( make_error_code( e ) ) );
+}
+
+BOOST_NORETURN BOOST_RESULT_COLD inline void throw_exception_from_error( std::exception_ptr const & p )
+{
+    if( p )
+    {
+        std::rethrow_exception( p );
+    }
+    else
+    {
+        boost::throw_exception( bad_result_access<void>() );
+    }
+}
+
+namespace detail
+{
+
+template<class E, class En = void> struct has_throw_exception_from_error_code: std::false_type
+{
+};
+
+template<class E> struct has_throw_exception_from_error_code<E, decltype( void( throw_exception_from_error_code( std::declval<E const&>() ) ) )>: std::true_type
+{
+};
+
+template<class E> BOOST_NORETURN void throw_bad_result_access( E const& e, std::true_type )
+{
+    boost::throw_exception( bad_result_access<E>( e ) );
+}
+
+template<class E> BOOST_NORETURN void throw_bad_result_access( E const&, std::false_type )
+{
+    boost::throw_exception( bad_result_access<void>() );
+}
+
+template<class E> BOOST_NORETURN void throw_exception_from_error_impl( E const& e, std::true_type )
+{
+    throw_exception_from_error_code( e );
+}
+
+template<class E> BOOST_NORETURN void throw_exception_from_error_impl( E const& e, std::false_type )
+{
+    detail::throw_bad_result_access( e, std::is_copy_constructible<E>() );
+}
+
+} // namespace detail
+
+template<class E> BOOST_NORETURN BOOST_RESULT_COLD inline void throw_exception_from_error( E const & e )
+{
+    detail::throw_exception_from_error_impl( e, detail::has_throw_exception_from_error_code<E>() );
+}
+
+namespace detail
+{
+
+// the error path of value(), kept out of line
+
+template<class E> BOOST_NORETURN BOOST_NOINLINE BOOST_RESULT_COLD void throw_result_error( E const& e )
+{
+#if defined( BOOST_RESULT_HAS_PROBES )
+
+    if( BOOST_RESULT_PROBE_ENABLED( throw ) )
+    {
+        detail::probe_error_impl( detail::probe_throw_tag(), e, 0 );
+    }
+
+#endif
+
+    throw_exception_from_error( e );
+}
+
+#if defined( BOOST_RESULT_ENABLE_ERROR_COUNTERS ) || defined( BOOST_RESULT_HAS_PROBES )
+
+// the errors that are counted and probed: those with category() and value()
+// members, as std::error_code, and the error code enums
+
+template<class E, class En = void> struct is_error_code_like: std::is_error_code_enum<E>
+{
+};
+
+template<class E> struct is_error_code_like<E, decltype( void( std::declval<E const&>().category() ), void( std::declval<E const&>().value() ) )>: std::true_type
+{
+};
+
+// called by the error constructors with the category and the value, rather
+// than with a reference to the error, so that the result doesn't have to be
+// kept in memory
+
+BOOST_NOINLINE BOOST_RESULT_COLD inline void on_result_error_code( std::error_category const& cat, int value ) noexcept
+{
+#if defined( BOOST_RESULT_ENABLE_ERROR_COUNTERS )
+    boost::result::count_error( cat, value );
+#endif
+
+#if defined( BOOST_RESULT_HAS_PROBES )
+
+    if( BOOST_RESULT_PROBE_ENABLED( error ) )
+    {
+        detail::fire_probe( detail::probe_error_tag(), cat, value );
+    }
+
+#endif
+}
+
+template<class E> auto on_result_error_( E const& e, int ) noexcept -> decltype( void( e.category() ), void( e.value() ) )
+{
+    detail::on_result_error_code( e.category(), e.value() );
+}
+
+template<class E> void on_result_error_( E const& e, long ) noexcept
+{
+    std::error_code ec = make_error_code( e );
+    detail::on_result_error_code( ec.category(), ec.value() );
+}
+
+template<class E> constexpr bool on_result_error( E const& e, std::true_type ) noexcept
+{
+#if defined( __cpp_lib_is_constant_evaluated ) && __cpp_lib_is_constant_evaluated >= 201811L
+
+    return std::is_constant_evaluated() || ( detail::on_result_error_( e, 0 ), true );
+
+#else
+
+    return detail::on_result_error_( e, 0 ), true;
+
+#endif
+}
+
+template<class E> constexpr bool on_result_error( E const&, std::false_type ) noexcept
+{
+    return true;
+}
+
+// the hook of the error constructors, called from the member initializer
+// list of the storage
+
+struct result_error_hook_fn
+{
+    template<class E> static constexpr bool on_error( E const& e ) noexcept
+    {
+        return detail::on_result_error( e, is_error_code_like<E>() );
+    }
+};
+
+#endif
+
+} // namespace detail
+
+// in_place_*
+
+using in_place_value_t = variant2::in_place_index_t<0>;
+constexpr in_place_value_t in_place_value{};
+
+using in_place_error_t = variant2::in_place_index_t<1>;
+constexpr in_place_error_t in_place_error{};
+
+#if defined( BOOST_RESULT_HAS_SOURCE_LOCATION )
+
+namespace detail
+{
+
+// in_place_error, along with the site of the call
+
+class in_place_error_site
+{
+private:
+
+    std::source_location loc_;
+
+public:
+
+    constexpr in_place_error_site( in_place_error_t, std::source_location loc = std::source_location::current() ) noexcept: loc_( loc )
+    {
+    }
+
+    constexpr std::source_location location() const noexcept
+    {
+        return loc_;
+    }
+};
+
+} // namespace detail
+
+#endif
+
+// error_converter
+//
+// error_converter<E1, E2>::convert( e ) converts the error e of type E1 to
+// E2, when an error is propagated from a result<T1, E1> to a result<T2, E2>
+// by BOOST_RESULT_TRY. It is called with an rvalue or a const lvalue of E1.
+// The default is E2( e ), when that is valid; specializations can provide
+// other conversions.
+
+template<class E1, class E2, class En = void> struct error_converter
+{
+};
+
+template<class E1, class E2> struct error_converter<E1, E2, typename std::enable_if<
+    std::is_constructible<E2, E1>::value
+    >::type>
+{
+    template<class A> static constexpr E2 convert( A&& a )
+        noexcept( std::is_nothrow_constructible<E2, A>::value )
+    {
+        return E2( std::forward<A>( a ) );
+    }
+};
+
+// propagated_error
 //
+// Refers to the error of a result that is being propagated; a result<T, E>
+// can be constructed from it when error_converter<E1, E> is defined. R is
+// the type of `r.error()` for the result r, a reference.
+
+template<class R> class propagated_error
+{
+private:
+
+    static_assert( std::is_reference<R>::value, "R must be a reference type" );
+
+    R e_;
+
+#if defined( BOOST_RESULT_HAS_SOURCE_LOCATION )
+
+    std::source_location loc_;
+
+public:
+
+    constexpr propagated_error( R e, std::source_location loc ) noexcept: e_( static_cast<R>( e ) ), loc_( loc )
+    {
+    }
+
+    constexpr std::source_location location() const noexcept
+    {
+        return loc_;
+    }
+
+#else
+
+public:
+
+    explicit constexpr propagated_error( R e ) noexcept: e_( static_cast<R>( e ) )
+    {
+    }
+
+#endif
+
+    constexpr R error() const noexcept
+    {
+        return static_cast<R>( e_ );
+    }
+};
+
+namespace detail
+{
+
+template<class R, class E, class E1 = typename std::remove_cv<typename std::remove_reference<R>::type>::type, class En = void>
+struct is_error_convertible: std::false_type
+{
+};
+
+template<class R, class E, class E1> struct is_error_convertible<R, E, E1, decltype( void( error_converter<E1, E>::convert( std::declval<R>() ) ) )>: std::true_type
+{
+};
+
+#if defined( BOOST_RESULT_HAS_SOURCE_LOCATION )
+
+template<class R> constexpr auto propagate_error( R&& r ) noexcept -> propagated_error<decltype( std::forward<R>( r ).error() )>
+{
+    return propagated_error<decltype( std::forward<R>( r ).error() )>( std::forward<R>( r ).error(), r.error_location() );
+}
+
+#else
+
+template<class R> constexpr auto propagate_error( R&& r ) noexcept -> propagated_error<decltype( std::forward<R>( r ).error() )>
+{
+    return propagated_error<decltype( std::forward<R>( r ).error() )>( std::forward<R>( r ).error() );
+}
+
+#endif
+
+} // namespace detail
+
+template<class T, class E = std::error_code> class result;
+
+// helpers for the monadic operations
+
+namespace detail
+{
+
+template<class R> struct is_result: std::false_type
+{
+};
+
+template<class T, class E> struct is_result< result<T, E> >: std::true_type
+{
+    typedef T value_type;
+    typedef E error_type;
+};
+
+template<class R> using remove_cvref = typename std::remove_cv<typename std::remove_reference<R>::type>::type;
+
+template<class R> using result_value_type = typename is_result< remove_cvref<R> >::value_type;
+template<class R> using result_error_type = typename is_result< remove_cvref<R> >::error_type;
+
+// invoke_with_value( f, r ): f( *r ), or f() for result<void, E>
+
+template<class F, class R, class En = typename std::enable_if< !std::is_void< result_value_type<R> >::value >::type>
+BOOST_CXX14_CONSTEXPR auto invoke_with_value( F&& f, R&& r ) -> decltype( std::forward<F>( f )( *std::forward<R>( r ) ) )
+{
+    return std::forward<F>( f )( *std::forward<R>( r ) );
+}
+
+template<class F, class R, class En2 = void, class En = typename std::enable_if< std::is_void< result_value_type<R> >::value >::type>
+BOOST_CXX14_CONSTEXPR auto invoke_with_value( F&& f, R&& ) -> decltype( std::forward<F>( f )() )
+{
+    return std::forward<F>( f )();
+}
+
+template<class F, class R> using value_invoke_result = decltype( detail::invoke_with_value( std::declval<F>(), std::declval<R>() ) );
+template<class F, class R> using error_invoke_result = decltype( std::declval<F>()( std::declval<R>().error() ) );
+
+// result_with_value<R2>( r ): R2 holding the value of r
+
+template<class R2, class R, class En = typename std::enable_if< !std::is_void< result_value_type<R> >::value >::type>
+BOOST_CXX14_CONSTEXPR R2 result_with_value( R&& r )
+{
+    return R2( in_place_value, *std::forward<R>( r ) );
+}
+
+template<class R2, class R, class En2 = void, class En = typename std::enable_if< std::is_void< result_value_type<R> >::value >::type>
+BOOST_CXX14_CONSTEXPR R2 result_with_value( R&& )
+{
+    return R2();
+}
+
+// and_then
+
+template<class R, class F, class R2 = remove_cvref< value_invoke_result<F, R> >>
+BOOST_CXX14_CONSTEXPR R2 result_and_then( R&& r, F&& f )
+{
+    static_assert( is_result<R2>::value, "The function passed to and_then must return a result" );
+
+    if( r.has_value() )
+    {
+        return detail::invoke_with_value( std::forward<F>( f ), std::forward<R>( r ) );
+    }
+    else
+    {
+        return BOOST_RESULT_PASS_ERROR( R2, r );
+    }
+}
+
+// transform
+
+template<class R2, class F, class R>
+BOOST_CXX14_CONSTEXPR R2 result_transform_value( std::false_type, F&& f, R&& r )
+{
+    return R2( in_place_value, detail::invoke_with_value( std::forward<F>( f ), std::forward<R>( r ) ) );
+}
+
+template<class R2, class F, class R>
+BOOST_CXX14_CONSTEXPR R2 result_transform_value( std::true_type, F&& f, R&& r )
+{
+    detail::invoke_with_value( std::forward<F>( f ), std::forward<R>( r ) );
+    return R2();
+}
+
+template<class R, class F, class U = remove_cvref< value_invoke_result<F, R> >, class R2 = result< U, result_error_type<R> >>
+BOOST_CXX14_CONSTEXPR R2 result_transform( R&& r, F&& f )
+{
+    if( r.has_value() )
+    {
+        return detail::result_transform_value<R2>( std::is_void<U>(), std::forward<F>( f ), std::forward<R>( r ) );
+    }
+    else
+    {
+        return BOOST_RESULT_PASS_ERROR( R2, r );
+    }
+}
+
+// or_else
+
+template<class R2, class F, class R>
+BOOST_CXX14_CONSTEXPR R2 result_or_else_error( std::false_type, F&& f, R&& r )
+{
+    return std::forward<F>( f )( std::forward<R>( r ).error() );
+}
+
+template<class R2, class F, class R>
+BOOST_CXX14_CONSTEXPR R2 result_or_else_error( std::true_type, F&& f, R&& r )
+{
+    // the function only observes the error, which is then propagated
+
+    std::forward<F>( f )( r.error() );
+    return R2( std::forward<R>( r ) );
+}
+
+template<class R, class F, class G = remove_cvref< error_invoke_result<F, R> >,
+    class R2 = typename std::conditional< std::is_void<G>::value, remove_cvref<R>, G >::type>
+BOOST_CXX14_CONSTEXPR R2 result_or_else( R&& r, F&& f )
+{
+    static_assert( std::is_void<G>::value || is_result<G>::value, "The function passed to or_else must return a result or void" );
+
+    if( r.has_value() )
+    {
+        return detail::result_with_value<R2>( std::forward<R>( r ) );
+    }
+    else
+    {
+        return detail::result_or_else_error<R2>( std::is_void<G>(), std::forward<F>( f ), std::forward<R>( r ) );
+    }
+}
+
+// transform_error
+
+template<class R, class F, class G = remove_cvref< error_invoke_result<F, R> >, class R2 = result< result_value_type<R>, G >>
+BOOST_CXX14_CONSTEXPR R2 result_transform_error( R&& r, F&& f )
+{
+    if( r.has_value() )
+    {
+        return detail::result_with_value<R2>( std::forward<R>( r ) );
+    }
+    else
+    {
+        return R2( BOOST_RESULT_IN_PLACE_ERROR_FROM( r ), std::forward<F>( f )( std::forward<R>( r ).error() ) );
+    }
+}
+
+// value_or, value_or_else
+
+template<class V, class R, class U>
+BOOST_CXX14_CONSTEXPR V result_value_or( R&& r, U&& u )
+{
+    return r.has_value()? *std::forward<R>( r ): static_cast<V>( std::forward<U>( u ) );
+}
+
+template<class V, class R, class F>
+BOOST_CXX14_CONSTEXPR V result_value_or_else( R&& r, F&& f )
+{
+    return r.has_value()? *std::forward<R>( r ): static_cast<V>( std::forward<F>( f )( std::forward<R>( r ).error() ) );
+}
+
+// result_monadic<R>
+//
+// The monadic member functions of result<T, E>, result<U&, E> and
+// result<void, E>, a base of each, forwarding to the functions above
+//
+// and_then( f ):       f( value ), which returns a result, or the error
+// transform( f ):      result<U, E> holding f( value ), or the error;
+//                      result<void, E> when f returns void
+// or_else( f ):        f( error ), which returns a result, or the value;
+//                      when f returns void, it observes the error and
+//                      the result is returned unchanged
+// transform_error( f ): result<T, G> holding the value, or f( error )
+//
+// f is called without arguments in place of f( value ) for result<void, E>.
+
+template<class R> class result_monadic
+{
+public:
+
+#if defined( BOOST_NO_CXX11_REF_QUALIFIERS )
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto and_then( F&& f )
+        -> decltype( detail::result_and_then( std::declval<R&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_and_then( static_cast<R&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto and_then( F&& f ) const
+        -> decltype( detail::result_and_then( std::declval<R const&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_and_then( static_cast<R const&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto transform( F&& f )
+        -> decltype( detail::result_transform( std::declval<R&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_transform( static_cast<R&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto transform( F&& f ) const
+        -> decltype( detail::result_transform( std::declval<R const&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_transform( static_cast<R const&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto or_else( F&& f )
+        -> decltype( detail::result_or_else( std::declval<R&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_or_else( static_cast<R&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto or_else( F&& f ) const
+        -> decltype( detail::result_or_else( std::declval<R const&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_or_else( static_cast<R const&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto transform_error( F&& f )
+        -> decltype( detail::result_transform_error( std::declval<R&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_transform_error( static_cast<R&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto transform_error( F&& f ) const
+        -> decltype( detail::result_transform_error( std::declval<R const&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_transform_error( static_cast<R const&>( *this ), std::forward<F>( f ) );
+    }
+
+#else
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto and_then( F&& f ) &
+        -> decltype( detail::result_and_then( std::declval<R&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_and_then( static_cast<R&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto and_then( F&& f ) const &
+        -> decltype( detail::result_and_then( std::declval<R const&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_and_then( static_cast<R const&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto and_then( F&& f ) &&
+        -> decltype( detail::result_and_then( std::declval<R&&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_and_then( static_cast<R&&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto and_then( F&& f ) const &&
+        -> decltype( detail::result_and_then( std::declval<R const&&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_and_then( static_cast<R const&&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto transform( F&& f ) &
+        -> decltype( detail::result_transform( std::declval<R&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_transform( static_cast<R&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto transform( F&& f ) const &
+        -> decltype( detail::result_transform( std::declval<R const&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_transform( static_cast<R const&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto transform( F&& f ) &&
+        -> decltype( detail::result_transform( std::declval<R&&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_transform( static_cast<R&&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto transform( F&& f ) const &&
+        -> decltype( detail::result_transform( std::declval<R const&&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_transform( static_cast<R const&&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto or_else( F&& f ) &
+        -> decltype( detail::result_or_else( std::declval<R&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_or_else( static_cast<R&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto or_else( F&& f ) const &
+        -> decltype( detail::result_or_else( std::declval<R const&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_or_else( static_cast<R const&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto or_else( F&& f ) &&
+        -> decltype( detail::result_or_else( std::declval<R&&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_or_else( static_cast<R&&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto or_else( F&& f ) const &&
+        -> decltype( detail::result_or_else( std::declval<R const&&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_or_else( static_cast<R const&&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto transform_error( F&& f ) &
+        -> decltype( detail::result_transform_error( std::declval<R&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_transform_error( static_cast<R&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto transform_error( F&& f ) const &
+        -> decltype( detail::result_transform_error( std::declval<R const&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_transform_error( static_cast<R const&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto transform_error( F&& f ) &&
+        -> decltype( detail::result_transform_error( std::declval<R&&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_transform_error( static_cast<R&&>( *this ), std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR auto transform_error( F&& f ) const &&
+        -> decltype( detail::result_transform_error( std::declval<R const&&>(), std::forward<F>( f ) ) )
+    {
+        return detail::result_transform_error( static_cast<R const&&>( *this ), std::forward<F>( f ) );
+    }
+
+#endif
+};
+
+} // namespace detail
+
+// result
+//
+// When T and E are trivially copy constructible, move constructible, copy
+// assignable, move assignable or destructible, so is result<T, E>. The same
+// holds for result<void, E> and result<U&, E> with respect to E. A trivially
+// copyable result of at most two words is passed and returned in registers.
+
+template<class T, class E> class result: public detail::result_monadic< result<T, E> >
+{
+private:
+
+    detail::result_variant<T, E> v_;
+
+#if defined( BOOST_RESULT_HAS_SOURCE_LOCATION )
+
+    std::source_location loc_;
+
+#endif
+
+public:
+
+    // constructors
+
+    // default
+    template<class En2 = void, class En = typename std::enable_if<
+        std::is_void<En2>::value &&
+        std::is_default_constructible<T>::value
+        >::type>
+    constexpr result()
+        noexcept( std::is_nothrow_default_constructible<T>::value )
+        : v_( in_place_value )
+    {
+    }
+
+    // explicit, value
+    template<class A, class En = typename std::enable_if<
+        std::is_constructible<T, A>::value &&
+        !std::is_convertible<A, T>::value &&
+        !std::is_constructible<E, A>::value
+        >::type>
+    explicit constexpr result( A&& a )
+        noexcept( std::is_nothrow_constructible<T, A>::value )
+        : v_( in_place_value, std::forward<A>(a) )
+    {
+    }
+
+    // explicit, error
+    template<class A, class En2 = void, class En = typename std::enable_if<
+        std::is_constructible<E, A>::value &&
+        !std::is_convertible<A, E>::value &&
+        !std::is_constructible<T, A>::value
+        >::type>
+    explicit constexpr result( A&& a BOOST_RESULT_SITE_PARAM )
+        noexcept( std::is_nothrow_constructible<E, A>::value )
+        : v_( BOOST_RESULT_IN_PLACE_ERROR_HOOK, std::forward<A>(a) ) BOOST_RESULT_SITE_INIT( boost_result_site )
+    {
+    }
+
+    // implicit, value
+    template<class A, class En2 = void, class En3 = void, class En = typename std::enable_if<
+        std::is_convertible<A, T>::value &&
+        !std::is_constructible<E, A>::value
+        >::type>
+    constexpr result( A&& a )
+        noexcept( std::is_nothrow_constructible<T, A>::value )
+        : v_( in_place_value, std::forward<A>(a) )
+    {
+    }
+
+    // implicit, error
+    template<class A, class En2 = void, class En3 = void, class En4 = void, class En = typename std::enable_if<
+        std::is_convertible<A, E>::value &&
+        !std::is_constructible<T, A>::value
+        >::type>
+    constexpr result( A&& a BOOST_RESULT_SITE_PARAM )
+        noexcept( std::is_nothrow_constructible<E, A>::value )
+        : v_( BOOST_RESULT_IN_PLACE_ERROR_HOOK, std::forward<A>(a) ) BOOST_RESULT_SITE_INIT( boost_result_site )
+    {
+    }
+
+    // more than one arg, value
+    template<class... A, class En = typename std::enable_if<
+        std::is_constructible<T, A...>::value &&
+        !std::is_constructible<E, A...>::value &&
+        sizeof...(A) >= 2
+        >::type>
+    constexpr result( A&&... a )
+        noexcept( std::is_nothrow_constructible<T, A...>::value )
+        : v_( in_place_value, std::forward<A>(a)... )
+    {
+    }
+
+    // more than one arg, error
+    template<class... A, class En2 = void, class En = typename std::enable_if<
+        !std::is_constructible<T, A...>::value &&
+        std::is_constructible<E, A...>::value &&
+        sizeof...(A) >= 2
+        >::type>
+    constexpr result( A&&... a )
+        noexcept( std::is_nothrow_constructible<E, A...>::value )
+        : v_( BOOST_RESULT_IN_PLACE_ERROR_HOOK, std::forward<A>(a)... )
+    {
+    }
+
+#if defined( BOOST_RESULT_HAS_SOURCE_LOCATION )
+
+    // two args, error; preferred to the above, as it records the site
+    template<class A1, class A2, class En2 = void, class En = typename std::enable_if<
+        !std::is_constructible<T, A1, A2>::value &&
+        std::is_constructible<E, A1, A2>::value
+        >::type>
+    constexpr result( A1&& a1, A2&& a2 BOOST_RESULT_SITE_PARAM )
+        noexcept( std::is_nothrow_constructible<E, A1, A2>::value )
+        : v_( BOOST_RESULT_IN_PLACE_ERROR_HOOK, std::forward<A1>(a1), std::forward<A2>(a2) ) BOOST_RESULT_SITE_INIT( boost_result_site )
+    {
+    }
+
+#endif
+
+    // tagged, value
+    template<class... A, class En = typename std::enable_if<
+        std::is_constructible<T, A...>::value
+        >::type>
+    constexpr result( in_place_value_t, A&&... a )
+        noexcept( std::is_nothrow_constructible<T, A...>::value )
+        : v_( in_place_value, std::forward<A>(a)... )
+    {
+    }
+
+    // tagged, error
+    template<class... A, class En = typename std::enable_if<
+        std::is_constructible<E, A...>::value
+        >::type>
+    constexpr result( BOOST_RESULT_IN_PLACE_ERROR_PARAM, A&&... a )
+        noexcept( std::is_nothrow_constructible<E, A...>::value )
+        : v_( BOOST_RESULT_IN_PLACE_ERROR_HOOK, std::forward<A>(a)... ) BOOST_RESULT_SITE_INIT( boost_result_site.location() )
+    {
+    }
+
+    // propagated error; out of line, as it's on the error path
+    template<class R, class En = typename std::enable_if<
+        detail::is_error_convertible<R, E>::value
+        >::type>
+    BOOST_NOINLINE BOOST_RESULT_COLD result( propagated_error<R> e )
+        : v_( in_place_error, error_converter<typename std::remove_cv<typename std::remove_reference<R>::type>::type, E>::convert( e.error() ) ) BOOST_RESULT_SITE_INIT( e.location() )
+    {
+    }
+
+    // converting assignment
+    //
+    // When the alternative being assigned is active, the new value is
+    // assigned to it, which keeps e.g. the capacity of a std::string or
+    // std::vector; otherwise it replaces the active alternative
+
+    // value
+    template<class A, class En = typename std::enable_if<
+        !std::is_same<detail::remove_cvref<A>, result>::value &&
+        std::is_convertible<A, T>::value &&
+        !std::is_constructible<E, A>::value
+        >::type>
+    result& operator=( A&& a )
+    {
+        v_.template assign<0>( std::forward<A>(a) );
+        return *this;
+    }
+
+    // error
+    template<class A, class En2 = void, class En = typename std::enable_if<
+        !std::is_same<detail::remove_cvref<A>, result>::value &&
+        std::is_convertible<A, E>::value &&
+        !std::is_constructible<T, A>::value
+        >::type>
+    result& operator=( A&& a )
+    {
+        v_.template assign<1>( std::forward<A>(a) );
+        BOOST_RESULT_SITE_RESET();
+        BOOST_RESULT_ON_ERROR()
+
+        return *this;
+    }
+
+    // emplace
+    //
+    // As above, a single argument is assigned to the active alternative of
+    // the same kind; in all other cases the active alternative is replaced
+
+    template<class... A, class En = typename std::enable_if<
+        std::is_constructible<T, A...>::value
+        >::type>
+    T& emplace_value( A&&... a )
+    {
+        v_.template assign<0>( std::forward<A>(a)... );
+        return *detail::get_if<0>( &v_ );
+    }
+
+    template<class... A, class En = typename std::enable_if<
+        std::is_constructible<E, A...>::value
+        >::type>
+    E& emplace_error( A&&... a )
+    {
+        v_.template assign<1>( std::forward<A>(a)... );
+        BOOST_RESULT_SITE_RESET();
+        BOOST_RESULT_ON_ERROR()
+
+        return *detail::get_if<1>( &v_ );
+    }
+
+    // queries
+
+    constexpr bool has_value() const noexcept
+    {
+        return v_.index() == 0;
+    }
+
+    constexpr bool has_error() const noexcept
+    {
+        return v_.index() != 0;
+    }
+
+#if defined( BOOST_RESULT_HAS_SOURCE_LOCATION )
+
+    // the site at which the error was constructed, when known
+    constexpr std::source_location error_location() const noexcept
+    {
+        return loc_;
+    }
+
+#endif
+
+    constexpr explicit operator bool() const noexcept
+    {
+        return v_.index() == 0;
+    }
+
+    // checked value access
+#if defined( BOOST_NO_CXX11_REF_QUALIFIERS )
+
+    BOOST_CXX14_CONSTEXPR T value() const
+    {
+        if( has_value() )
+        {
+            return *detail::get_if<0>( &v_ );
+        }
+        else
+        {
+            detail::throw_result_error( *detail::get_if<1>( &v_ ) );
+        }
+    }
+
+#else
+
+    BOOST_CXX14_CONSTEXPR T& value() &
+    {
+        if( has_value() )
+        {
+            return *detail::get_if<0>( &v_ );
+        }
+        else
+        {
+            detail::throw_result_error( *detail::get_if<1>( &v_ ) );
+        }
+    }
+
+    BOOST_CXX14_CONSTEXPR T const& value() const&
+    {
+        if( has_value() )
+        {
+            return *detail::get_if<0>( &v_ );
+        }
+        else
+        {
+            detail::throw_result_error( *detail::get_if<1>( &v_ ) );
+        }
+    }
+
+    BOOST_CXX14_CONSTEXPR T&& value() &&
+    {
+        return std::move( value() );
+    }
+
+    BOOST_CXX14_CONSTEXPR T const&& value() const&&
+    {
+        return std::move( value() );
+    }
+
+#endif
+
+    // unchecked value access
+
+    BOOST_CXX14_CONSTEXPR T* operator->() noexcept
+    {
+        return detail::get_if<0>( &v_ );
+    }
+
+    BOOST_CXX14_CONSTEXPR T const* operator->() const noexcept
+    {
+        return detail::get_if<0>( &v_ );
+    }
+
+#if defined( BOOST_NO_CXX11_REF_QUALIFIERS )
+
+    BOOST_CXX14_CONSTEXPR T& operator*() noexcept
+    {
+        T* p = operator->();
+
+        BOOST_ASSERT( p != 0 );
+
+        return *p;
+    }
+
+    BOOST_CXX14_CONSTEXPR T const& operator*() const noexcept
+    {
+        T const* p = operator->();
+
+        BOOST_ASSERT( p != 0 );
+
+        return *p;
+    }
+
+#else
+
+    BOOST_CXX14_CONSTEXPR T& operator*() & noexcept
+    {
+        T* p = operator->();
+
+        BOOST_ASSERT( p != 0 );
+
+        return *p;
+    }
+
+    BOOST_CXX14_CONSTEXPR T const& operator*() const & noexcept
+    {
+        T const* p = operator->();
+
+        BOOST_ASSERT( p != 0 );
+
+        return *p;
+    }
+
+    BOOST_CXX14_CONSTEXPR T&& operator*() && noexcept
+    {
+        return std::move(**this);
+    }
+
+    BOOST_CXX14_CONSTEXPR T const&& operator*() const && noexcept
+    {
+        return std::move(**this);
+    }
+
+#endif
+
+    // error access
+
+#if defined( BOOST_NO_CXX11_REF_QUALIFIERS )
+
+    BOOST_CXX14_CONSTEXPR E& error() noexcept
+    {
+        E* p = detail::get_if<1>( &v_ );
+
+        BOOST_ASSERT( p != 0 );
+
+        return *p;
+    }
+
+    BOOST_CXX14_CONSTEXPR E const& error() const noexcept
+    {
+        E const* p = detail::get_if<1>( &v_ );
+
+        BOOST_ASSERT( p != 0 );
+
+        return *p;
+    }
+
+#else
+
+    BOOST_CXX14_CONSTEXPR E& error() & noexcept
+    {
+        E* p = detail::get_if<1>( &v_ );
+
+        BOOST_ASSERT( p != 0 );
+
+        return *p;
+    }
+
+    BOOST_CXX14_CONSTEXPR E const& error() const & noexcept
+    {
+        E const* p = detail::get_if<1>( &v_ );
+
+        BOOST_ASSERT( p != 0 );
+
+        return *p;
+    }
+
+    BOOST_CXX14_CONSTEXPR E&& error() && noexcept
+    {
+        return std::move( error() );
+    }
+
+    BOOST_CXX14_CONSTEXPR E const&& error() const && noexcept
+    {
+        return std::move( error() );
+    }
+
+#endif
+
+    // the error, or a default constructed E when there is none
+
+    BOOST_CXX14_CONSTEXPR E error_or_default() const
+        noexcept( std::is_nothrow_default_constructible<E>::value && std::is_nothrow_copy_constructible<E>::value )
+    {
+        E const * p = detail::get_if<1>( &v_ );
+        return p? *p: E();
+    }
+
+    // value or fallback
+
+#if defined( BOOST_NO_CXX11_REF_QUALIFIERS )
+
+    template<class U> BOOST_CXX14_CONSTEXPR T value_or( U&& u ) const
+    {
+        return detail::result_value_or<T>( *this, std::forward<U>( u ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR T value_or_else( F&& f ) const
+    {
+        return detail::result_value_or_else<T>( *this, std::forward<F>( f ) );
+    }
+
+#else
+
+    template<class U> BOOST_CXX14_CONSTEXPR T value_or( U&& u ) const &
+    {
+        return detail::result_value_or<T>( *this, std::forward<U>( u ) );
+    }
+
+    template<class U> BOOST_CXX14_CONSTEXPR T value_or( U&& u ) &&
+    {
+        return detail::result_value_or<T>( std::move( *this ), std::forward<U>( u ) );
+    }
+
+    // f( error ) is only called when there is no value
+
+    template<class F> BOOST_CXX14_CONSTEXPR T value_or_else( F&& f ) const &
+    {
+        return detail::result_value_or_else<T>( *this, std::forward<F>( f ) );
+    }
+
+    template<class F> BOOST_CXX14_CONSTEXPR T value_or_else( F&& f ) &&
+    {
+        return detail::result_value_or_else<T>( std::move( *this ), std::forward<F>( f ) );
+    }
+
+#endif
+
+    // swap
+
+    BOOST_CXX14_CONSTEXPR void swap( result& r )
+        noexcept( noexcept( v_.swap( r.v_ ) ) )
+    {
+        v_.swap( r.v_ );
+        BOOST_RESULT_SITE_SWAP( r );
+    }
+
+    friend BOOST_CXX14_CONSTEXPR void swap( result & r1, result & r2 )
+        noexcept( noexcept( r1.swap( r2 ) ) )
+    {
+        r1.swap( r2 );
+    }
+
+    // equality
+
+    friend constexpr bool operator==( result const & r1, result const & r2 )
+        noexcept( noexcept( r1.v_ == r2.v_ ) )
+    {
+        return r1.v_ == r2.v_;
+    }
+
+    friend constexpr bool operator!=( result const & r1, result const & r2 )
+        noexcept( noexcept( !( r1 == r2 ) ) )
+    {
+        return !( r1 == r2 );
+    }
+};
+
+template<class Ch, class Tr, class T, class E> std::basic_ostream<Ch, Tr>& operator<<( std::basic_ostream<Ch, Tr>& os, result<T, E> const & r )
+{
+    if( r.has_value() )
+    {
+        os << "value:" << *r;
+    }
+    else
+    {
+        os << "error:" << r.error();
+    }
+
+    return os;
+}
+
+// result<U&, E>
+
+namespace detail
+{
+
+template<class U, class A> struct reference_to_temporary: std::integral_constant<bool,
+    !std::is_reference<A>::value ||
+    !std::is_convertible<typename std::remove_reference<A>::type*, U*>::value
+> {};
+
+} // namespace detail
+
+template<class U, class E> class result<U&, E>: public detail::result_monadic< result<U&, E> >
+{
+private:
+
+    detail::result_variant<U*, E> v_;
+
+#if defined( BOOST_RESULT_HAS_SOURCE_LOCATION )
+
+    std::source_location loc_;
+
+#endif
+
+public:
+
+    // constructors
+
+    // explicit, value
+    template<class A, class En = typename std::enable_if<
+        std::is_constructible<U&, A>::value &&
+        !std::is_convertible<A, U&>::value &&
+        !detail::reference_to_temporary<U, A>::value &&
+        !std::is_constructible<E, A>::value
+        >::type>
+    explicit constexpr result( A&& a )
+        noexcept( std::is_nothrow_constructible<U&, A>::value )
+        : v_( in_place_value, &static_cast<U&>( a ) )
+    {
+    }
+
+    // explicit, error
+    template<class A, class En2 = void, class En = typename std::enable_if<
+        std::is_constructible<E, A>::value &&
+        !std::is_convertible<A, E>::value &&
+        !std::is_constructible<U&, A>::value
+        >::type>
+    explicit constexpr result( A&& a BOOST_RESULT_SITE_PARAM )
+        noexcept( std::is_nothrow_constructible<E, A>::value )
+        : v_( BOOST_RESULT_IN_PLACE_ERROR_HOOK, std::forward<A>(a) ) BOOST_RESULT_SITE_INIT( boost_result_site )
+    {
+    }
+
+    // implicit, value
+    template<class A, class En2 = void, class En3 = void, class En = typename std::enable_if<
+        std::is_convertible<A, U&>::value &&
+        !detail::reference_to_temporary<U, A>::value &&
+        !std::is_constructible<E, A>::value
+        >::type>
+    constexpr result( A&& a )
+        noexcept( std::is_nothrow_constructible<U&, A>::value )
+        : v_( in_place_value, &static_cast<U&>( a ) )
+    {
+    }
+
+    // implicit, error
+    template<class A, class En2 = void, class En3 = void, class En4 = void, class En = typename std::enable_if<
+        std::is_convertible<A, E>::value &&
+        !std::is_constructible<U&, A>::value
+        >::type>
+    constexpr result( A&& a BOOST_RESULT_SITE_PARAM )
+        noexcept( std::is_nothrow_constructible<E, A>::value )
+        : v_( BOOST_RESULT_IN_PLACE_ERROR_HOOK, std::forward<A>(a) ) BOOST_RESULT_SITE_INIT( boost_result_site )
+    {
+    }
+
+    // more than one arg, error
+    template<class... A, class En = typename std::enable_if<
+        std::is_constructible<E, A...>::value &&
+        sizeof...(A) >= 2
+        >::type>
+    constexpr result( A&&... a )
+        noexcept( std::is_nothrow_constructible<E, A...>::value )
+        : v_( BOOST_RESULT_IN_PLACE_ERROR_HOOK, std::forward<A>(a)... )
+    {
+    }
+
+#if defined( BOOST_RESULT_HAS_SOURCE_LOCATION )
+
+    // two args, error; preferred to the above, as it records the site
+    template<class A1, class A2, class En = typename std::enable_if<
+        std::is_constructible<E, A1, A2>::value
+        >::type>
+    constexpr result( A1&& a1, A2&& a2 BOOST_RESULT_SITE_PARAM )
+        noexcept( std::is_nothrow_constructible<E, A1, A2>::value )
+        : v_( BOOST_RESULT_IN_PLACE_ERROR_HOOK, std::forward<A1>(a1), std::forward<A2>(a2) ) BOOST_RESULT_SITE_INIT( boost_result_site )
+    {
+    }
+
+#endif
+
+    // tagged, value
+    template<class A, class En = typename std::enable_if<
+        std::is_constructible<U&, A>::value &&
+        !detail::reference_to_temporary<U, A>::value
+        >::type>
+    constexpr result( in_place_value_t, A&& a )
+        noexcept( std::is_nothrow_constructible<U&, A>::value )
+        : v_( in_place_value, &static_cast<U&>( a ) )
+    {
+    }
+
+    // tagged, error
+    template<class... A, class En = typename std::enable_if<
+        std::is_constructible<E, A...>::value
+        >::type>
+    constexpr result( BOOST_RESULT_IN_PLACE_ERROR_PARAM, A&&... a )
+        noexcept( std::is_nothrow_constructible<E, A...>::value )
+        : v_( BOOST_RESULT_IN_PLACE_ERROR_HOOK, std::forward<A>(a)... ) BOOST_RESULT_SITE_INIT( boost_result_site.location() )
+    {
+    }
+
+    // propagated error; out of line, as it's on the error path
+    template<class R, class En = typename std::enable_if<
+        detail::is_error_convertible<R, E>::value
+        >::type>
+    BOOST_NOINLINE BOOST_RESULT_COLD result( propagated_error<R> e )
+        : v_( in_place_error, error_converter<typename std::remove_cv<typename std::remove_reference<R>::type>::type, E>::convert( e.error() ) ) BOOST_RESULT_SITE_INIT( e.location() )
+    {
+    }
+
+    // converting assignment
+    //
+    // Assigning a U& rebinds the reference. When the error is active,
+    // assigning an error assigns to it; otherwise it replaces the value
+
+    // value
+    template<class A, class En = typename std::enable_if<
+        !std::is_same<detail::remove_cvref<A>, result>::value &&
+        std::is_convertible<A, U&>::value &&
+        !detail::reference_to_temporary<U, A>::value &&
+        !std::is_constructible<E, A>::value
+        >::type>
+    result& operator=( A&& a )
+    {
+        v_.template assign<0>( &static_cast<U&>( a ) );
+        return *this;
+    }
+
+    // error
+    template<class A, class En2 = void, class En = typename std::enable_if<
+        !std::is_same<detail::remove_cvref<A>, result>::value &&
+        std::is_convertible<A, E>::value &&
+        !std::is_constructible<U&, A>::value
+        >::type>
+    result& operator=( A&& a )
+    {
+        v_.template assign<1>( std::forward<A>(a) );
+        BOOST_RESULT_SITE_RESET();
+        BOOST_RESULT_ON_ERROR()
+
+        return *this;
+    }
+
+    // emplace
+
+    template<class A, class En = typename std::enable_if<
+        std::is_constructible<U&, A>::value &&
+        !detail::reference_to_temporary<U, A>::value
+        >::type>
+    U& emplace_value( A&& a )
+    {
+        v_.template assign<0>( &static_cast<U&>( a ) );
+        return *this->operator->();
+    }
+
+    template<class... A, class En = typename std::enable_if<
+        std::is_constructible<E, A...>::value
+        >::type>
+    E& emplace_error( A&&... a )
+    {
+        v_.template assign<1>( std::forward<A>(a)... );
+        BOOST_RESULT_SITE_RESET();
+        BOOST_RESULT_ON_ERROR()
+
+        return *detail::get_if<1>( &v_ );
+    }
+
+    // queries
+
+    constexpr bool has_value() const noexcept
+    {
+        return v_.index() == 0;
+    }
+
+    constexpr bool has_error() const noexcept
+    {
+        return v_.index() != 0;
+    }
+
+#if defined( BOOST_RESULT_HAS_SOURCE_LOCATION )
+
+    // the site at which the error was constructed, when known
+    constexpr std::source_location error_location() const noexcept
+    {
+        return loc_;
+    }
+
+#endif
+
+    constexpr explicit operator bool() const noexcept
+    {
+        return v_.index() == 0;
+    }
+
+    // checked value access
+
+    BOOST_CXX14_CONSTEXPR U& value() const
+    {
+        if( has_value() )
+        {
+            return **detail::get_if<0>( &v_ );
+        }
+        else
+        {
+            detail::throw_result_error( *detail::get_if<1>( &v_ ) );
+        }
+    }
+
+    // unchecked value access
+
+    BOOST_CXX14_CONSTEXPR U* operator->() const noexcept
+    {
+        return has_value()? *detail::get_if<0>( &v_ ): 0;
+    }
+
+    BOOST_CXX14_CONSTEXPR U& operator*() const noexcept
+    {
+        U* p = operator->();
+
+        BOOST_ASSERT( p != 0 );
+
+        return *p;
+    }
+
+    // error access
+
+#if defined( BOOST_NO_CXX11_REF_QUALIFIERS )
+
+    BOOST_CXX14_CONSTEXPR E& error() noexcept
+    {
+        E* p = detail::get_if<1>( &v_ );
+
+        BOOST_ASSERT( p != 0 );
+
+        return *p;
+    }
+
+    BOOST_CXX14_CONSTEXPR E const& error() const noexcept
+    {
+        E const* p = detail::get_if<1>( &v_ );
+
+        BOOST_ASSERT( p != 0 );
+
+        return *p;
+    }
 
-namespace boost
-{
-namespace result
-{
+#else
 
-// throw_exception_from_error_code
+    BOOST_CXX14_CONSTEXPR E& error() & noexcept
+    {
+        E* p = detail::get_if<1>( &v_ );
 
-BOOST_NORETURN void throw_exception_from_error_code( std::error_code const & e )
-{
-    boost::throw_exception( std::system_error( e ) );
-}
+        BOOST_ASSERT( p != 0 );
 
-// in_place_*
+        return *p;
+    }
 
-using in_place_value_t = variant2::in_place_index_t<0>;
-constexpr in_place_value_t in_place_value{};
+    BOOST_CXX14_CONSTEXPR E const& error() const & noexcept
+    {
+        E const* p = detail::get_if<1>( &v_ );
 
-using in_place_error_t = variant2::in_place_index_t<1>;
-constexpr in_place_error_t in_place_error{};
+        BOOST_ASSERT( p != 0 );
 
-// result
+        return *p;
+    }
+
+    BOOST_CXX14_CONSTEXPR E&& error() && noexcept
+    {
+        return std::move( error() );
+    }
+
+    BOOST_CXX14_CONSTEXPR E const&& error() const && noexcept
+    {
+        return std::move( error() );
+    }
+
+#endif
+
+    // the error, or a default constructed E when there is none
+
+    BOOST_CXX14_CONSTEXPR E error_or_default() const
+        noexcept( std::is_nothrow_default_constructible<E>::value && std::is_nothrow_copy_constructible<E>::value )
+    {
+        E const * p = detail::get_if<1>( &v_ );
+        return p? *p: E();
+    }
+
+    // value or fallback
+
+    BOOST_CXX14_CONSTEXPR U& value_or( U& u ) const noexcept
+    {
+        return detail::result_value_or<U&>( *this, u );
+    }
+
+    // f( error ) is only called when there is no value
+
+    template<class F> BOOST_CXX14_CONSTEXPR U& value_or_else( F&& f ) const
+    {
+        return detail::result_value_or_else<U&>( *this, std::forward<F>( f ) );
+    }
+
+    // swap
+
+    BOOST_CXX14_CONSTEXPR void swap( result& r )
+        noexcept( noexcept( v_.swap( r.v_ ) ) )
+    {
+        v_.swap( r.v_ );
+        BOOST_RESULT_SITE_SWAP( r );
+    }
+
+    friend BOOST_CXX14_CONSTEXPR void swap( result & r1, result & r2 )
+        noexcept( noexcept( r1.swap( r2 ) ) )
+    {
+        r1.swap( r2 );
+    }
+
+    // equality
+
+    friend constexpr bool operator==( result const & r1, result const & r2 )
+        noexcept( noexcept( *r1 == *r2 ) && noexcept( r1.v_ == r2.v_ ) )
+    {
+        return r1 && r2? *r1 == *r2: r1.v_ == r2.v_;
+    }
+
+    friend constexpr bool operator!=( result const & r1, result const & r2 )
+        noexcept( noexcept( !( r1 == r2 ) ) )
+    {
+        return !( r1 == r2 );
+    }
+};
 
-template<class T, class E = std::error_code> class result
+// result<void, E>
+
+template<class E> class result<void, E>: public detail::result_monadic< result<void, E> >
 {
 private:
 
-    variant2::variant<T, E> v_;
+    detail::result_variant<variant2::monostate, E> v_;
+
+#if defined( BOOST_RESULT_HAS_SOURCE_LOCATION )
+
+    std::source_location loc_;
+
+#endif
 
 public:
 
     // constructors
 
     // default
-    template<class En2 = void, class En = typename std::enable_if<
-        std::is_void<En2>::value &&
-        std::is_default_constructible<T>::value
-        >::type>
-    constexpr result()
-        noexcept( std::is_nothrow_default_constructible<T>::value )
+    constexpr result() noexcept
         : v_( in_place_value )
     {
     }
 
-    // explicit, value
+    // explicit, error
     template<class A, class En = typename std::enable_if<
-        std::is_constructible<T, A>::value &&
-        !std::is_convertible<A, T>::value &&
-        !std::is_constructible<E, A>::value
+        std::is_constructible<E, A>::value &&
+        !std::is_convertible<A, E>::value
         >::type>
-    explicit constexpr result( A&& a )
-        noexcept( std::is_nothrow_constructible<T, A>::value )
-        : v_( in_place_value, std::forward<A>(a) )
+    explicit constexpr result( A&& a BOOST_RESULT_SITE_PARAM )
+        noexcept( std::is_nothrow_constructible<E, A>::value )
+        : v_( BOOST_RESULT_IN_PLACE_ERROR_HOOK, std::forward<A>(a) ) BOOST_RESULT_SITE_INIT( boost_result_site )
     {
     }
 
-    // explicit, error
+    // implicit, error
     template<class A, class En2 = void, class En = typename std::enable_if<
-        std::is_constructible<E, A>::value &&
-        !std::is_convertible<A, E>::value &&
-        !std::is_constructible<T, A>::value
+        std::is_convertible<A, E>::value
         >::type>
-    explicit constexpr result( A&& a )
+    constexpr result( A&& a BOOST_RESULT_SITE_PARAM )
         noexcept( std::is_nothrow_constructible<E, A>::value )
-        : v_( in_place_error, std::forward<A>(a) )
+        : v_( BOOST_RESULT_IN_PLACE_ERROR_HOOK, std::forward<A>(a) ) BOOST_RESULT_SITE_INIT( boost_result_site )
     {
     }
 
-    // implicit, value
-    template<class A, class En2 = void, class En3 = void, class En = typename std::enable_if<
-        std::is_convertible<A, T>::value &&
-        !std::is_constructible<E, A>::value
+    // more than one arg, error
+    template<class... A, class En = typename std::enable_if<
+        std::is_constructible<E, A...>::value &&
+        sizeof...(A) >= 2
         >::type>
-    constexpr result( A&& a )
-        noexcept( std::is_nothrow_constructible<T, A>::value )
-        : v_( in_place_value, std::forward<A>(a) )
+    constexpr result( A&&... a )
+        noexcept( std::is_nothrow_constructible<E, A...>::value )
+        : v_( BOOST_RESULT_IN_PLACE_ERROR_HOOK, std::forward<A>(a)... )
     {
     }
 
-    // implicit, error
-    template<class A, class En2 = void, class En3 = void, class En4 = void, class En = typename std::enable_if<
-        std::is_convertible<A, E>::value &&
-        !std::is_constructible<T, A>::value
+#if defined( BOOST_RESULT_HAS_SOURCE_LOCATION )
+
+    // two args, error; preferred to the above, as it records the site
+    template<class A1, class A2, class En = typename std::enable_if<
+        std::is_constructible<E, A1, A2>::value
         >::type>
-    constexpr result( A&& a )
-        noexcept( std::is_nothrow_constructible<E, A>::value )
-        : v_( in_place_error, std::forward<A>(a) )
+    constexpr result( A1&& a1, A2&& a2 BOOST_RESULT_SITE_PARAM )
+        noexcept( std::is_nothrow_constructible<E, A1, A2>::value )
+        : v_( BOOST_RESULT_IN_PLACE_ERROR_HOOK, std::forward<A1>(a1), std::forward<A2>(a2) ) BOOST_RESULT_SITE_INIT( boost_result_site )
     {
     }
 
-    // more than one arg, value
+#endif
+
+    // tagged, value
+    constexpr result( in_place_value_t ) noexcept
+        : v_( in_place_value )
+    {
+    }
+
+    // tagged, error
     template<class... A, class En = typename std::enable_if<
-        std::is_constructible<T, A...>::value &&
-        !std::is_constructible<E, A...>::value &&
-        sizeof...(A) >= 2
+        std::is_constructible<E, A...>::value
         >::type>
-    constexpr result( A&&... a )
-        noexcept( std::is_nothrow_constructible<T, A...>::value )
-        : v_( in_place_value, std::forward<A>(a)... )
+    constexpr result( BOOST_RESULT_IN_PLACE_ERROR_PARAM, A&&... a )
+        noexcept( std::is_nothrow_constructible<E, A...>::value )
+        : v_( BOOST_RESULT_IN_PLACE_ERROR_HOOK, std::forward<A>(a)... ) BOOST_RESULT_SITE_INIT( boost_result_site.location() )
     {
     }
 
-    // more than one arg, error
-    template<class... A, class En2 = void, class En = typename std::enable_if<
-        !std::is_constructible<T, A...>::value &&
-        std::is_constructible<E, A...>::value &&
-        sizeof...(A) >= 2
+    // propagated error; out of line, as it's on the error path
+    template<class R, class En = typename std::enable_if<
+        detail::is_error_convertible<R, E>::value
         >::type>
-    constexpr result( A&&... a )
-        noexcept( std::is_nothrow_constructible<E, A...>::value )
-        : v_( in_place_error, std::forward<A>(a)... )
+    BOOST_NOINLINE BOOST_RESULT_COLD result( propagated_error<R> e )
+        : v_( in_place_error, error_converter<typename std::remove_cv<typename std::remove_reference<R>::type>::type, E>::convert( e.error() ) ) BOOST_RESULT_SITE_INIT( e.location() )
     {
     }
 
-    // tagged, value
-    template<class... A, class En = typename std::enable_if<
-        std::is_constructible<T, A...>::value
+    // converting assignment
+    //
+    // When the error is active, assigning an error assigns to it, which
+    // keeps the resources it owns; otherwise it replaces the value
+
+    // error
+    template<class A, class En = typename std::enable_if<
+        !std::is_same<detail::remove_cvref<A>, result>::value &&
+        std::is_convertible<A, E>::value
         >::type>
-    constexpr result( in_place_value_t, A&&... a )
-        noexcept( std::is_nothrow_constructible<T, A...>::value )
-        : v_( in_place_value, std::forward<A>(a)... )
+    result& operator=( A&& a )
     {
+        v_.template assign<1>( std::forward<A>(a) );
+        BOOST_RESULT_SITE_RESET();
+        BOOST_RESULT_ON_ERROR()
+
+        return *this;
+    }
+
+    // emplace
+
+    void emplace_value()
+    {
+        v_.template assign<0>();
     }
 
-    // tagged, error
     template<class... A, class En = typename std::enable_if<
         std::is_constructible<E, A...>::value
         >::type>
-    constexpr result( in_place_error_t, A&&... a )
-        noexcept( std::is_nothrow_constructible<E, A...>::value )
-        : v_( in_place_error, std::forward<A>(a)... )
+    E& emplace_error( A&&... a )
     {
+        v_.template assign<1>( std::forward<A>(a)... );
+        BOOST_RESULT_SITE_RESET();
+        BOOST_RESULT_ON_ERROR()
+
+        return *detail::get_if<1>( &v_ );
     }
 
     // queries
@@ -161,90 +1764,64 @@ public:
         return v_.index() != 0;
     }
 
-    constexpr explicit operator bool() const noexcept
+#if defined( BOOST_RESULT_HAS_SOURCE_LOCATION )
+
+    // the site at which the error was constructed, when known
+    constexpr std::source_location error_location() const noexcept
     {
-        return v_.index() == 0;
+        return loc_;
     }
 
-    // checked value access
-#if defined( BOOST_NO_CXX11_REF_QUALIFIERS )
+#endif
 
-    BOOST_CXX14_CONSTEXPR T value() const
+    constexpr explicit operator bool() const noexcept
     {
-        if( has_value() )
-        {
-            return *variant2::get_if<0>( &v_ );
-        }
-        else
-        {
-            throw_exception_from_error_code( *variant2::get_if<1>( &v_ ) );
-        }
+        return v_.index() == 0;
     }
 
-#else
+    // checked value access
 
-    BOOST_CXX14_CONSTEXPR T& value() &
+    BOOST_CXX14_CONSTEXPR void value() const
     {
-        if( has_value() )
+        if( !has_value() )
         {
-            return *variant2::get_if<0>( &v_ );
-        }
-        else
-        {
-            throw_exception_from_error_code( *variant2::get_if<1>( &v_ ) );
+            detail::throw_result_error( *detail::get_if<1>( &v_ ) );
         }
     }
 
-    BOOST_CXX14_CONSTEXPR T const& value() const&
-    {
-        if( has_value() )
-        {
-            return *variant2::get_if<0>( &v_ );
-        }
-        else
-        {
-            throw_exception_from_error_code( *variant2::get_if<1>( &v_ ) );
-        }
-    }
+    // unchecked value access
 
-    BOOST_CXX14_CONSTEXPR T&& value() &&
+    BOOST_CXX14_CONSTEXPR void* operator->() noexcept
     {
-        return std::move( value() );
+        return detail::get_if<0>( &v_ );
     }
 
-    BOOST_CXX14_CONSTEXPR T const&& value() const&&
+    BOOST_CXX14_CONSTEXPR void const* operator->() const noexcept
     {
-        return std::move( value() );
+        return detail::get_if<0>( &v_ );
     }
 
-#endif
-
-    // unchecked value access
-
-    BOOST_CXX14_CONSTEXPR T* operator->() noexcept
+    BOOST_CXX14_CONSTEXPR void operator*() const noexcept
     {
-        return variant2::get_if<0>( &v_ );
+        BOOST_ASSERT( has_value() );
     }
 
-    BOOST_CXX14_CONSTEXPR T const* operator->() const noexcept
-    {
-        return variant2::get_if<0>( &v_ );
-    }
+    // error access
 
 #if defined( BOOST_NO_CXX11_REF_QUALIFIERS )
 
-    BOOST_CXX14_CONSTEXPR T& operator*() noexcept
+    BOOST_CXX14_CONSTEXPR E& error() noexcept
     {
-        T* p = operator->();
+        E* p = detail::get_if<1>( &v_ );
 
         BOOST_ASSERT( p != 0 );
 
         return *p;
     }
 
-    BOOST_CXX14_CONSTEXPR T const& operator*() const noexcept
+    BOOST_CXX14_CONSTEXPR E const& error() const noexcept
     {
-        T const* p = operator->();
+        E const* p = detail::get_if<1>( &v_ );
 
         BOOST_ASSERT( p != 0 );
 
@@ -253,42 +1830,42 @@ public:
 
 #else
 
-    BOOST_CXX14_CONSTEXPR T& operator*() & noexcept
+    BOOST_CXX14_CONSTEXPR E& error() & noexcept
     {
-        T* p = operator->();
+        E* p = detail::get_if<1>( &v_ );
 
         BOOST_ASSERT( p != 0 );
 
         return *p;
     }
 
-    BOOST_CXX14_CONSTEXPR T const& operator*() const & noexcept
+    BOOST_CXX14_CONSTEXPR E const& error() const & noexcept
     {
-        T const* p = operator->();
+        E const* p = detail::get_if<1>( &v_ );
 
         BOOST_ASSERT( p != 0 );
 
         return *p;
     }
 
-    BOOST_CXX14_CONSTEXPR T&& operator*() && noexcept
+    BOOST_CXX14_CONSTEXPR E&& error() && noexcept
     {
-        return std::move(**this);
+        return std::move( error() );
     }
 
-    BOOST_CXX14_CONSTEXPR T const&& operator*() const && noexcept
+    BOOST_CXX14_CONSTEXPR E const&& error() const && noexcept
     {
-        return std::move(**this);
+        return std::move( error() );
     }
 
 #endif
 
-    // error access
+    // the error, or a default constructed E when there is none
 
-    BOOST_CXX14_CONSTEXPR E error() const
+    BOOST_CXX14_CONSTEXPR E error_or_default() const
         noexcept( std::is_nothrow_default_constructible<E>::value && std::is_nothrow_copy_constructible<E>::value )
     {
-        E const * p = variant2::get_if<1>( &v_ );
+        E const * p = detail::get_if<1>( &v_ );
         return p? *p: E();
     }
 
@@ -298,6 +1875,7 @@ public:
         noexcept( noexcept( v_.swap( r.v_ ) ) )
     {
         v_.swap( r.v_ );
+        BOOST_RESULT_SITE_SWAP( r );
     }
 
     friend BOOST_CXX14_CONSTEXPR void swap( result & r1, result & r2 )
@@ -321,11 +1899,11 @@ public:
     }
 };
 
-template<class Ch, class Tr, class T, class E> std::basic_ostream<Ch, Tr>& operator<<( std::basic_ostream<Ch, Tr>& os, result<T, E> const & r )
+template<class Ch, class Tr, class E> std::basic_ostream<Ch, Tr>& operator<<( std::basic_ostream<Ch, Tr>& os, result<void, E> const & r )
 {
     if( r.has_value() )
     {
-        os << "value:" << *r;
+        os << "value:void";
     }
     else
     {
@@ -335,6 +1913,68 @@ template<class Ch, class Tr, class T, class E> std::basic_ostream<Ch, Tr>& opera
     return os;
 }
 
+// is_trivially_relocatable
+
+namespace detail
+{
+
+template<class T> struct is_value_relocatable: is_trivially_relocatable<T>
+{
+};
+
+template<class U> struct is_value_relocatable<U&>: std::true_type
+{
+};
+
+template<> struct is_value_relocatable<void>: std::true_type
+{
+};
+
+} // namespace detail
+
+template<class T, class E> struct is_trivially_relocatable< result<T, E> >: std::integral_constant<bool,
+    detail::is_value_relocatable<T>::value && is_trivially_relocatable<E>::value>
+{
+};
+
+// monadic operations, as free functions
+
+template<class R, class F, class En = typename std::enable_if< detail::is_result< detail::remove_cvref<R> >::value >::type>
+BOOST_CXX14_CONSTEXPR auto and_then( R&& r, F&& f ) -> decltype( std::forward<R>( r ).and_then( std::forward<F>( f ) ) )
+{
+    return std::forward<R>( r ).and_then( std::forward<F>( f ) );
+}
+
+template<class R, class F, class En = typename std::enable_if< detail::is_result< detail::remove_cvref<R> >::value >::type>
+BOOST_CXX14_CONSTEXPR auto transform( R&& r, F&& f ) -> decltype( std::forward<R>( r ).transform( std::forward<F>( f ) ) )
+{
+    return std::forward<R>( r ).transform( std::forward<F>( f ) );
+}
+
+template<class R, class F, class En = typename std::enable_if< detail::is_result< detail::remove_cvref<R> >::value >::type>
+BOOST_CXX14_CONSTEXPR auto or_else( R&& r, F&& f ) -> decltype( std::forward<R>( r ).or_else( std::forward<F>( f ) ) )
+{
+    return std::forward<R>( r ).or_else( std::forward<F>( f ) );
+}
+
+template<class R, class F, class En = typename std::enable_if< detail::is_result< detail::remove_cvref<R> >::value >::type>
+BOOST_CXX14_CONSTEXPR auto transform_error( R&& r, F&& f ) -> decltype( std::forward<R>( r ).transform_error( std::forward<F>( f ) ) )
+{
+    return std::forward<R>( r ).transform_error( std::forward<F>( f ) );
+}
+
+template<class R, class U, class En = typename std::enable_if< detail::is_result< detail::remove_cvref<R> >::value >::type>
+BOOST_CXX14_CONSTEXPR auto value_or( R&& r, U&& u ) -> decltype( std::forward<R>( r ).value_or( std::forward<U>( u ) ) )
+{
+    return std::forward<R>( r ).value_or( std::forward<U>( u ) );
+}
+
+template<class R, class F, class En = typename std::enable_if< detail::is_result< detail::remove_cvref<R> >::value >::type>
+BOOST_CXX14_CONSTEXPR auto value_or_else( R&& r, F&& f ) -> decltype( std::forward<R>( r ).value_or_else( std::forward<F>( f ) ) )
+{
+    return std::forward<R>( r ).value_or_else( std::forward<F>( f ) );
+}
+
 } // namespace result
 } // namespace boost
 
@@ -0,0 +1,536 @@
+#ifndef BOOST_RESULT_RESULT_CHANNEL_HPP_INCLUDED
+#define BOOST_RESULT_RESULT_CHANNEL_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <type_traits>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <exception>
+#include <new>
+#include <cstdint>
+#include <cstddef>
+
+//
+// result_channel<T, E>
+//
+// A bounded lock-free multi-producer multi-consumer queue of result<T, E>,
+// after Dmitry Vyukov's bounded MPMC queue. Each slot holds a sequence
+// number and the result, constructed in place, and takes a whole number
+// of cache lines; the producer and consumer positions are on cache lines
+// of their own. The batch operations claim a run of consecutive slots
+// with a single compare-exchange.
+//
+// close( e ) closes the channel with the terminal error e. Pushes fail
+// afterwards; pops return the results already in the channel, then e, to
+// every consumer.
+//
+
+namespace boost
+{
+namespace result
+{
+
+enum class channel_status
+{
+    ok,
+    empty,
+    full,
+    closed
+};
+
+template<class T, class E = std::error_code> class result_channel
+{
+private:
+
+    static constexpr std::size_t cache_line_size = 64;
+
+    // the closed bit of push_pos_
+
+    static constexpr std::size_t closed_bit = ~( ~std::size_t( 0 ) >> 1 );
+
+    struct alignas( cache_line_size ) slot
+    {
+        std::atomic<std::size_t> seq;
+
+        union
+        {
+            result<T, E> r;
+        };
+
+        slot() noexcept {}
+        ~slot() {}
+    };
+
+    void* storage_;
+    slot* slots_;
+    std::size_t mask_;
+
+    alignas( cache_line_size ) std::atomic<std::size_t> push_pos_;
+    alignas( cache_line_size ) std::atomic<std::size_t> pop_pos_;
+
+    alignas( cache_line_size ) std::atomic<bool> closing_;
+
+    union
+    {
+        E terminal_;
+    };
+
+    static std::size_t round_capacity( std::size_t n ) noexcept
+    {
+        std::size_t r = 2;
+        while( r < n ) r *= 2;
+        return r;
+    }
+
+    // claims up to n slots for pushing, returns the first position and
+    // the count; 0 when full or closed
+
+    std::size_t claim_push( std::size_t& pos, std::size_t n, channel_status& st ) noexcept
+    {
+        pos = push_pos_.load( std::memory_order_relaxed );
+
+        for( ;; )
+        {
+            if( pos & closed_bit )
+            {
+                st = channel_status::closed;
+                return 0;
+            }
+
+            std::size_t k = 0;
+
+            while( k < n && slots_[ ( pos + k ) & mask_ ].seq.load( std::memory_order_acquire ) == pos + k )
+            {
+                ++k;
+            }
+
+            if( k == 0 )
+            {
+                std::size_t seq = slots_[ pos & mask_ ].seq.load( std::memory_order_acquire );
+
+                if( static_cast<std::ptrdiff_t>( seq - pos ) < 0 )
+                {
+                    st = channel_status::full;
+                    return 0;
+                }
+
+                pos = push_pos_.load( std::memory_order_relaxed );
+                continue;
+            }
+
+            if( push_pos_.compare_exchange_weak( pos, pos + k, std::memory_order_relaxed ) )
+            {
+                st = channel_status::ok;
+                return k;
+            }
+        }
+    }
+
+    std::size_t claim_pop( std::size_t& pos, std::size_t n, channel_status& st ) noexcept
+    {
+        pos = pop_pos_.load( std::memory_order_relaxed );
+
+        for( ;; )
+        {
+            std::size_t k = 0;
+
+            while( k < n && slots_[ ( pos + k ) & mask_ ].seq.load( std::memory_order_acquire ) == pos + k + 1 )
+            {
+                ++k;
+            }
+
+            if( k == 0 )
+            {
+                std::size_t seq = slots_[ pos & mask_ ].seq.load( std::memory_order_acquire );
+
+                if( static_cast<std::ptrdiff_t>( seq - ( pos + 1 ) ) < 0 )
+                {
+                    // empty; closed when nothing is in flight either
+
+                    std::size_t pp = push_pos_.load( std::memory_order_acquire );
+                    st = pp == ( pos | closed_bit )? channel_status::closed: channel_status::empty;
+
+                    return 0;
+                }
+
+                pos = pop_pos_.load( std::memory_order_relaxed );
+                continue;
+            }
+
+            if( pop_pos_.compare_exchange_weak( pos, pos + k, std::memory_order_relaxed ) )
+            {
+                st = channel_status::ok;
+                return k;
+            }
+        }
+    }
+
+    void publish_push( std::size_t pos ) noexcept
+    {
+        slots_[ pos & mask_ ].seq.store( pos + 1, std::memory_order_release );
+    }
+
+    void publish_pop( std::size_t pos ) noexcept
+    {
+        slots_[ pos & mask_ ].seq.store( pos + mask_ + 1, std::memory_order_release );
+    }
+
+    // fills in and publishes the claimed push positions [next_, last_);
+    // when the construction of a result throws, its slot and the rest
+    // of the run hold E(), as the positions have to be published in
+    // order for the channel not to stall, and the program terminates
+    // when E can't be default constructed without throwing
+
+    struct push_run
+    {
+        result_channel* ch_;
+        std::size_t next_;
+        std::size_t last_;
+
+        ~push_run()
+        {
+            if( next_ == last_ ) return;
+
+            ch_->publish_push( next_++ );
+
+            for( ; next_ != last_; ++next_ )
+            {
+                construct_default_error( &ch_->slots_[ next_ & ch_->mask_ ].r, std::is_nothrow_default_constructible<E>() );
+                ch_->publish_push( next_ );
+            }
+        }
+    };
+
+    // takes out and publishes the claimed pop positions [next_, last_);
+    // when moving a result out throws, the rest of the run is discarded
+
+    struct pop_run
+    {
+        result_channel* ch_;
+        std::size_t next_;
+        std::size_t last_;
+
+        ~pop_run()
+        {
+            for( ; next_ != last_; ++next_ )
+            {
+                ch_->slots_[ next_ & ch_->mask_ ].r.~result();
+                ch_->publish_pop( next_ );
+            }
+        }
+    };
+
+    template<class... A> channel_status try_emplace_( A&&... a )
+    {
+        std::size_t pos;
+        channel_status st;
+
+        if( claim_push( pos, 1, st ) )
+        {
+            push_run run{ this, pos, pos + 1 };
+
+            construct( pos, std::forward<A>( a )... );
+            publish_push( run.next_++ );
+        }
+
+        return st;
+    }
+
+    template<class... A> void construct( std::size_t pos, A&&... a )
+    {
+        result<T, E>* p = &slots_[ pos & mask_ ].r;
+
+#if !defined(BOOST_NO_EXCEPTIONS)
+        try
+        {
+#endif
+            ::new( static_cast<void*>( p ) ) result<T, E>( std::forward<A>( a )... );
+#if !defined(BOOST_NO_EXCEPTIONS)
+        }
+        catch( ... )
+        {
+            construct_default_error( p, std::is_nothrow_default_constructible<E>() );
+            throw;
+        }
+#endif
+    }
+
+    // the slot is already claimed and has to hold something
+
+    static void construct_default_error( result<T, E>* p, std::true_type ) noexcept
+    {
+        ::new( static_cast<void*>( p ) ) result<T, E>( in_place_error );
+    }
+
+    static void construct_default_error( result<T, E>*, std::false_type ) noexcept
+    {
+        std::terminate();
+    }
+
+    void set_terminal( result<T, E>& out ) const
+    {
+        out = result<T, E>( in_place_error, terminal_ );
+    }
+
+    static void backoff( unsigned& k ) noexcept
+    {
+        if( ++k > 16 ) std::this_thread::yield();
+    }
+
+public:
+
+    // capacity is rounded up to a power of two, at least 2
+
+    explicit result_channel( std::size_t capacity ): push_pos_( 0 ), pop_pos_( 0 ), closing_( false )
+    {
+        std::size_t n = round_capacity( capacity );
+
+        storage_ = ::operator new( n * sizeof( slot ) + cache_line_size - 1 );
+
+        std::uintptr_t a = reinterpret_cast<std::uintptr_t>( storage_ );
+        a = ( a + cache_line_size - 1 ) & ~static_cast<std::uintptr_t>( cache_line_size - 1 );
+
+        slots_ = reinterpret_cast<slot*>( a );
+        mask_ = n - 1;
+
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            ::new( static_cast<void*>( slots_ + i ) ) slot();
+            slots_[ i ].seq.store( i, std::memory_order_relaxed );
+        }
+    }
+
+    result_channel( result_channel const& ) = delete;
+    result_channel& operator=( result_channel const& ) = delete;
+
+    ~result_channel()
+    {
+        std::size_t first = pop_pos_.load( std::memory_order_relaxed );
+        std::size_t last = push_pos_.load( std::memory_order_relaxed ) & ~closed_bit;
+
+        for( std::size_t i = first; i != last; ++i )
+        {
+            slots_[ i & mask_ ].r.~result();
+        }
+
+        for( std::size_t i = 0; i <= mask_; ++i )
+        {
+            slots_[ i ].~slot();
+        }
+
+        ::operator delete( storage_ );
+
+        if( push_pos_.load( std::memory_order_relaxed ) & closed_bit )
+        {
+            terminal_.~E();
+        }
+    }
+
+    std::size_t capacity() const noexcept
+    {
+        return mask_ + 1;
+    }
+
+    bool is_closed() const noexcept
+    {
+        return ( push_pos_.load( std::memory_order_acquire ) & closed_bit ) != 0;
+    }
+
+    // non-blocking push; returns ok, full, or closed
+
+    template<class... A> channel_status try_emplace_value( A&&... a )
+    {
+        return try_emplace_( in_place_value, std::forward<A>( a )... );
+    }
+
+    template<class... A> channel_status try_emplace_error( A&&... a )
+    {
+        return try_emplace_( in_place_error, std::forward<A>( a )... );
+    }
+
+    channel_status try_push( result<T, E> const& r )
+    {
+        return try_emplace_( r );
+    }
+
+    channel_status try_push( result<T, E>&& r )
+    {
+        return try_emplace_( std::move( r ) );
+    }
+
+    // non-blocking pop; returns ok, empty, or closed, in which case out
+    // holds the terminal error
+
+    channel_status try_pop( result<T, E>& out )
+    {
+        std::size_t pos;
+        channel_status st;
+
+        if( claim_pop( pos, 1, st ) )
+        {
+            pop_run run{ this, pos, pos + 1 };
+
+            result<T, E>& r = slots_[ pos & mask_ ].r;
+
+            out = std::move( r );
+            r.~result();
+
+            publish_pop( run.next_++ );
+        }
+        else if( st == channel_status::closed )
+        {
+            set_terminal( out );
+        }
+
+        return st;
+    }
+
+    // batch push of the n results starting at first, moved from; returns
+    // the number pushed, which is less than n when the channel fills up
+    // or is closed
+
+    template<class It> std::size_t try_push_n( It first, std::size_t n )
+    {
+        std::size_t m = 0;
+
+        while( m < n )
+        {
+            std::size_t pos;
+            channel_status st;
+
+            std::size_t k = claim_push( pos, n - m, st );
+
+            if( k == 0 ) break;
+
+            push_run run{ this, pos, pos + k };
+
+            for( ; run.next_ != run.last_; ++first )
+            {
+                construct( run.next_, std::move( *first ) );
+                publish_push( run.next_++ );
+            }
+
+            m += k;
+        }
+
+        return m;
+    }
+
+    // batch pop of up to n results into the output iterator out; returns
+    // the number popped, 0 when the channel is empty or closed
+
+    template<class OutIt> std::size_t try_pop_n( OutIt out, std::size_t n )
+    {
+        std::size_t pos;
+        channel_status st;
+
+        std::size_t k = claim_pop( pos, n, st );
+
+        pop_run run{ this, pos, pos + k };
+
+        for( ; run.next_ != run.last_; ++out )
+        {
+            result<T, E>& r = slots_[ run.next_ & mask_ ].r;
+
+            *out = std::move( r );
+            r.~result();
+
+            publish_pop( run.next_++ );
+        }
+
+        return k;
+    }
+
+    // blocking push; returns false when the channel is closed
+
+    template<class... A> bool emplace_value( A&&... a )
+    {
+        channel_status st;
+
+        for( unsigned k = 0; ( st = try_emplace_value( std::forward<A>( a )... ) ) == channel_status::full; backoff( k ) );
+
+        return st == channel_status::ok;
+    }
+
+    template<class... A> bool emplace_error( A&&... a )
+    {
+        channel_status st;
+
+        for( unsigned k = 0; ( st = try_emplace_error( std::forward<A>( a )... ) ) == channel_status::full; backoff( k ) );
+
+        return st == channel_status::ok;
+    }
+
+    bool push( result<T, E> const& r )
+    {
+        channel_status st;
+
+        for( unsigned k = 0; ( st = try_push( r ) ) == channel_status::full; backoff( k ) );
+
+        return st == channel_status::ok;
+    }
+
+    bool push( result<T, E>&& r )
+    {
+        channel_status st;
+
+        for( unsigned k = 0; ( st = try_push( std::move( r ) ) ) == channel_status::full; backoff( k ) );
+
+        return st == channel_status::ok;
+    }
+
+    // blocking pop; returns false when the channel is closed and drained,
+    // in which case out holds the terminal error
+
+    bool pop( result<T, E>& out )
+    {
+        channel_status st;
+
+        for( unsigned k = 0; ( st = try_pop( out ) ) == channel_status::empty; backoff( k ) );
+
+        return st == channel_status::ok;
+    }
+
+    // closes the channel with the terminal error; returns false when it
+    // was already closed. When the construction of the error throws, the
+    // channel is left open
+
+    template<class... A> bool close( A&&... a )
+    {
+        bool expected = false;
+
+        if( !closing_.compare_exchange_strong( expected, true, std::memory_order_relaxed ) )
+        {
+            return false;
+        }
+
+        BOOST_TRY
+        {
+            ::new( static_cast<void*>( &terminal_ ) ) E( std::forward<A>( a )... );
+        }
+        BOOST_CATCH(...)
+        {
+            // the channel stays open, and can be closed again
+            closing_.store( false, std::memory_order_relaxed );
+            BOOST_RETHROW
+        }
+        BOOST_CATCH_END
+
+        push_pos_.fetch_or( closed_bit, std::memory_order_release );
+        return true;
+    }
+};
+
+} // namespace result
+} // namespace boost
+
+#endif // #ifndef BOOST_RESULT_RESULT_CHANNEL_HPP_INCLUDED
@@ -0,0 +1,559 @@
+#ifndef BOOST_RESULT_RESULT_FUTURE_HPP_INCLUDED
+#define BOOST_RESULT_RESULT_FUTURE_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <type_traits>
+#include <future>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <new>
+#include <cstdint>
+#include <cstddef>
+#include <climits>
+
+#if defined(__has_include)
+# if __has_include(<version>)
+#  include <version>
+# endif
+#endif
+
+#if defined(__cpp_lib_atomic_wait) && __cpp_lib_atomic_wait >= 201907L
+# define BOOST_RESULT_FUTURE_USE_ATOMIC_WAIT
+#elif defined(__linux__)
+# define BOOST_RESULT_FUTURE_USE_FUTEX
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+//
+// result_promise<T, E>, result_future<T, E>
+//
+// A one-shot channel for handing a result<T, E> from one thread to
+// another. The promise and the future share a state, allocated once,
+// that holds the result inline and is synchronized by a single atomic
+// word; a thread blocked in wait() or get() sleeps on that word, using
+// std::atomic::wait when available and futex(2) on Linux otherwise.
+//
+// result_future::then( f ) attaches a continuation, called with an rvalue
+// result<T, E> by the thread that completes the promise, or immediately
+// when the result is already there.
+//
+// A promise destroyed without a result stores the error
+// std::future_errc::broken_promise when E is constructible from
+// std::error_code; otherwise get() throws std::future_error, and a
+// continuation isn't called.
+//
+
+namespace boost
+{
+namespace result
+{
+
+template<class T, class E = std::error_code> class result_promise;
+template<class T, class E = std::error_code> class result_future;
+
+namespace detail
+{
+
+// waiting on an atomic word
+
+#if defined(BOOST_RESULT_FUTURE_USE_ATOMIC_WAIT)
+
+inline void atomic_wait( std::atomic<std::uint32_t>& w, std::uint32_t v ) noexcept
+{
+    w.wait( v, std::memory_order_acquire );
+}
+
+inline void atomic_notify_all( std::atomic<std::uint32_t>& w ) noexcept
+{
+    w.notify_all();
+}
+
+#elif defined(BOOST_RESULT_FUTURE_USE_FUTEX)
+
+inline void atomic_wait( std::atomic<std::uint32_t>& w, std::uint32_t v ) noexcept
+{
+    ::syscall( SYS_futex, reinterpret_cast<std::uint32_t*>( &w ), FUTEX_WAIT_PRIVATE, v, nullptr, nullptr, 0 );
+}
+
+inline void atomic_notify_all( std::atomic<std::uint32_t>& w ) noexcept
+{
+    ::syscall( SYS_futex, reinterpret_cast<std::uint32_t*>( &w ), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0 );
+}
+
+#else
+
+inline void atomic_wait( std::atomic<std::uint32_t>& w, std::uint32_t v ) noexcept
+{
+    while( w.load( std::memory_order_acquire ) == v )
+    {
+        std::this_thread::yield();
+    }
+}
+
+inline void atomic_notify_all( std::atomic<std::uint32_t>& ) noexcept
+{
+}
+
+#endif
+
+// the error stored by a broken promise
+
+template<class R> bool set_broken_promise( R* p, std::true_type )
+{
+    ::new( static_cast<void*>( p ) ) R( in_place_error, std::make_error_code( std::future_errc::broken_promise ) );
+    return true;
+}
+
+template<class R> bool set_broken_promise( R*, std::false_type ) noexcept
+{
+    return false;
+}
+
+template<class T, class E> class result_shared_state
+{
+private:
+
+    // the state word
+
+    static constexpr std::uint32_t promise_alive = 1;
+    static constexpr std::uint32_t future_alive = 2;
+    static constexpr std::uint32_t ready = 4;        // r_ is set, or broken
+    static constexpr std::uint32_t broken = 8;       // ready without a result
+    static constexpr std::uint32_t has_continuation = 16;
+    static constexpr std::uint32_t has_waiters = 32;
+
+    std::atomic<std::uint32_t> state_;
+
+    union
+    {
+        result<T, E> r_;
+    };
+
+    // continuation, inline when small enough
+
+    static constexpr std::size_t buffer_size = 4 * sizeof( void* );
+
+    void ( *invoke_ )( void* f, result<T, E>* r );
+    void ( *destroy_ )( void* f );
+
+    alignas( std::max_align_t ) unsigned char buffer_[ buffer_size ];
+
+    template<class F> static void invoke_inline( void* f, result<T, E>* r )
+    {
+        F& g = *static_cast<F*>( f );
+        g( std::move( *r ) );
+    }
+
+    template<class F> static void destroy_inline( void* f ) noexcept
+    {
+        static_cast<F*>( f )->~F();
+    }
+
+    template<class F> static void invoke_heap( void* f, result<T, E>* r )
+    {
+        F& g = **static_cast<F**>( f );
+        g( std::move( *r ) );
+    }
+
+    template<class F> static void destroy_heap( void* f ) noexcept
+    {
+        delete *static_cast<F**>( f );
+    }
+
+    template<class F> void set_continuation_( F&& f, std::true_type )
+    {
+        using G = typename std::decay<F>::type;
+
+        ::new( static_cast<void*>( buffer_ ) ) G( std::forward<F>( f ) );
+
+        invoke_ = &invoke_inline<G>;
+        destroy_ = &destroy_inline<G>;
+    }
+
+    template<class F> void set_continuation_( F&& f, std::false_type )
+    {
+        using G = typename std::decay<F>::type;
+
+        ::new( static_cast<void*>( buffer_ ) ) G*( new G( std::forward<F>( f ) ) );
+
+        invoke_ = &invoke_heap<G>;
+        destroy_ = &destroy_heap<G>;
+    }
+
+    void run_continuation( std::uint32_t s )
+    {
+        void ( *destroy )( void* f ) = destroy_;
+        destroy_ = nullptr;
+
+        struct guard
+        {
+            void ( *destroy_ )( void* f );
+            void* f_;
+
+            ~guard() { destroy_( f_ ); }
+        };
+
+        guard g{ destroy, buffer_ };
+
+        if( !( s & broken ) )
+        {
+            invoke_( buffer_, &r_ );
+        }
+    }
+
+    ~result_shared_state()
+    {
+        std::uint32_t s = state_.load( std::memory_order_relaxed );
+
+        if( ( s & ready ) && !( s & broken ) )
+        {
+            r_.~result();
+        }
+
+        if( destroy_ )
+        {
+            destroy_( buffer_ );
+        }
+    }
+
+    // the last of the promise and the future deletes the state
+
+    void release( std::uint32_t self ) noexcept
+    {
+        std::uint32_t other = self == promise_alive? future_alive: promise_alive;
+
+        if( !( state_.fetch_and( ~self, std::memory_order_acq_rel ) & other ) )
+        {
+            delete this;
+        }
+    }
+
+    void complete( std::uint32_t bits )
+    {
+        std::uint32_t s = state_.fetch_or( bits, std::memory_order_acq_rel );
+
+        if( s & has_continuation )
+        {
+            run_continuation( s | bits );
+        }
+
+        if( s & has_waiters )
+        {
+            atomic_notify_all( state_ );
+        }
+    }
+
+public:
+
+    result_shared_state() noexcept: state_( promise_alive | future_alive ), invoke_( nullptr ), destroy_( nullptr )
+    {
+    }
+
+    result_shared_state( result_shared_state const& ) = delete;
+    result_shared_state& operator=( result_shared_state const& ) = delete;
+
+    // promise side
+
+    template<class... A> void set( A&&... a )
+    {
+        BOOST_ASSERT( !( state_.load( std::memory_order_relaxed ) & ready ) );
+
+        ::new( static_cast<void*>( &r_ ) ) result<T, E>( std::forward<A>( a )... );
+        complete( ready );
+    }
+
+    void abandon() noexcept
+    {
+        if( !( state_.load( std::memory_order_relaxed ) & ready ) )
+        {
+            // called from ~result_promise, so a continuation that throws
+            // here terminates
+
+            if( set_broken_promise( &r_, std::is_constructible<E, std::error_code>() ) )
+            {
+                complete( ready );
+            }
+            else
+            {
+                complete( ready | broken );
+            }
+        }
+
+        release( promise_alive );
+    }
+
+    void release_future() noexcept
+    {
+        release( future_alive );
+    }
+
+    void release_both() noexcept
+    {
+        delete this;
+    }
+
+    // future side
+
+    bool is_ready() const noexcept
+    {
+        return ( state_.load( std::memory_order_acquire ) & ready ) != 0;
+    }
+
+    void wait() noexcept
+    {
+        std::uint32_t s = state_.load( std::memory_order_acquire );
+
+        while( !( s & ready ) )
+        {
+            if( !( s & has_waiters ) )
+            {
+                if( !state_.compare_exchange_weak( s, s | has_waiters, std::memory_order_acquire ) ) continue;
+                s |= has_waiters;
+            }
+
+            atomic_wait( state_, s );
+            s = state_.load( std::memory_order_acquire );
+        }
+    }
+
+    // precondition: is_ready()
+
+    result<T, E>* get() noexcept
+    {
+        if( state_.load( std::memory_order_relaxed ) & broken )
+        {
+            return nullptr;
+        }
+
+        return &r_;
+    }
+
+    template<class F> void then( F&& f )
+    {
+        set_continuation_( std::forward<F>( f ), std::integral_constant<bool,
+            sizeof( typename std::decay<F>::type ) <= buffer_size &&
+            alignof( typename std::decay<F>::type ) <= alignof( std::max_align_t ) &&
+            std::is_nothrow_move_constructible<typename std::decay<F>::type>::value>() );
+
+        std::uint32_t s = state_.fetch_or( has_continuation, std::memory_order_acq_rel );
+
+        if( s & ready )
+        {
+            run_continuation( s );
+        }
+    }
+};
+
+} // namespace detail
+
+// result_promise
+
+template<class T, class E> class result_promise
+{
+private:
+
+    detail::result_shared_state<T, E>* p_;
+    bool retrieved_;
+
+    detail::result_shared_state<T, E>* state() const noexcept
+    {
+        BOOST_ASSERT( p_ != nullptr );
+        return p_;
+    }
+
+public:
+
+    result_promise(): p_( new detail::result_shared_state<T, E>() ), retrieved_( false )
+    {
+    }
+
+    result_promise( result_promise&& r ) noexcept: p_( r.p_ ), retrieved_( r.retrieved_ )
+    {
+        r.p_ = nullptr;
+    }
+
+    result_promise& operator=( result_promise&& r ) noexcept
+    {
+        result_promise( std::move( r ) ).swap( *this );
+        return *this;
+    }
+
+    ~result_promise()
+    {
+        if( p_ == nullptr ) return;
+
+        if( retrieved_ )
+        {
+            p_->abandon();
+        }
+        else
+        {
+            p_->release_both();
+        }
+    }
+
+    void swap( result_promise& r ) noexcept
+    {
+        std::swap( p_, r.p_ );
+        std::swap( retrieved_, r.retrieved_ );
+    }
+
+    // can only be called once
+
+    result_future<T, E> get_future() noexcept
+    {
+        BOOST_ASSERT( !retrieved_ );
+
+        retrieved_ = true;
+        return result_future<T, E>( state() );
+    }
+
+    // a result can only be set once
+
+    template<class... A> void set_value( A&&... a )
+    {
+        state()->set( in_place_value, std::forward<A>( a )... );
+    }
+
+    template<class... A> void set_error( A&&... a )
+    {
+        state()->set( in_place_error, std::forward<A>( a )... );
+    }
+
+    void set_result( result<T, E> const& r )
+    {
+        state()->set( r );
+    }
+
+    void set_result( result<T, E>&& r )
+    {
+        state()->set( std::move( r ) );
+    }
+};
+
+// result_future
+
+template<class T, class E> class result_future
+{
+private:
+
+    detail::result_shared_state<T, E>* p_;
+
+    friend class result_promise<T, E>;
+
+    explicit result_future( detail::result_shared_state<T, E>* p ) noexcept: p_( p )
+    {
+    }
+
+    detail::result_shared_state<T, E>* state() const noexcept
+    {
+        BOOST_ASSERT( p_ != nullptr );
+        return p_;
+    }
+
+    void reset() noexcept
+    {
+        if( p_ )
+        {
+            p_->release_future();
+            p_ = nullptr;
+        }
+    }
+
+public:
+
+    constexpr result_future() noexcept: p_( nullptr )
+    {
+    }
+
+    result_future( result_future&& r ) noexcept: p_( r.p_ )
+    {
+        r.p_ = nullptr;
+    }
+
+    result_future& operator=( result_future&& r ) noexcept
+    {
+        result_future( std::move( r ) ).swap( *this );
+        return *this;
+    }
+
+    ~result_future()
+    {
+        reset();
+    }
+
+    void swap( result_future& r ) noexcept
+    {
+        std::swap( p_, r.p_ );
+    }
+
+    bool valid() const noexcept
+    {
+        return p_ != nullptr;
+    }
+
+    bool is_ready() const noexcept
+    {
+        return state()->is_ready();
+    }
+
+    void wait() const noexcept
+    {
+        state()->wait();
+    }
+
+    // returns a pointer to the result when it's there, without blocking
+
+    result<T, E>* try_get()
+    {
+        if( !state()->is_ready() ) return nullptr;
+
+        result<T, E>* r = p_->get();
+
+        if( r == nullptr )
+        {
+            boost::throw_exception( std::future_error( std::future_errc::broken_promise ) );
+        }
+
+        return r;
+    }
+
+    // waits for the result and moves it out; the future is no longer valid
+
+    result<T, E> get()
+    {
+        wait();
+
+        result<T, E>* r = try_get();
+        result<T, E> r2( std::move( *r ) );
+
+        reset();
+
+        return r2;
+    }
+
+    // attaches a continuation, called with an rvalue result<T, E>; the
+    // future is no longer valid
+
+    template<class F> void then( F&& f )
+    {
+        state()->then( std::forward<F>( f ) );
+        reset();
+    }
+};
+
+} // namespace result
+} // namespace boost
+
+#endif // #ifndef BOOST_RESULT_RESULT_FUTURE_HPP_INCLUDED
@@ -0,0 +1,743 @@
+#ifndef BOOST_RESULT_RESULT_VECTOR_HPP_INCLUDED
+#define BOOST_RESULT_RESULT_VECTOR_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <type_traits>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <tuple>
+#include <iosfwd>
+#include <cstddef>
+#include <cstdint>
+
+#if defined( _MSC_VER ) && !defined( __clang__ ) && ( defined( _M_X64 ) || defined( _M_ARM64 ) )
+# include <intrin.h>
+#endif
+
+//
+
+namespace boost
+{
+namespace result
+{
+
+namespace detail
+{
+
+// bit operations on the error bitmap
+
+inline int popcount64( std::uint64_t x ) noexcept
+{
+#if defined( __GNUC__ ) && defined( __POPCNT__ )
+
+    return __builtin_popcountll( x );
+
+#elif defined( _MSC_VER ) && !defined( __clang__ ) && defined( _M_X64 )
+
+    return static_cast<int>( __popcnt64( x ) );
+
+#else
+
+    // SWAR; vectorizes well when applied over an array
+
+    x = x - ( ( x >> 1 ) & 0x5555555555555555ull );
+    x = ( x & 0x3333333333333333ull ) + ( ( x >> 2 ) & 0x3333333333333333ull );
+    x = ( x + ( x >> 4 ) ) & 0x0F0F0F0F0F0F0F0Full;
+
+    return static_cast<int>( ( x * 0x0101010101010101ull ) >> 56 );
+
+#endif
+}
+
+// requires: x != 0
+inline int countr_zero64( std::uint64_t x ) noexcept
+{
+    BOOST_ASSERT( x != 0 );
+
+#if defined( __GNUC__ )
+
+    return __builtin_ctzll( x );
+
+#elif defined( _MSC_VER ) && !defined( __clang__ ) && ( defined( _M_X64 ) || defined( _M_ARM64 ) )
+
+    unsigned long r;
+    _BitScanForward64( &r, x );
+    return static_cast<int>( r );
+
+#else
+
+    int r = 0;
+
+    while( ( x & 1 ) == 0 )
+    {
+        x >>= 1;
+        ++r;
+    }
+
+    return r;
+
+#endif
+}
+
+} // namespace detail
+
+// result_vector<T, E>
+//
+// A sequence of result<T, E> stored as a structure of arrays: the values
+// in a dense array of T, a bitmap with a set bit for each element that
+// holds an error, and the errors themselves in a side table sorted by
+// position. Suited to sequences in which errors are rare.
+//
+// The T slot of an element that holds an error contains a value
+// initialized T, so adding errors requires T to be default constructible.
+//
+// Elements are accessed through proxies that behave like result<T&, E>.
+
+template<class T, class E = std::error_code> class result_vector
+{
+private:
+
+    static_assert( !std::is_reference<T>::value && !std::is_void<T>::value, "T must be an object type" );
+
+    typedef std::uint64_t word_type;
+    static constexpr std::size_t word_bits = 64;
+
+    std::vector<T> values_;
+    std::vector<word_type> bits_;
+    std::vector< std::pair<std::size_t, E> > errors_;
+
+private:
+
+    bool bit_( std::size_t i ) const noexcept
+    {
+        return ( bits_[ i / word_bits ] >> ( i % word_bits ) ) & 1;
+    }
+
+    void set_bit_( std::size_t i ) noexcept
+    {
+        bits_[ i / word_bits ] |= word_type( 1 ) << ( i % word_bits );
+    }
+
+    void clear_bit_( std::size_t i ) noexcept
+    {
+        bits_[ i / word_bits ] &= ~( word_type( 1 ) << ( i % word_bits ) );
+    }
+
+    typedef typename std::vector< std::pair<std::size_t, E> >::iterator table_iterator;
+    typedef typename std::vector< std::pair<std::size_t, E> >::const_iterator table_const_iterator;
+
+    struct table_less
+    {
+        bool operator()( std::pair<std::size_t, E> const& p, std::size_t i ) const noexcept
+        {
+            return p.first < i;
+        }
+    };
+
+    table_iterator find_error_( std::size_t i ) noexcept
+    {
+        return std::lower_bound( errors_.begin(), errors_.end(), i, table_less() );
+    }
+
+    table_const_iterator find_error_( std::size_t i ) const noexcept
+    {
+        return std::lower_bound( errors_.begin(), errors_.end(), i, table_less() );
+    }
+
+    // makes room in the bitmap for one more element
+    void grow_()
+    {
+        if( bits_.size() * word_bits == values_.size() )
+        {
+            bits_.push_back( 0 );
+        }
+    }
+
+    void shrink_() noexcept
+    {
+        bits_.resize( ( values_.size() + word_bits - 1 ) / word_bits );
+    }
+
+    template<bool Const> class basic_reference;
+    template<bool Const> class basic_iterator;
+
+public:
+
+    typedef result<T, E> value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    typedef basic_reference<false> reference;
+    typedef basic_reference<true> const_reference;
+
+    typedef basic_iterator<false> iterator;
+    typedef basic_iterator<true> const_iterator;
+
+public:
+
+    // construction
+
+    result_vector() = default;
+
+    // capacity
+
+    size_type size() const noexcept
+    {
+        return values_.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return values_.empty();
+    }
+
+    void reserve( size_type n )
+    {
+        values_.reserve( n );
+        bits_.reserve( ( n + word_bits - 1 ) / word_bits );
+    }
+
+    // modifiers
+
+    void clear() noexcept
+    {
+        values_.clear();
+        bits_.clear();
+        errors_.clear();
+    }
+
+    template<class... A> T& emplace_back_value( A&&... a )
+    {
+        grow_();
+        values_.emplace_back( std::forward<A>(a)... );
+
+        return values_.back();
+    }
+
+    template<class... A> E& emplace_back_error( A&&... a )
+    {
+        grow_();
+        errors_.emplace_back( std::piecewise_construct, std::forward_as_tuple( values_.size() ), std::forward_as_tuple( std::forward<A>(a)... ) );
+
+        BOOST_TRY
+        {
+            values_.emplace_back();
+        }
+        BOOST_CATCH(...)
+        {
+            errors_.pop_back();
+            BOOST_RETHROW
+        }
+        BOOST_CATCH_END
+
+        set_bit_( values_.size() - 1 );
+        return errors_.back().second;
+    }
+
+    void push_back( result<T, E> const& r )
+    {
+        if( r.has_value() )
+        {
+            emplace_back_value( *r );
+        }
+        else
+        {
+            emplace_back_error( r.error() );
+        }
+    }
+
+    void push_back( result<T, E>&& r )
+    {
+        if( r.has_value() )
+        {
+            emplace_back_value( std::move( *r ) );
+        }
+        else
+        {
+            emplace_back_error( std::move( r ).error() );
+        }
+    }
+
+    void pop_back() noexcept
+    {
+        BOOST_ASSERT( !empty() );
+
+        std::size_t i = values_.size() - 1;
+
+        if( bit_( i ) )
+        {
+            clear_bit_( i );
+            errors_.pop_back();
+        }
+
+        values_.pop_back();
+        shrink_();
+    }
+
+    // Makes element i hold a value, assigning to the existing one if any
+    template<class A> void set_value( size_type i, A&& a )
+    {
+        BOOST_ASSERT( i < size() );
+
+        values_[ i ] = std::forward<A>(a);
+
+        if( bit_( i ) )
+        {
+            errors_.erase( find_error_( i ) );
+            clear_bit_( i );
+        }
+    }
+
+    // Makes element i hold an error, assigning to the existing one if any
+    template<class A> void set_error( size_type i, A&& a )
+    {
+        BOOST_ASSERT( i < size() );
+
+        if( bit_( i ) )
+        {
+            find_error_( i )->second = std::forward<A>(a);
+        }
+        else
+        {
+            errors_.emplace( find_error_( i ), std::piecewise_construct, std::forward_as_tuple( i ), std::forward_as_tuple( std::forward<A>(a) ) );
+            set_bit_( i );
+
+            values_[ i ] = T();
+        }
+    }
+
+    void set( size_type i, result<T, E> const& r )
+    {
+        if( r.has_value() )
+        {
+            set_value( i, *r );
+        }
+        else
+        {
+            set_error( i, r.error() );
+        }
+    }
+
+    void set( size_type i, result<T, E>&& r )
+    {
+        if( r.has_value() )
+        {
+            set_value( i, std::move( *r ) );
+        }
+        else
+        {
+            set_error( i, std::move( r ).error() );
+        }
+    }
+
+    void swap( result_vector& r ) noexcept
+    {
+        values_.swap( r.values_ );
+        bits_.swap( r.bits_ );
+        errors_.swap( r.errors_ );
+    }
+
+    friend void swap( result_vector& r1, result_vector& r2 ) noexcept
+    {
+        r1.swap( r2 );
+    }
+
+    // element access
+
+    bool has_value( size_type i ) const noexcept
+    {
+        BOOST_ASSERT( i < size() );
+        return !bit_( i );
+    }
+
+    bool has_error( size_type i ) const noexcept
+    {
+        BOOST_ASSERT( i < size() );
+        return bit_( i );
+    }
+
+    reference operator[]( size_type i ) noexcept
+    {
+        BOOST_ASSERT( i < size() );
+        return reference( this, i );
+    }
+
+    const_reference operator[]( size_type i ) const noexcept
+    {
+        BOOST_ASSERT( i < size() );
+        return const_reference( this, i );
+    }
+
+    // The dense array of values; the T slots of elements holding errors
+    // contain value initialized T objects
+
+    T* data() noexcept
+    {
+        return values_.data();
+    }
+
+    T const* data() const noexcept
+    {
+        return values_.data();
+    }
+
+    // iterators
+
+    iterator begin() noexcept
+    {
+        return iterator( this, 0 );
+    }
+
+    iterator end() noexcept
+    {
+        return iterator( this, size() );
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator( this, 0 );
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator( this, size() );
+    }
+
+    // bitmap scans
+
+    // the number of elements holding errors
+    size_type count_errors() const noexcept
+    {
+        return errors_.size();
+    }
+
+    // the number of elements in [first, last) holding errors
+    size_type count_errors( size_type first, size_type last ) const noexcept
+    {
+        BOOST_ASSERT( first <= last && last <= size() );
+
+        if( first == last ) return 0;
+
+        std::size_t w1 = first / word_bits, w2 = ( last - 1 ) / word_bits;
+
+        word_type const m1 = ~word_type( 0 ) << ( first % word_bits );
+        word_type const m2 = ~word_type( 0 ) >> ( word_bits - 1 - ( last - 1 ) % word_bits );
+
+        if( w1 == w2 )
+        {
+            return detail::popcount64( bits_[ w1 ] & m1 & m2 );
+        }
+
+        size_type n = detail::popcount64( bits_[ w1 ] & m1 ) + detail::popcount64( bits_[ w2 ] & m2 );
+
+        for( std::size_t w = w1 + 1; w < w2; ++w )
+        {
+            n += detail::popcount64( bits_[ w ] );
+        }
+
+        return n;
+    }
+
+    // the position of the first element at or after `first` holding an
+    // error, or size() when there is none
+    size_type find_next_error( size_type first ) const noexcept
+    {
+        BOOST_ASSERT( first <= size() );
+
+        std::size_t const n = bits_.size();
+        std::size_t w = first / word_bits;
+
+        if( w == n ) return size();
+
+        word_type x = bits_[ w ] & ( ~word_type( 0 ) << ( first % word_bits ) );
+
+        while( x == 0 )
+        {
+            if( ++w == n ) return size();
+            x = bits_[ w ];
+        }
+
+        return w * word_bits + detail::countr_zero64( x );
+    }
+
+    size_type find_first_error() const noexcept
+    {
+        return find_next_error( 0 );
+    }
+
+    // Calls f( v ) for each value v, in order, skipping the elements that
+    // hold errors. Runs of 64 elements without errors are visited without
+    // further bitmap checks.
+
+    template<class F> void for_each_value( F&& f )
+    {
+        for_each_value_( values_.data(), f );
+    }
+
+    template<class F> void for_each_value( F&& f ) const
+    {
+        for_each_value_( values_.data(), f );
+    }
+
+private:
+
+    template<class P, class F> void for_each_value_( P p, F& f ) const
+    {
+        std::size_t const n = values_.size();
+
+        for( std::size_t w = 0, i = 0; i < n; ++w, i += word_bits )
+        {
+            std::size_t const m = n - i < word_bits? n - i: word_bits;
+            word_type const x = bits_[ w ];
+
+            if( x == 0 )
+            {
+                for( std::size_t j = 0; j < m; ++j )
+                {
+                    f( p[ i + j ] );
+                }
+            }
+            else
+            {
+                for( std::size_t j = 0; j < m; ++j )
+                {
+                    if( ( ( x >> j ) & 1 ) == 0 )
+                    {
+                        f( p[ i + j ] );
+                    }
+                }
+            }
+        }
+    }
+};
+
+// result_vector<T, E>::basic_reference
+//
+// Refers to the element at a position; has the interface of result<T&, E>
+// (or result<T const&, E>), assignment from result<T, E> and conversion
+// to result<T, E>.
+
+template<class T, class E> template<bool Const> class result_vector<T, E>::basic_reference
+{
+private:
+
+    typedef typename std::conditional<Const, result_vector const, result_vector>::type container_type;
+    typedef typename std::conditional<Const, T const, T>::type value_type;
+    typedef typename std::conditional<Const, E const, E>::type error_type;
+
+    container_type* p_;
+    std::size_t i_;
+
+    friend class result_vector;
+    template<bool C2> friend class basic_reference;
+
+    basic_reference( container_type* p, std::size_t i ) noexcept: p_( p ), i_( i )
+    {
+    }
+
+public:
+
+    basic_reference( basic_reference const& ) = default;
+
+    // a const_reference from a reference
+    template<bool C2, class En = typename std::enable_if<Const && !C2>::type>
+    basic_reference( basic_reference<C2> const& r ) noexcept: p_( r.p_ ), i_( r.i_ )
+    {
+    }
+
+    // assignment writes through
+
+    basic_reference& operator=( basic_reference const& r )
+    {
+        p_->set( i_, static_cast< result<T, E> >( r ) );
+        return *this;
+    }
+
+    basic_reference& operator=( result<T, E> const& r )
+    {
+        p_->set( i_, r );
+        return *this;
+    }
+
+    basic_reference& operator=( result<T, E>&& r )
+    {
+        p_->set( i_, std::move( r ) );
+        return *this;
+    }
+
+    // queries
+
+    bool has_value() const noexcept
+    {
+        return p_->has_value( i_ );
+    }
+
+    bool has_error() const noexcept
+    {
+        return p_->has_error( i_ );
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return has_value();
+    }
+
+    // checked value access
+
+    value_type& value() const
+    {
+        if( has_value() )
+        {
+            return p_->values_[ i_ ];
+        }
+        else
+        {
+            detail::throw_result_error( error() );
+        }
+    }
+
+    // unchecked value access
+
+    value_type* operator->() const noexcept
+    {
+        return has_value()? &p_->values_[ i_ ]: 0;
+    }
+
+    value_type& operator*() const noexcept
+    {
+        BOOST_ASSERT( has_value() );
+        return p_->values_[ i_ ];
+    }
+
+    // error access
+
+    error_type& error() const noexcept
+    {
+        BOOST_ASSERT( has_error() );
+        return p_->find_error_( i_ )->second;
+    }
+
+    E error_or_default() const
+    {
+        return has_error()? error(): E();
+    }
+
+    // conversions
+
+    operator result<T, E>() const
+    {
+        if( has_value() )
+        {
+            return result<T, E>( in_place_value, **this );
+        }
+        else
+        {
+            return result<T, E>( in_place_error, error() );
+        }
+    }
+
+    // equality
+
+    friend bool operator==( basic_reference const& r1, result<T, E> const& r2 )
+    {
+        return r1.has_value()? r2.has_value() && *r1 == *r2: r2.has_error() && r1.error() == r2.error();
+    }
+
+    friend bool operator!=( basic_reference const& r1, result<T, E> const& r2 )
+    {
+        return !( r1 == r2 );
+    }
+
+    template<class Ch, class Tr> friend std::basic_ostream<Ch, Tr>& operator<<( std::basic_ostream<Ch, Tr>& os, basic_reference const& r )
+    {
+        if( r.has_value() )
+        {
+            os << "value:" << *r;
+        }
+        else
+        {
+            os << "error:" << r.error();
+        }
+
+        return os;
+    }
+};
+
+// result_vector<T, E>::basic_iterator
+
+template<class T, class E> template<bool Const> class result_vector<T, E>::basic_iterator
+{
+private:
+
+    typedef typename std::conditional<Const, result_vector const, result_vector>::type container_type;
+
+    container_type* p_;
+    std::size_t i_;
+
+    friend class result_vector;
+
+    basic_iterator( container_type* p, std::size_t i ) noexcept: p_( p ), i_( i )
+    {
+    }
+
+public:
+
+    typedef std::input_iterator_tag iterator_category;
+    typedef result<T, E> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef basic_reference<Const> reference;
+    typedef void pointer;
+
+    basic_iterator() noexcept: p_( 0 ), i_( 0 )
+    {
+    }
+
+    reference operator*() const noexcept
+    {
+        return reference( p_, i_ );
+    }
+
+    basic_iterator& operator++() noexcept
+    {
+        ++i_;
+        return *this;
+    }
+
+    basic_iterator operator++( int ) noexcept
+    {
+        basic_iterator tmp( *this );
+        ++i_;
+        return tmp;
+    }
+
+    // the position of the element in the container
+    std::size_t index() const noexcept
+    {
+        return i_;
+    }
+
+    friend bool operator==( basic_iterator const& it1, basic_iterator const& it2 ) noexcept
+    {
+        return it1.i_ == it2.i_;
+    }
+
+    friend bool operator!=( basic_iterator const& it1, basic_iterator const& it2 ) noexcept
+    {
+        return it1.i_ != it2.i_;
+    }
+};
+
+} // namespace result
+} // namespace boost
+
+#endif // #ifndef BOOST_RESULT_RESULT_VECTOR_HPP_INCLUDED
@@ -0,0 +1,485 @@
+#ifndef BOOST_RESULT_TRACED_ERROR_CODE_HPP_INCLUDED
+#define BOOST_RESULT_TRACED_ERROR_CODE_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/compact_error_code.hpp>
+#include <boost/result/result.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <type_traits>
+#include <string>
+#include <atomic>
+#include <ostream>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+
+#if defined( __has_include )
+# if __has_include(<unwind.h>) && __has_include(<dlfcn.h>)
+#  include <unwind.h>
+#  include <dlfcn.h>
+#  define BOOST_RESULT_HAS_STACK_TRACE
+# endif
+# if __has_include(<cxxabi.h>)
+#  include <cxxabi.h>
+#  define BOOST_RESULT_HAS_CXXABI_DEMANGLE
+# endif
+#endif
+
+//
+// Sampled stack traces
+//
+// traced_error_code is a 16 byte error type, a compact_error_code and a
+// handle to a stack trace captured when the error was constructed from an
+// error value and a category. Capturing is off by default, and is enabled
+// per category with
+//
+//   set_stack_trace_sampling( my_category(), 100 );
+//
+// after which one in 100 errors of that category (counted per thread)
+// records the return addresses of its stack, with _Unwind_Backtrace.
+// The addresses are only symbolized, with dladdr, when the error is
+// written to a stream:
+//
+//   generic:5
+//       #0 0x55d0c1a2b3c4 in read_block(int)+0x24 (/usr/bin/server)
+//       #1 ...
+//
+// Names are only found for exported symbols; link executables with
+// -rdynamic, or give the module offsets to addr2line.
+//
+// The traces are kept in a fixed ring of BOOST_RESULT_STACK_TRACE_SLOTS
+// slots shared by all threads, so the error stays trivially copyable;
+// when more traces are captured before the error is printed, its trace
+// expires and is reported as such. On platforms without <unwind.h> and
+// <dlfcn.h>, no traces are captured.
+//
+
+#if !defined( BOOST_RESULT_STACK_TRACE_SLOTS )
+# define BOOST_RESULT_STACK_TRACE_SLOTS 64
+#endif
+
+#if !defined( BOOST_RESULT_STACK_TRACE_DEPTH )
+# define BOOST_RESULT_STACK_TRACE_DEPTH 32
+#endif
+
+namespace boost
+{
+namespace result
+{
+
+namespace detail
+{
+
+// per-category sampling rates, indexed as the category registry
+
+inline std::atomic<unsigned>* stack_trace_sampling_table() noexcept
+{
+    static std::atomic<unsigned> table[ BOOST_RESULT_MAX_ERROR_CATEGORIES ] = {};
+    return table;
+}
+
+// the ring of captured traces; each slot is guarded by a sequence lock
+// holding the ticket of the trace it contains
+
+class stack_trace_ring
+{
+private:
+
+    static constexpr std::uint64_t busy = ~std::uint64_t( 0 );
+
+    struct slot
+    {
+        std::atomic<std::uint64_t> seq;
+        std::atomic<std::size_t> size;
+        std::atomic<void*> frames[ BOOST_RESULT_STACK_TRACE_DEPTH ];
+    };
+
+    std::atomic<std::uint64_t> next_;
+    slot slots_[ BOOST_RESULT_STACK_TRACE_SLOTS ];
+
+public:
+
+    static constexpr std::size_t depth = BOOST_RESULT_STACK_TRACE_DEPTH;
+
+    // returns the ticket of the stored trace, 0 when the slot is busy
+
+    std::uint64_t store( void* const* frames, std::size_t n ) noexcept
+    {
+        std::uint64_t t = next_.fetch_add( 1, std::memory_order_relaxed ) + 1;
+        slot& s = slots_[ t % BOOST_RESULT_STACK_TRACE_SLOTS ];
+
+        std::uint64_t q = s.seq.load( std::memory_order_relaxed );
+
+        if( q == busy || !s.seq.compare_exchange_strong( q, busy, std::memory_order_acquire, std::memory_order_relaxed ) )
+        {
+            return 0;
+        }
+
+        std::atomic_thread_fence( std::memory_order_release );
+
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            s.frames[ i ].store( frames[ i ], std::memory_order_relaxed );
+        }
+
+        s.size.store( n, std::memory_order_relaxed );
+        s.seq.store( t, std::memory_order_release );
+
+        return t;
+    }
+
+    // copies the trace of ticket t into frames; returns 0 when expired
+
+    std::size_t load( std::uint64_t t, void** frames ) const noexcept
+    {
+        slot const& s = slots_[ t % BOOST_RESULT_STACK_TRACE_SLOTS ];
+
+        if( s.seq.load( std::memory_order_acquire ) != t ) return 0;
+
+        std::size_t n = s.size.load( std::memory_order_relaxed );
+
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            frames[ i ] = s.frames[ i ].load( std::memory_order_relaxed );
+        }
+
+        std::atomic_thread_fence( std::memory_order_acquire );
+
+        return s.seq.load( std::memory_order_relaxed ) == t? n: 0;
+    }
+
+    static stack_trace_ring& instance() noexcept
+    {
+        static stack_trace_ring ring;
+        return ring;
+    }
+};
+
+#if defined( BOOST_RESULT_HAS_STACK_TRACE )
+
+struct stack_trace_state
+{
+    void** frames;
+    std::size_t size;
+    std::size_t capacity;
+    std::size_t skip;
+};
+
+inline _Unwind_Reason_Code stack_trace_callback( _Unwind_Context* ctx, void* p )
+{
+    stack_trace_state& st = *static_cast<stack_trace_state*>( p );
+
+    if( st.skip > 0 )
+    {
+        --st.skip;
+        return _URC_NO_REASON;
+    }
+
+    void* ip = reinterpret_cast<void*>( _Unwind_GetIP( ctx ) );
+
+    if( ip == 0 || st.size == st.capacity ) return _URC_END_OF_STACK;
+
+    st.frames[ st.size++ ] = ip;
+    return _URC_NO_REASON;
+}
+
+// skips itself and the `skip` frames above it
+
+BOOST_NOINLINE inline std::size_t capture_stack_trace( void** frames, std::size_t n, std::size_t skip ) noexcept
+{
+    stack_trace_state st = { frames, 0, n, skip + 1 };
+    _Unwind_Backtrace( &stack_trace_callback, &st );
+    return st.size;
+}
+
+#endif
+
+// returns the ticket of the captured trace, or 0
+
+BOOST_NOINLINE BOOST_RESULT_COLD inline std::uint64_t sample_stack_trace( std::uint32_t cat ) noexcept
+{
+#if defined( BOOST_RESULT_HAS_STACK_TRACE )
+
+    unsigned n = stack_trace_sampling_table()[ cat ].load( std::memory_order_relaxed );
+
+    if( n == 0 ) return 0;
+
+    static thread_local unsigned counts[ BOOST_RESULT_MAX_ERROR_CATEGORIES ] = {};
+
+    if( ++counts[ cat ] < n ) return 0;
+
+    counts[ cat ] = 0;
+
+    void* frames[ stack_trace_ring::depth ];
+
+    // skip this function; traced_error_code::sample is inline
+    std::size_t m = capture_stack_trace( frames, stack_trace_ring::depth, 1 );
+
+    return stack_trace_ring::instance().store( frames, m );
+
+#else
+
+    (void)cat;
+    return 0;
+
+#endif
+}
+
+} // namespace detail
+
+// set_stack_trace_sampling( cat, n )
+//
+// Captures a stack trace for one in n traced_error_codes of category cat,
+// constructed on a given thread; 0 disables capturing, 1 captures always.
+
+inline void set_stack_trace_sampling( std::error_category const & cat, unsigned n )
+{
+    detail::stack_trace_sampling_table()[ register_error_category( cat ) ].store( n, std::memory_order_relaxed );
+}
+
+inline unsigned stack_trace_sampling( std::error_category const & cat )
+{
+    return detail::stack_trace_sampling_table()[ register_error_category( cat ) ].load( std::memory_order_relaxed );
+}
+
+// traced_error_code
+
+class traced_error_code
+{
+private:
+
+    compact_error_code code_;
+    std::uint64_t trace_;
+
+private:
+
+    // the category is already registered by code_, and the sampling rate
+    // is checked inline, so that nothing is called when sampling is off
+
+    void sample() noexcept
+    {
+        std::uint32_t cat = code_.category_index();
+
+        if( detail::stack_trace_sampling_table()[ cat ].load( std::memory_order_relaxed ) != 0 )
+        {
+            trace_ = detail::sample_stack_trace( cat );
+        }
+    }
+
+public:
+
+    // constructors; the ones taking an error value and a category sample
+    // a stack trace, the one from compact_error_code doesn't
+
+    constexpr traced_error_code() noexcept: code_(), trace_( 0 )
+    {
+    }
+
+    traced_error_code( int val, std::error_category const & cat ): code_( val, cat ), trace_( 0 )
+    {
+        sample();
+    }
+
+    traced_error_code( std::error_code const & ec ): code_( ec ), trace_( 0 )
+    {
+        sample();
+    }
+
+    template<class ErrorCodeEnum, class En = typename std::enable_if<
+        std::is_error_code_enum<ErrorCodeEnum>::value
+        >::type>
+    traced_error_code( ErrorCodeEnum e ): code_( e ), trace_( 0 )
+    {
+        sample();
+    }
+
+    traced_error_code( compact_error_code const & code ) noexcept: code_( code ), trace_( 0 )
+    {
+    }
+
+    // stack trace
+
+    bool has_stack_trace() const noexcept
+    {
+        return trace_ != 0;
+    }
+
+    // copies up to n return addresses, innermost first, into frames, and
+    // returns their number; 0 when there is no trace or it has expired
+
+    std::size_t stack_trace( void** frames, std::size_t n ) const noexcept
+    {
+        if( trace_ == 0 ) return 0;
+
+        void* tmp[ detail::stack_trace_ring::depth ];
+        std::size_t m = detail::stack_trace_ring::instance().load( trace_, tmp );
+
+        if( m > n ) m = n;
+
+        for( std::size_t i = 0; i < m; ++i )
+        {
+            frames[ i ] = tmp[ i ];
+        }
+
+        return m;
+    }
+
+    // modifiers
+
+    void clear() noexcept
+    {
+        code_.clear();
+        trace_ = 0;
+    }
+
+    // observers
+
+    compact_error_code code() const noexcept
+    {
+        return code_;
+    }
+
+    int value() const noexcept
+    {
+        return code_.value();
+    }
+
+    std::error_category const & category() const noexcept
+    {
+        return code_.category();
+    }
+
+    std::string message() const
+    {
+        return code_.message();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return static_cast<bool>( code_ );
+    }
+
+    // conversions
+
+    operator std::error_code() const noexcept
+    {
+        return code_;
+    }
+
+    // comparisons; the trace is not compared
+
+    friend bool operator==( traced_error_code const & e1, traced_error_code const & e2 ) noexcept
+    {
+        return e1.code_ == e2.code_;
+    }
+
+    friend bool operator!=( traced_error_code const & e1, traced_error_code const & e2 ) noexcept
+    {
+        return !( e1 == e2 );
+    }
+
+    friend bool operator==( traced_error_code const & e1, std::error_code const & e2 ) noexcept
+    {
+        return e1.code_ == e2;
+    }
+
+    friend bool operator==( std::error_code const & e1, traced_error_code const & e2 ) noexcept
+    {
+        return e2 == e1;
+    }
+
+    friend bool operator!=( traced_error_code const & e1, std::error_code const & e2 ) noexcept
+    {
+        return !( e1 == e2 );
+    }
+
+    friend bool operator!=( std::error_code const & e1, traced_error_code const & e2 ) noexcept
+    {
+        return !( e1 == e2 );
+    }
+
+    // writes the code and, when captured, the symbolized stack trace
+
+    friend std::ostream& operator<<( std::ostream& os, traced_error_code const & e )
+    {
+        os << e.code_;
+
+        if( e.trace_ == 0 ) return os;
+
+        void* frames[ detail::stack_trace_ring::depth ];
+        std::size_t n = e.stack_trace( frames, detail::stack_trace_ring::depth );
+
+        if( n == 0 )
+        {
+            os << " (stack trace expired)";
+            return os;
+        }
+
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            os << "\n    #" << i << ' ' << frames[ i ];
+
+#if defined( BOOST_RESULT_HAS_STACK_TRACE )
+
+            // frames[ i ] is a return address; look up the call before it
+
+            void* p = static_cast<char*>( frames[ i ] ) - 1;
+
+            Dl_info info;
+
+            if( dladdr( p, &info ) == 0 ) continue;
+
+            if( info.dli_sname )
+            {
+                char const* name = info.dli_sname;
+
+#if defined( BOOST_RESULT_HAS_CXXABI_DEMANGLE )
+
+                int status = 0;
+                char* demangled = abi::__cxa_demangle( name, 0, 0, &status );
+
+                if( demangled ) name = demangled;
+
+#endif
+
+                os << " in " << name << "+0x" << std::hex << static_cast<char*>( p ) + 1 - static_cast<char*>( info.dli_saddr ) << std::dec;
+
+#if defined( BOOST_RESULT_HAS_CXXABI_DEMANGLE )
+
+                std::free( demangled );
+
+#endif
+            }
+            else if( info.dli_fbase )
+            {
+                os << " at +0x" << std::hex << static_cast<char*>( p ) + 1 - static_cast<char*>( info.dli_fbase ) << std::dec;
+            }
+
+            if( info.dli_fname )
+            {
+                os << " (" << info.dli_fname << ')';
+            }
+
+#endif
+        }
+
+        return os;
+    }
+};
+
+// throw_exception_from_error_code
+
+BOOST_NORETURN inline void throw_exception_from_error_code( traced_error_code const & e )
+{
+    boost::throw_exception( std::system_error( e ) );
+}
+
+} // namespace result
+} // namespace boost
+
+#endif // #ifndef BOOST_RESULT_TRACED_ERROR_CODE_HPP_INCLUDED
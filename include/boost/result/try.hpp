@@ -0,0 +1,66 @@
+#ifndef BOOST_RESULT_TRY_HPP_INCLUDED
+#define BOOST_RESULT_TRY_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result.hpp>
+#include <boost/config.hpp>
+#include <utility>
+
+// BOOST_RESULT_TRY( var, expr )
+// BOOST_RESULT_TRY( expr )
+//
+// Evaluates expr, a result. When it holds an error, returns the error from
+// the enclosing function, whose return type is a result<T2, E2>, converting
+// it with error_converter<E, E2>. Otherwise, initializes var with the value.
+// The second form discards the value, and is the one to use for result<void>.
+//
+//   BOOST_RESULT_TRY( auto x, parse_int( s ) );
+//   BOOST_RESULT_TRY( std::string const& name, lookup( x ) );
+//   BOOST_RESULT_TRY( validate( name ) );
+//
+// The value is moved out when expr is an rvalue, and copied otherwise. Only
+// one BOOST_RESULT_TRY can appear on a single line.
+
+#define BOOST_RESULT_TRY_IMPL( var, expr, tmp ) \
+    auto&& tmp = expr; \
+    if( BOOST_UNLIKELY( !tmp.has_value() ) ) return ::boost::result::detail::propagate_error( std::forward<decltype(tmp)>( tmp ) ); \
+    var = *std::forward<decltype(tmp)>( tmp )
+
+#define BOOST_RESULT_TRY_IMPL_1( expr, tmp ) \
+    auto&& tmp = expr; \
+    if( BOOST_UNLIKELY( !tmp.has_value() ) ) return ::boost::result::detail::propagate_error( std::forward<decltype(tmp)>( tmp ) )
+
+#define BOOST_RESULT_TRY_2( var, expr ) BOOST_RESULT_TRY_IMPL( var, expr, BOOST_JOIN( boost_result_try_, __LINE__ ) )
+#define BOOST_RESULT_TRY_1( expr ) BOOST_RESULT_TRY_IMPL_1( expr, BOOST_JOIN( boost_result_try_, __LINE__ ) )
+
+#define BOOST_RESULT_TRY_EXPAND( x ) x
+#define BOOST_RESULT_TRY_SELECT( a1, a2, m, ... ) m
+
+#define BOOST_RESULT_TRY( ... ) BOOST_RESULT_TRY_EXPAND( BOOST_RESULT_TRY_SELECT( __VA_ARGS__, BOOST_RESULT_TRY_2, BOOST_RESULT_TRY_1, _ )( __VA_ARGS__ ) )
+
+// BOOST_RESULT_TRY_EXPR( expr )
+//
+// An expression form of BOOST_RESULT_TRY that evaluates to the value (by
+// value, also for result<U&, E>), or to void for result<void, E>. Needs
+// statement expressions, a GCC extension also supported by Clang; when it
+// is available, BOOST_RESULT_HAS_TRY_EXPR is defined.
+//
+//   int x = BOOST_RESULT_TRY_EXPR( parse_int( s ) ) + 1;
+
+#if defined( __GNUC__ )
+
+#define BOOST_RESULT_HAS_TRY_EXPR
+
+#define BOOST_RESULT_TRY_EXPR( expr ) \
+    __extension__ ({ \
+        auto&& boost_result_try_tmp = expr; \
+        if( BOOST_UNLIKELY( !boost_result_try_tmp.has_value() ) ) return ::boost::result::detail::propagate_error( std::forward<decltype(boost_result_try_tmp)>( boost_result_try_tmp ) ); \
+        *std::forward<decltype(boost_result_try_tmp)>( boost_result_try_tmp ); \
+    })
+
+#endif
+
+#endif // #ifndef BOOST_RESULT_TRY_HPP_INCLUDED
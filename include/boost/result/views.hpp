@@ -0,0 +1,761 @@
+#ifndef BOOST_RESULT_VIEWS_HPP_INCLUDED
+#define BOOST_RESULT_VIEWS_HPP_INCLUDED
+
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result.hpp>
+#include <boost/config.hpp>
+#include <type_traits>
+#include <iterator>
+#include <utility>
+#include <new>
+
+#if defined(__has_include)
+# if __has_include(<version>)
+#  include <version>
+# endif
+#endif
+
+#if defined(__cpp_lib_ranges) && __cpp_lib_ranges >= 201911L
+# include <ranges>
+# define BOOST_RESULT_HAS_STD_RANGES
+#endif
+
+//
+// Lazy views over ranges of results
+//
+// views::values          the values of the results holding one
+// views::errors          the errors of the results holding one
+// views::take_while_ok   the values up to the first error
+// views::and_then( f )   r.and_then( f ) for each element r
+//
+// Each adaptor can be applied as views::values( r ), as r | views::values,
+// or to an iterator pair as views::values( first, last ). An lvalue range
+// is referred to, an rvalue range is moved into the view.
+//
+// The values and errors are yielded by reference when the underlying
+// range yields references, as a container of results does, and by value
+// when it yields prvalues, as views::and_then does. As with a filter over
+// a transform in std::ranges, views::values and views::errors dereference
+// such an element twice, once to test it and once to yield it.
+//
+// When BOOST_RESULT_HAS_STD_RANGES is defined, the views model
+// std::ranges::view and compose with the standard adaptors.
+//
+
+namespace boost
+{
+namespace result
+{
+
+namespace detail
+{
+
+template<class V> using view_iterator = decltype( std::begin( std::declval<V&>() ) );
+template<class V> using view_sentinel = decltype( std::end( std::declval<V&>() ) );
+
+#if defined(BOOST_RESULT_HAS_STD_RANGES)
+
+template<class D> using view_base = std::ranges::view_interface<D>;
+
+#else
+
+template<class D> struct view_base
+{
+};
+
+#endif
+
+// the underlying range of a view
+
+template<class R> class range_ref: public view_base< range_ref<R> >
+{
+private:
+
+    R* p_;
+
+public:
+
+    range_ref() noexcept: p_( nullptr )
+    {
+    }
+
+    explicit range_ref( R& r ) noexcept: p_( &r )
+    {
+    }
+
+    view_iterator<R> begin() const
+    {
+        return std::begin( *p_ );
+    }
+
+    view_sentinel<R> end() const
+    {
+        return std::end( *p_ );
+    }
+};
+
+template<class It> class iterator_range: public view_base< iterator_range<It> >
+{
+private:
+
+    It first_;
+    It last_;
+
+public:
+
+    iterator_range() = default;
+
+    iterator_range( It first, It last ): first_( first ), last_( last )
+    {
+    }
+
+    It begin() const
+    {
+        return first_;
+    }
+
+    It end() const
+    {
+        return last_;
+    }
+};
+
+template<class R> using view_all_t = typename std::conditional<
+    std::is_lvalue_reference<R>::value,
+    range_ref<typename std::remove_reference<R>::type>,
+    remove_cvref<R>
+>::type;
+
+template<class R> range_ref<R> view_all( R& r ) noexcept
+{
+    return range_ref<R>( r );
+}
+
+template<class R, class En = typename std::enable_if<!std::is_lvalue_reference<R>::value>::type> R view_all( R&& r )
+{
+    return std::move( r );
+}
+
+// returned by end() when the underlying range has a sentinel type
+// different from its iterator type
+
+struct view_end_t
+{
+};
+
+template<class V, class I> using view_end = typename std::conditional<
+    std::is_same< view_iterator<V>, view_sentinel<V> >::value, I, view_end_t>::type;
+
+template<class It> using view_difference_type = typename std::iterator_traits<It>::difference_type;
+
+template<class It> using view_iterator_category = typename std::conditional<
+    std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>::value,
+    std::forward_iterator_tag, std::input_iterator_tag>::type;
+
+// what *it yields for the element x of type X; by value when x is a prvalue result
+
+template<class X, bool Owned = !std::is_reference<X>::value && is_result<X>::value> struct project_value
+{
+    using type = decltype( *std::declval<X&>() );
+
+    static type get( X& x )
+    {
+        return *x;
+    }
+};
+
+template<class X> struct project_value<X, true>
+{
+    using type = typename is_result<X>::value_type;
+
+    static type get( X& x )
+    {
+        return std::move( *x );
+    }
+};
+
+template<class X, bool Owned = !std::is_reference<X>::value && is_result<X>::value> struct project_error
+{
+    using type = decltype( std::declval<X&>().error() );
+
+    static type get( X& x )
+    {
+        return x.error();
+    }
+};
+
+template<class X> struct project_error<X, true>
+{
+    using type = typename is_result<X>::error_type;
+
+    static type get( X& x )
+    {
+        return std::move( x.error() );
+    }
+};
+
+struct values_policy
+{
+    template<class X> static bool accept( X const& x ) noexcept
+    {
+        return x.has_value();
+    }
+
+    template<class X> using projection = project_value<X>;
+};
+
+struct errors_policy
+{
+    template<class X> static bool accept( X const& x ) noexcept
+    {
+        return x.has_error();
+    }
+
+    template<class X> using projection = project_error<X>;
+};
+
+// filter_view: the values or the errors of V, per P
+
+template<class V, class P> class filter_view: public view_base< filter_view<V, P> >
+{
+private:
+
+    using base_iterator = view_iterator<V>;
+    using base_sentinel = view_sentinel<V>;
+    using base_reference = decltype( *std::declval<base_iterator const&>() );
+    using projection = typename P::template projection<base_reference>;
+
+    V base_;
+
+public:
+
+    class iterator
+    {
+    private:
+
+        base_iterator it_;
+        base_sentinel last_;
+
+        void satisfy()
+        {
+            while( !( it_ == last_ ) && !P::accept( *it_ ) ) ++it_;
+        }
+
+    public:
+
+        using reference = typename projection::type;
+        using value_type = remove_cvref<reference>;
+        using difference_type = view_difference_type<base_iterator>;
+        using pointer = void;
+        using iterator_category = view_iterator_category<base_iterator>;
+
+        iterator() = default;
+
+        iterator( base_iterator it, base_sentinel last ): it_( it ), last_( last )
+        {
+            satisfy();
+        }
+
+        reference operator*() const
+        {
+            base_reference x = *it_;
+            return projection::get( x );
+        }
+
+        iterator& operator++()
+        {
+            ++it_;
+            satisfy();
+
+            return *this;
+        }
+
+        iterator operator++( int )
+        {
+            iterator tmp( *this );
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==( iterator const& i1, iterator const& i2 )
+        {
+            return i1.it_ == i2.it_;
+        }
+
+        friend bool operator!=( iterator const& i1, iterator const& i2 )
+        {
+            return !( i1 == i2 );
+        }
+
+        friend bool operator==( iterator const& i, view_end_t )
+        {
+            return i.it_ == i.last_;
+        }
+
+        friend bool operator!=( iterator const& i, view_end_t )
+        {
+            return !( i.it_ == i.last_ );
+        }
+
+        friend bool operator==( view_end_t, iterator const& i )
+        {
+            return i.it_ == i.last_;
+        }
+
+        friend bool operator!=( view_end_t, iterator const& i )
+        {
+            return !( i.it_ == i.last_ );
+        }
+    };
+
+    filter_view() = default;
+
+    explicit filter_view( V base ): base_( std::move( base ) )
+    {
+    }
+
+    V base() const
+    {
+        return base_;
+    }
+
+    iterator begin()
+    {
+        return iterator( std::begin( base_ ), std::end( base_ ) );
+    }
+
+    view_end<V, iterator> end()
+    {
+        return end_( std::is_same<base_iterator, base_sentinel>() );
+    }
+
+private:
+
+    iterator end_( std::true_type )
+    {
+        return iterator( std::end( base_ ), std::end( base_ ) );
+    }
+
+    view_end_t end_( std::false_type ) noexcept
+    {
+        return view_end_t();
+    }
+};
+
+// take_while_ok_view: the values of V up to its first error
+
+template<class V> class take_while_ok_view: public view_base< take_while_ok_view<V> >
+{
+private:
+
+    using base_iterator = view_iterator<V>;
+    using base_sentinel = view_sentinel<V>;
+    using base_reference = decltype( *std::declval<base_iterator const&>() );
+    using projection = project_value<base_reference>;
+
+    V base_;
+
+public:
+
+    class iterator
+    {
+    private:
+
+        base_iterator it_;
+        base_sentinel last_;
+        bool done_;
+
+        void satisfy()
+        {
+            done_ = it_ == last_ || ( *it_ ).has_error();
+        }
+
+    public:
+
+        using reference = typename projection::type;
+        using value_type = remove_cvref<reference>;
+        using difference_type = view_difference_type<base_iterator>;
+        using pointer = void;
+        using iterator_category = view_iterator_category<base_iterator>;
+
+        iterator(): it_(), last_(), done_( true )
+        {
+        }
+
+        iterator( base_iterator it, base_sentinel last ): it_( it ), last_( last ), done_( false )
+        {
+            satisfy();
+        }
+
+        iterator( base_iterator it, base_sentinel last, int ) noexcept: it_( it ), last_( last ), done_( true )
+        {
+        }
+
+        reference operator*() const
+        {
+            base_reference x = *it_;
+            return projection::get( x );
+        }
+
+        iterator& operator++()
+        {
+            ++it_;
+            satisfy();
+
+            return *this;
+        }
+
+        iterator operator++( int )
+        {
+            iterator tmp( *this );
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==( iterator const& i1, iterator const& i2 )
+        {
+            return i1.done_ || i2.done_? i1.done_ && i2.done_: i1.it_ == i2.it_;
+        }
+
+        friend bool operator!=( iterator const& i1, iterator const& i2 )
+        {
+            return !( i1 == i2 );
+        }
+
+        friend bool operator==( iterator const& i, view_end_t ) noexcept
+        {
+            return i.done_;
+        }
+
+        friend bool operator!=( iterator const& i, view_end_t ) noexcept
+        {
+            return !i.done_;
+        }
+
+        friend bool operator==( view_end_t, iterator const& i ) noexcept
+        {
+            return i.done_;
+        }
+
+        friend bool operator!=( view_end_t, iterator const& i ) noexcept
+        {
+            return !i.done_;
+        }
+    };
+
+    take_while_ok_view() = default;
+
+    explicit take_while_ok_view( V base ): base_( std::move( base ) )
+    {
+    }
+
+    V base() const
+    {
+        return base_;
+    }
+
+    iterator begin()
+    {
+        return iterator( std::begin( base_ ), std::end( base_ ) );
+    }
+
+    view_end<V, iterator> end()
+    {
+        return end_( std::is_same<base_iterator, base_sentinel>() );
+    }
+
+private:
+
+    iterator end_( std::true_type )
+    {
+        return iterator( std::end( base_ ), std::end( base_ ), 0 );
+    }
+
+    view_end_t end_( std::false_type ) noexcept
+    {
+        return view_end_t();
+    }
+};
+
+// and_then over the elements of a range; an element that isn't a result,
+// such as a result_vector reference, is converted to the value_type of
+// the range first, unless that isn't a result either, in which case f is
+// simply applied to it
+
+template<class Z, class X, class F> auto and_then_value( X&& x, F const& f, std::true_type ) -> decltype( Z( std::forward<X>( x ) ).and_then( f ) )
+{
+    return Z( std::forward<X>( x ) ).and_then( f );
+}
+
+template<class Z, class X, class F> auto and_then_value( X&& x, F const& f, std::false_type ) -> decltype( f( std::forward<X>( x ) ) )
+{
+    return f( std::forward<X>( x ) );
+}
+
+template<class V, class X, class F> auto and_then_element( X&& x, F const& f, std::true_type ) -> decltype( std::forward<X>( x ).and_then( f ) )
+{
+    return std::forward<X>( x ).and_then( f );
+}
+
+template<class V, class X, class F, class Z = typename std::iterator_traits< view_iterator<V> >::value_type>
+auto and_then_element( X&& x, F const& f, std::false_type ) -> decltype( and_then_value<Z>( std::forward<X>( x ), f, is_result<Z>() ) )
+{
+    return and_then_value<Z>( std::forward<X>( x ), f, is_result<Z>() );
+}
+
+// holds the function of an and_then_view so that the view stays
+// assignable, as std::ranges::view requires, when F is a lambda
+
+template<class F, bool Assignable = std::is_copy_assignable<F>::value || !std::is_nothrow_copy_constructible<F>::value> class view_function
+{
+private:
+
+    F f_;
+
+public:
+
+    explicit view_function( F const& f ): f_( f )
+    {
+    }
+
+    F const& get() const noexcept
+    {
+        return f_;
+    }
+};
+
+template<class F> class view_function<F, false>
+{
+private:
+
+    union
+    {
+        F f_;
+    };
+
+public:
+
+    explicit view_function( F const& f ): f_( f )
+    {
+    }
+
+    view_function( view_function const& r ) noexcept: f_( r.f_ )
+    {
+    }
+
+    view_function& operator=( view_function const& r ) noexcept
+    {
+        if( this != &r )
+        {
+            f_.~F();
+            ::new( static_cast<void*>( &f_ ) ) F( r.f_ );
+        }
+
+        return *this;
+    }
+
+    ~view_function()
+    {
+        f_.~F();
+    }
+
+    F const& get() const noexcept
+    {
+        return f_;
+    }
+};
+
+template<class V, class F> class and_then_view: public view_base< and_then_view<V, F> >
+{
+private:
+
+    using base_iterator = view_iterator<V>;
+    using base_sentinel = view_sentinel<V>;
+    using base_reference = decltype( *std::declval<base_iterator const&>() );
+    using is_result_element = is_result< remove_cvref<base_reference> >;
+
+    V base_;
+    view_function<F> f_;
+
+public:
+
+    class iterator
+    {
+    private:
+
+        base_iterator it_;
+        base_sentinel last_;
+        F const* f_;
+
+    public:
+
+        using reference = decltype( and_then_element<V>( std::declval<base_reference>(), std::declval<F const&>(), is_result_element() ) );
+        using value_type = remove_cvref<reference>;
+        using difference_type = view_difference_type<base_iterator>;
+        using pointer = void;
+        using iterator_category = std::input_iterator_tag;
+
+        iterator(): it_(), last_(), f_( nullptr )
+        {
+        }
+
+        iterator( base_iterator it, base_sentinel last, F const* f ): it_( it ), last_( last ), f_( f )
+        {
+        }
+
+        reference operator*() const
+        {
+            return and_then_element<V>( *it_, *f_, is_result_element() );
+        }
+
+        iterator& operator++()
+        {
+            ++it_;
+            return *this;
+        }
+
+        iterator operator++( int )
+        {
+            iterator tmp( *this );
+            ++it_;
+            return tmp;
+        }
+
+        friend bool operator==( iterator const& i1, iterator const& i2 )
+        {
+            return i1.it_ == i2.it_;
+        }
+
+        friend bool operator!=( iterator const& i1, iterator const& i2 )
+        {
+            return !( i1 == i2 );
+        }
+
+        friend bool operator==( iterator const& i, view_end_t )
+        {
+            return i.it_ == i.last_;
+        }
+
+        friend bool operator!=( iterator const& i, view_end_t )
+        {
+            return !( i.it_ == i.last_ );
+        }
+
+        friend bool operator==( view_end_t, iterator const& i )
+        {
+            return i.it_ == i.last_;
+        }
+
+        friend bool operator!=( view_end_t, iterator const& i )
+        {
+            return !( i.it_ == i.last_ );
+        }
+    };
+
+    and_then_view( V base, F const& f ): base_( std::move( base ) ), f_( f )
+    {
+    }
+
+    V base() const
+    {
+        return base_;
+    }
+
+    iterator begin()
+    {
+        return iterator( std::begin( base_ ), std::end( base_ ), &f_.get() );
+    }
+
+    view_end<V, iterator> end()
+    {
+        return end_( std::is_same<base_iterator, base_sentinel>() );
+    }
+
+private:
+
+    iterator end_( std::true_type )
+    {
+        return iterator( std::end( base_ ), std::end( base_ ), &f_.get() );
+    }
+
+    view_end_t end_( std::false_type ) noexcept
+    {
+        return view_end_t();
+    }
+};
+
+// adaptor objects
+
+template<template<class> class View> struct view_adaptor
+{
+    template<class R> View< view_all_t<R> > operator()( R&& r ) const
+    {
+        return View< view_all_t<R> >( view_all( std::forward<R>( r ) ) );
+    }
+
+    template<class It> View< iterator_range<It> > operator()( It first, It last ) const
+    {
+        return View< iterator_range<It> >( iterator_range<It>( first, last ) );
+    }
+
+    template<class R> friend View< view_all_t<R> > operator|( R&& r, view_adaptor const& a )
+    {
+        return a( std::forward<R>( r ) );
+    }
+};
+
+template<class V> using values_view_ = filter_view<V, values_policy>;
+template<class V> using errors_view_ = filter_view<V, errors_policy>;
+
+template<class F> struct and_then_closure
+{
+    F f_;
+
+    template<class R> friend and_then_view<view_all_t<R>, F> operator|( R&& r, and_then_closure const& c )
+    {
+        return and_then_view<view_all_t<R>, F>( view_all( std::forward<R>( r ) ), c.f_ );
+    }
+};
+
+struct and_then_adaptor
+{
+    template<class F> and_then_closure<typename std::decay<F>::type> operator()( F&& f ) const
+    {
+        return and_then_closure<typename std::decay<F>::type>{ std::forward<F>( f ) };
+    }
+
+    template<class R, class F> and_then_view<view_all_t<R>, typename std::decay<F>::type> operator()( R&& r, F&& f ) const
+    {
+        return and_then_view<view_all_t<R>, typename std::decay<F>::type>( view_all( std::forward<R>( r ) ), f );
+    }
+
+    template<class It, class F> and_then_view<iterator_range<It>, typename std::decay<F>::type> operator()( It first, It last, F&& f ) const
+    {
+        return and_then_view<iterator_range<It>, typename std::decay<F>::type>( iterator_range<It>( first, last ), f );
+    }
+};
+
+} // namespace detail
+
+template<class V> using values_view = detail::filter_view<V, detail::values_policy>;
+template<class V> using errors_view = detail::filter_view<V, detail::errors_policy>;
+using detail::take_while_ok_view;
+using detail::and_then_view;
+
+namespace views
+{
+
+BOOST_INLINE_CONSTEXPR detail::view_adaptor<detail::values_view_> values{};
+BOOST_INLINE_CONSTEXPR detail::view_adaptor<detail::errors_view_> errors{};
+BOOST_INLINE_CONSTEXPR detail::view_adaptor<detail::take_while_ok_view> take_while_ok{};
+BOOST_INLINE_CONSTEXPR detail::and_then_adaptor and_then{};
+
+} // namespace views
+
+} // namespace result
+} // namespace boost
+
+#endif // #ifndef BOOST_RESULT_VIEWS_HPP_INCLUDED
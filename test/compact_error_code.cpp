@@ -0,0 +1,131 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/compact_error_code.hpp>
+#include <boost/result/result.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/core/lightweight_test_trait.hpp>
+#include <system_error>
+#include <type_traits>
+#include <string>
+#include <ios>
+#include <cerrno>
+
+using namespace boost::result;
+
+class my_category: public std::error_category
+{
+public:
+
+    char const* name() const noexcept override
+    {
+        return "my";
+    }
+
+    std::string message( int ev ) const override
+    {
+        return "my error " + std::to_string( ev );
+    }
+};
+
+my_category const& my_cat()
+{
+    static my_category const instance;
+    return instance;
+}
+
+int main()
+{
+    BOOST_TEST_EQ( sizeof( compact_error_code ), 8 );
+    BOOST_TEST_TRAIT_TRUE((std::is_trivially_copyable<compact_error_code>));
+
+    {
+        compact_error_code e;
+
+        BOOST_TEST_EQ( e.value(), 0 );
+        BOOST_TEST( e.category() == std::system_category() );
+        BOOST_TEST( !e );
+
+        BOOST_TEST( e == std::error_code() );
+        BOOST_TEST( std::error_code() == e );
+        BOOST_TEST_EQ( std::error_code( e ), std::error_code() );
+    }
+
+    {
+        std::error_code ec( EINVAL, std::generic_category() );
+        compact_error_code e( ec );
+
+        BOOST_TEST_EQ( e.value(), EINVAL );
+        BOOST_TEST( e.category() == std::generic_category() );
+        BOOST_TEST( e );
+
+        BOOST_TEST( e == ec );
+        BOOST_TEST( ec == e );
+        BOOST_TEST_NOT( e != ec );
+        BOOST_TEST_EQ( std::error_code( e ), ec );
+        BOOST_TEST_EQ( e.message(), ec.message() );
+    }
+
+    {
+        compact_error_code e = std::io_errc::stream;
+        BOOST_TEST( e == make_error_code( std::io_errc::stream ) );
+    }
+
+    {
+        std::error_code ec( 5, my_cat() );
+        compact_error_code e1( ec );
+        compact_error_code e2( 5, my_cat() );
+        compact_error_code e3( 5, std::generic_category() );
+
+        BOOST_TEST( e1.category() == my_cat() );
+        BOOST_TEST_EQ( e1.value(), 5 );
+        BOOST_TEST_EQ( std::error_code( e1 ), ec );
+        BOOST_TEST_EQ( e1.message(), "my error 5" );
+
+        BOOST_TEST_EQ( e1, e2 );
+        BOOST_TEST_NE( e1, e3 );
+        BOOST_TEST( e3 != ec );
+
+        BOOST_TEST_EQ( register_error_category( my_cat() ), register_error_category( my_cat() ) );
+    }
+
+    {
+#if !defined(BOOST_RESULT_HAS_SOURCE_LOCATION)
+
+        // the site of the error would take a third word
+
+        BOOST_TEST_LE( sizeof( result<int, compact_error_code> ), 16 );
+        BOOST_TEST_LE( sizeof( result<int*, compact_error_code> ), 16 );
+
+#endif
+
+        BOOST_TEST_TRAIT_TRUE((std::is_trivially_copyable< result<int, compact_error_code> >));
+    }
+
+    {
+        result<int, compact_error_code> r( ENOENT, std::generic_category() );
+
+        BOOST_TEST( r.has_error() );
+        BOOST_TEST( r.error() == std::error_code( ENOENT, std::generic_category() ) );
+
+        BOOST_TEST_THROWS( r.value(), std::system_error );
+
+        try
+        {
+            r.value();
+        }
+        catch( std::system_error const& x )
+        {
+            BOOST_TEST_EQ( x.code(), std::error_code( ENOENT, std::generic_category() ) );
+        }
+    }
+
+    {
+        result<int, compact_error_code> r( 1 );
+
+        BOOST_TEST_EQ( r.value(), 1 );
+    }
+
+    return boost::report_errors();
+}
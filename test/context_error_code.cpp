@@ -0,0 +1,246 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/context_error_code.hpp>
+#include <boost/result/result.hpp>
+#include <boost/result/try.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/core/lightweight_test_trait.hpp>
+#include <system_error>
+#include <type_traits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <cstring>
+#include <cerrno>
+
+using namespace boost::result;
+
+result<int> read_block( int offset )
+{
+    if( offset >= 4096 ) return std::error_code( EIO, std::generic_category() );
+    return offset / 512;
+}
+
+result<int, context_error_code> read_header( std::string const& path, int offset )
+{
+    auto r = with_context( read_block( offset ), "read_block", path, offset );
+
+    BOOST_RESULT_TRY( int x, r );
+
+    return x + 1;
+}
+
+result<int, context_error_code> load_config( std::string const& path )
+{
+    return with_context( read_header( path, 8192 ), "load_config" );
+}
+
+int main()
+{
+    BOOST_TEST_EQ( sizeof( context_error_code ), 16 );
+    BOOST_TEST_TRAIT_TRUE((std::is_trivially_copyable<context_error_code>));
+
+    BOOST_TEST_EQ( sizeof( result<int, context_error_code> ), sizeof( result<int> ) );
+    BOOST_TEST_TRAIT_TRUE((std::is_trivially_copyable< result<int, context_error_code> >));
+
+    {
+        context_error_code e;
+
+        BOOST_TEST( !e );
+        BOOST_TEST( e == std::error_code() );
+        BOOST_TEST( e.context() == 0 );
+        BOOST_TEST_EQ( e.context_message(), "" );
+    }
+
+    {
+        error_context_scope scope;
+
+        std::error_code ec( ENOENT, std::generic_category() );
+
+        context_error_code e( ec );
+
+        BOOST_TEST( e );
+        BOOST_TEST_EQ( e.value(), ENOENT );
+        BOOST_TEST( e.category() == std::generic_category() );
+        BOOST_TEST( e == ec );
+        BOOST_TEST( ec == e );
+        BOOST_TEST_EQ( std::error_code( e ), ec );
+        BOOST_TEST_EQ( e.message(), ec.message() );
+
+        e.add_context( "open" );
+
+        context_error_code e2( e );
+
+        e.add_context( "read", std::string( "data.bin" ), 4096 );
+
+        BOOST_TEST( e.context() != 0 );
+        BOOST_TEST_EQ( std::strcmp( e.context()->operation, "read" ), 0 );
+        BOOST_TEST_EQ( std::strcmp( e.context()->key, "data.bin" ), 0 );
+        BOOST_TEST_EQ( e.context()->offset, 4096 );
+        BOOST_TEST( e.context()->next == e2.context() );
+
+        BOOST_TEST_EQ( e.context_message(), "in read 'data.bin' at 4096, in open" );
+        BOOST_TEST_EQ( e2.context_message(), "in open" );
+
+        // the context is not compared
+
+        BOOST_TEST( e == e2 );
+        BOOST_TEST( e == ec );
+
+        std::ostringstream os;
+        os << e;
+
+        BOOST_TEST_EQ( os.str(), "generic:" + std::to_string( ENOENT ) + " (in read 'data.bin' at 4096, in open)" );
+    }
+
+    {
+        error_context_scope scope;
+
+        result<int, context_error_code> r = load_config( "app.cfg" );
+
+        BOOST_TEST( r.has_error() );
+        BOOST_TEST( r.error() == std::error_code( EIO, std::generic_category() ) );
+        BOOST_TEST_EQ( r.error().context_message(), "in load_config, in read_block 'app.cfg' at 8192" );
+
+        BOOST_TEST_THROWS( r.value(), std::system_error );
+
+        try
+        {
+            r.value();
+        }
+        catch( std::system_error const& x )
+        {
+            BOOST_TEST_EQ( x.code(), std::error_code( EIO, std::generic_category() ) );
+            BOOST_TEST( std::string( x.what() ).find( "in load_config, in read_block 'app.cfg' at 8192" ) != std::string::npos );
+        }
+    }
+
+    {
+        // success doesn't touch the arena
+
+        std::size_t n = error_context_arena::instance().size();
+
+        result<int, context_error_code> r = read_header( "app.cfg", 1024 );
+
+        BOOST_TEST_EQ( r.value(), 3 );
+        BOOST_TEST_EQ( error_context_arena::instance().size(), n );
+    }
+
+    {
+        result<void> r;
+        result<void, context_error_code> r2 = with_context( r, "void" );
+
+        BOOST_TEST( r2.has_value() );
+
+        r = std::make_error_code( std::errc::invalid_argument );
+        r2 = with_context( r, "void" );
+
+        BOOST_TEST( r2.has_error() );
+        BOOST_TEST( r2.error() == std::errc::invalid_argument );
+        BOOST_TEST_EQ( r2.error().context_message(), "in void" );
+
+        error_context_arena::instance().reset();
+    }
+
+    {
+        // scopes release their records, and nest
+
+        error_context_arena& arena = error_context_arena::instance();
+
+        std::size_t n0 = arena.size();
+
+        {
+            error_context_scope s1;
+
+            context_error_code e( EINVAL, std::generic_category() );
+            e.add_context( "outer" );
+
+            std::size_t n1 = arena.size();
+            BOOST_TEST_GT( n1, n0 );
+
+            {
+                error_context_scope s2;
+
+                // enough to need more blocks
+
+                for( int i = 0; i < 1000; ++i )
+                {
+                    context_error_code e2( e );
+                    e2.add_context( "inner", std::string( 100, 'x' ) );
+                }
+
+                BOOST_TEST_GT( arena.size(), n1 + 100000 );
+            }
+
+            BOOST_TEST_EQ( arena.size(), n1 );
+            BOOST_TEST_EQ( e.context_message(), "in outer" );
+        }
+
+        BOOST_TEST_EQ( arena.size(), n0 );
+        BOOST_TEST_EQ( arena.dropped(), 0 );
+    }
+
+    {
+        // size() counts the records only, not the block headers or the
+        // space left at the end of a block
+
+        error_context_arena& arena = error_context_arena::instance();
+
+        error_context_scope scope;
+
+        std::size_t n0 = arena.size();
+
+        context_error_code e( EINVAL, std::generic_category() );
+        e.add_context( "op", std::string( 100, 'x' ) );
+
+        std::size_t m = arena.size() - n0;
+        BOOST_TEST_GE( m, 101u );
+
+        for( int i = 0; i < 1000; ++i )
+        {
+            context_error_code e2( e );
+            e2.add_context( "op", std::string( 100, 'y' ) );
+        }
+
+        BOOST_TEST_EQ( arena.size(), n0 + 1001 * m );
+    }
+
+    {
+        // a null key is treated as ""
+
+        error_context_scope scope;
+
+        context_error_code e( EINVAL, std::generic_category() );
+        e.add_context( "op", static_cast<char const*>( 0 ), 5 );
+
+        if( BOOST_TEST( e.context() != 0 ) )
+        {
+            BOOST_TEST_CSTR_EQ( e.context()->key, "" );
+            BOOST_TEST_EQ( e.context()->offset, 5u );
+        }
+    }
+
+    {
+        // each thread has its own arena
+
+        std::size_t n = error_context_arena::instance().size();
+
+        std::thread th( []{
+
+            error_context_scope scope;
+
+            context_error_code e( EINVAL, std::generic_category() );
+            e.add_context( "thread" );
+
+            BOOST_TEST_EQ( e.context_message(), "in thread" );
+        });
+
+        th.join();
+
+        BOOST_TEST_EQ( error_context_arena::instance().size(), n );
+    }
+
+    return boost::report_errors();
+}
@@ -0,0 +1,222 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/error_logger.hpp>
+#include <boost/result/compact_error_code.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <system_error>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ios>
+#include <cerrno>
+
+using namespace boost::result;
+
+static std::vector<std::string> lines_of( std::ostringstream const& os )
+{
+    std::vector<std::string> r;
+
+    std::istringstream is( os.str() );
+
+    for( std::string line; std::getline( is, line ); )
+    {
+        r.push_back( line );
+    }
+
+    return r;
+}
+
+static bool ends_with( std::string const& s, std::string const& t )
+{
+    return s.size() >= t.size() && s.compare( s.size() - t.size(), t.size(), t ) == 0;
+}
+
+// log( r ) writes the site of the error, when it's recorded
+
+template<class R> static std::string site_of( R const& r )
+{
+#if defined(BOOST_RESULT_HAS_SOURCE_LOCATION)
+
+    std::source_location loc = r.error_location();
+    return std::string( " at " ) + loc.file_name() + ":" + std::to_string( loc.line() ) + " in " + loc.function_name();
+
+#else
+
+    (void)r;
+    return std::string();
+
+#endif
+}
+
+static bool has_time( std::string const& s )
+{
+    // 2021-06-01 12:00:00.123456
+
+    return s.size() > 26 && s[ 4 ] == '-' && s[ 7 ] == '-' && s[ 10 ] == ' ' && s[ 13 ] == ':' && s[ 16 ] == ':' && s[ 19 ] == '.' && s[ 26 ] == ' ';
+}
+
+int main()
+{
+    std::error_category const& cat = std::generic_category();
+
+    std::string const einval = std::string( cat.name() ) + ":" + std::to_string( EINVAL ) + " " + cat.message( EINVAL );
+
+    {
+        std::ostringstream os;
+
+        {
+            error_logger log( os );
+
+            // values aren't logged
+
+            BOOST_TEST( !log.log( result<int>( 1 ) ) );
+
+            result<int> r1( EINVAL, cat );
+            BOOST_TEST( log.log( r1 ) );
+
+            log.flush();
+
+            std::vector<std::string> v = lines_of( os );
+
+            if( BOOST_TEST_EQ( v.size(), 1u ) )
+            {
+                BOOST_TEST( has_time( v[ 0 ] ) );
+                BOOST_TEST_EQ( v[ 0 ].substr( 27 ), einval + site_of( r1 ) );
+            }
+
+            BOOST_TEST( log.log( cat, EDOM, "file.cpp", 42, "f" ) );
+            BOOST_TEST( log.log( std::io_errc::stream ) );
+            BOOST_TEST( log.log( compact_error_code( ERANGE, cat ) ) );
+
+            result<void, compact_error_code> r2( ENOENT, cat );
+            BOOST_TEST( log.log( r2 ) );
+
+            // not an error code
+
+            BOOST_TEST( !log.log( result<int, int>( in_place_error, 5 ) ) );
+
+            log.flush();
+
+            v = lines_of( os );
+
+            if( BOOST_TEST_EQ( v.size(), 5u ) )
+            {
+                BOOST_TEST( ends_with( v[ 1 ], ":" + std::to_string( EDOM ) + " " + cat.message( EDOM ) + " at file.cpp:42 in f" ) );
+                BOOST_TEST( ends_with( v[ 2 ], std::make_error_code( std::io_errc::stream ).message() ) );
+                BOOST_TEST( ends_with( v[ 3 ], ":" + std::to_string( ERANGE ) + " " + cat.message( ERANGE ) ) );
+                BOOST_TEST( ends_with( v[ 4 ], ":" + std::to_string( ENOENT ) + " " + cat.message( ENOENT ) + site_of( r2 ) ) );
+            }
+
+            BOOST_TEST_EQ( log.dropped(), 0u );
+        }
+    }
+
+    {
+        // identical errors are written once per interval
+
+        std::ostringstream os;
+
+        {
+            error_logger log( os, std::chrono::hours( 1 ) );
+
+            for( int i = 0; i < 100; ++i )
+            {
+                log.log( cat, EINVAL );
+            }
+
+            // a different source location is a different error
+
+            log.log( cat, EINVAL, "file.cpp", 42 );
+
+            log.flush();
+
+            std::vector<std::string> v = lines_of( os );
+
+            if( BOOST_TEST_EQ( v.size(), 2u ) )
+            {
+                BOOST_TEST( ends_with( v[ 0 ], einval ) );
+                BOOST_TEST( ends_with( v[ 1 ], einval + " at file.cpp:42" ) );
+            }
+        }
+
+        // the destructor writes the suppressed count
+
+        std::vector<std::string> v = lines_of( os );
+
+        if( BOOST_TEST_EQ( v.size(), 3u ) )
+        {
+            BOOST_TEST( has_time( v[ 2 ] ) );
+            BOOST_TEST( ends_with( v[ 2 ], einval + " (99 suppressed)" ) );
+        }
+    }
+
+    {
+        // with a zero interval, everything is written
+
+        std::ostringstream os;
+
+        {
+            error_logger log( os, std::chrono::milliseconds( 0 ) );
+
+            for( int i = 0; i < 10; ++i )
+            {
+                log.log( cat, EINVAL );
+            }
+        }
+
+        BOOST_TEST_EQ( lines_of( os ).size(), 10u );
+    }
+
+    {
+        // several threads, including exited ones; the records that don't
+        // fit are dropped and counted
+
+        int const N = 4;
+        int const M = 5000;
+
+        std::ostringstream os;
+
+        {
+            error_logger log( os, std::chrono::milliseconds( 0 ) );
+
+            std::vector<std::thread> th;
+
+            for( int i = 0; i < N; ++i )
+            {
+                th.emplace_back( [&, i]{
+
+                    for( int j = 0; j < M; ++j )
+                    {
+                        log.log( cat, i * M + j );
+                    }
+                });
+            }
+
+            for( auto& x: th ) x.join();
+
+            log.flush();
+
+            std::uint64_t written = 0, dropped = 0;
+
+            for( std::string const& line: lines_of( os ) )
+            {
+                if( ends_with( line, " error records dropped" ) )
+                {
+                    dropped += std::stoull( line.substr( 27 ) );
+                }
+                else
+                {
+                    ++written;
+                }
+            }
+
+            BOOST_TEST_EQ( dropped, log.dropped() );
+            BOOST_TEST_EQ( written + dropped, static_cast<std::uint64_t>( N * M ) );
+        }
+    }
+
+    return boost::report_errors();
+}
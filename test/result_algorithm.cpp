@@ -0,0 +1,202 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/algorithm.hpp>
+#include <boost/result/result_vector.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/core/lightweight_test_trait.hpp>
+#include <system_error>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <list>
+#include <cerrno>
+
+using namespace boost::result;
+
+// counts copies
+
+struct X
+{
+    static int copies;
+
+    int v_;
+
+    explicit X( int v = 0 ): v_( v ) {}
+
+    X( X const& r ): v_( r.v_ ) { ++copies; }
+    X( X&& r ) noexcept: v_( r.v_ ) { r.v_ = -1; }
+
+    X& operator=( X const& r )
+    {
+        v_ = r.v_;
+        ++copies;
+        return *this;
+    }
+
+    X& operator=( X&& r ) noexcept
+    {
+        v_ = r.v_;
+        r.v_ = -1;
+        return *this;
+    }
+};
+
+int X::copies = 0;
+
+int main()
+{
+    auto ec = std::error_code( EINVAL, std::generic_category() );
+
+    // collect
+
+    {
+        std::vector< result<int> > v{ 1, 2, 3 };
+
+        auto r = collect( v );
+
+        BOOST_TEST_TRAIT_SAME( decltype( r ), result< std::vector<int> > );
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST( *r == std::vector<int>( { 1, 2, 3 } ) );
+        BOOST_TEST_EQ( r->capacity(), 3u );
+    }
+
+    {
+        std::vector< result<int> > v{ 1, ec, 3 };
+
+        auto r = collect( v );
+
+        BOOST_TEST( r.has_error() );
+        BOOST_TEST_EQ( r.error(), ec );
+    }
+
+    {
+        std::list< result<std::string> > v{ std::string( "a" ), std::string( "b" ) };
+
+        auto r = collect( v );
+
+        BOOST_TEST( *r == std::vector<std::string>( { "a", "b" } ) );
+        BOOST_TEST_EQ( r->capacity(), 2u );
+        BOOST_TEST_EQ( *v.front(), std::string( "a" ) );
+    }
+
+    {
+        std::vector< result<int> > v;
+
+        auto r = collect( v );
+
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST( r->empty() );
+    }
+
+    {
+        std::vector< result<X, X> > v;
+
+        v.emplace_back( in_place_value, 1 );
+        v.emplace_back( in_place_value, 2 );
+
+        X::copies = 0;
+
+        auto r = collect( std::move( v ) );
+
+        BOOST_TEST_EQ( r->size(), 2u );
+        BOOST_TEST_EQ( (*r)[0].v_, 1 );
+        BOOST_TEST_EQ( (*r)[1].v_, 2 );
+        BOOST_TEST_EQ( v[0]->v_, -1 );
+        BOOST_TEST_EQ( X::copies, 0 );
+
+        v.emplace_back( in_place_error, 3 );
+
+        auto r2 = collect( std::move( v ) );
+
+        BOOST_TEST_EQ( r2.error().v_, 3 );
+        BOOST_TEST_EQ( X::copies, 0 );
+
+        auto r3 = collect( v );
+
+        BOOST_TEST_EQ( r3.error().v_, -1 );
+        BOOST_TEST_EQ( X::copies, 3 );
+    }
+
+    // collect_into
+
+    {
+        std::vector< result<int> > v{ 1, 2, ec, 4 };
+        std::vector<int> w;
+
+        auto r = collect_into( v, std::back_inserter( w ) );
+
+        BOOST_TEST( r.has_error() );
+        BOOST_TEST_EQ( r.error(), ec );
+        BOOST_TEST( w == std::vector<int>( { 1, 2 } ) );
+    }
+
+    {
+        std::vector< result<int> > v{ 1, 2, 3 };
+        int w[ 4 ] = {};
+
+        auto r = collect_into( v, w );
+
+        BOOST_TEST_TRAIT_SAME( decltype( r ), result<int*> );
+        BOOST_TEST_EQ( *r, w + 3 );
+        BOOST_TEST_EQ( w[2], 3 );
+    }
+
+    // partition_results
+
+    {
+        std::vector< result<int> > v{ 1, ec, 3, ec };
+
+        std::vector<int> w;
+        std::vector<std::error_code> e;
+
+        auto p = partition_results( v, std::back_inserter( w ), std::back_inserter( e ) );
+
+        (void)p;
+
+        BOOST_TEST( w == std::vector<int>( { 1, 3 } ) );
+        BOOST_TEST_EQ( e.size(), 2u );
+        BOOST_TEST_EQ( e[1], ec );
+    }
+
+    {
+        std::vector< result<X, X> > v;
+
+        v.emplace_back( in_place_value, 1 );
+        v.emplace_back( in_place_error, 2 );
+        v.emplace_back( in_place_value, 3 );
+
+        X w[ 3 ], e[ 3 ];
+
+        X::copies = 0;
+
+        auto p = partition_results( std::move( v ), w, e );
+
+        BOOST_TEST_EQ( p.first, w + 2 );
+        BOOST_TEST_EQ( p.second, e + 1 );
+        BOOST_TEST_EQ( w[1].v_, 3 );
+        BOOST_TEST_EQ( e[0].v_, 2 );
+        BOOST_TEST_EQ( X::copies, 0 );
+    }
+
+    // result_vector as the source
+
+    {
+        result_vector<int> v;
+
+        v.push_back( 1 );
+        v.push_back( 2 );
+
+        auto r = collect( v );
+
+        BOOST_TEST( *r == std::vector<int>( { 1, 2 } ) );
+        BOOST_TEST_EQ( r->capacity(), 2u );
+
+        v.push_back( ec );
+
+        BOOST_TEST_EQ( collect( v ).error(), ec );
+    }
+
+    return boost::report_errors();
+}
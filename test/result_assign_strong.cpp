@@ -0,0 +1,192 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <system_error>
+#include <iosfwd>
+#include <cerrno>
+
+using namespace boost::result;
+
+struct exc
+{
+};
+
+// copies throw on request, moves may throw but don't
+
+struct X
+{
+    static int instances;
+    static bool throw_on_copy;
+
+    int v_;
+
+    explicit X( int v = 0 ): v_( v ) { ++instances; }
+
+    X( X const& r ): v_( r.v_ )
+    {
+        if( throw_on_copy ) throw exc();
+        ++instances;
+    }
+
+    X( X&& r ): v_( r.v_ ) { r.v_ = 0; ++instances; }
+
+    X& operator=( X const& r )
+    {
+        if( throw_on_copy ) throw exc();
+
+        v_ = r.v_;
+        return *this;
+    }
+
+    X& operator=( X&& r )
+    {
+        v_ = r.v_;
+        r.v_ = 0;
+
+        return *this;
+    }
+
+    ~X() { --instances; }
+};
+
+int X::instances = 0;
+bool X::throw_on_copy = false;
+
+bool operator==( X const & x1, X const & x2 )
+{
+    return x1.v_ == x2.v_;
+}
+
+std::ostream& operator<<( std::ostream& os, X const & x )
+{
+    os << "X:" << x.v_;
+    return os;
+}
+
+struct Y
+{
+    static int instances;
+    static bool throw_on_copy;
+
+    int v_;
+
+    explicit Y( int v = 0 ): v_( v ) { ++instances; }
+
+    Y( Y const& r ): v_( r.v_ )
+    {
+        if( throw_on_copy ) throw exc();
+        ++instances;
+    }
+
+    Y( Y&& r ): v_( r.v_ ) { r.v_ = 0; ++instances; }
+
+    Y& operator=( Y const& ) = default;
+    Y& operator=( Y&& ) = default;
+
+    ~Y() { --instances; }
+};
+
+int Y::instances = 0;
+bool Y::throw_on_copy = false;
+
+bool operator==( Y const & y1, Y const & y2 )
+{
+    return y1.v_ == y2.v_;
+}
+
+std::ostream& operator<<( std::ostream& os, Y const & y )
+{
+    os << "Y:" << y.v_;
+    return os;
+}
+
+int main()
+{
+    // error -> value, the new value throws; E is nothrow movable
+
+    {
+        result<X> r( ENOENT, std::generic_category() ), rc( r );
+        result<X> r2( in_place_value, 1 );
+
+        X::throw_on_copy = true;
+
+        BOOST_TEST_THROWS( r = r2, exc );
+
+        X::throw_on_copy = false;
+
+        BOOST_TEST_EQ( r, rc );
+    }
+
+    BOOST_TEST_EQ( X::instances, 0 );
+
+    // value -> error, the new error throws; neither alternative is nothrow movable
+
+    {
+        result<X, Y> r( in_place_value, 1 ), rc( r );
+        result<X, Y> r2( in_place_error, 2 );
+
+        BOOST_TEST_EQ( X::instances, 2 );
+        BOOST_TEST_EQ( Y::instances, 1 );
+
+        Y::throw_on_copy = true;
+
+        BOOST_TEST_THROWS( r = r2, exc );
+
+        Y::throw_on_copy = false;
+
+        BOOST_TEST_EQ( r, rc );
+
+        BOOST_TEST_EQ( X::instances, 2 );
+        BOOST_TEST_EQ( Y::instances, 1 );
+    }
+
+    BOOST_TEST_EQ( X::instances, 0 );
+    BOOST_TEST_EQ( Y::instances, 0 );
+
+    // error -> value, the new value throws; neither alternative is nothrow movable
+
+    {
+        result<X, Y> r( in_place_error, 1 ), rc( r );
+        result<X, Y> r2( in_place_value, 2 );
+
+        X::throw_on_copy = true;
+
+        BOOST_TEST_THROWS( r = r2, exc );
+
+        X::throw_on_copy = false;
+
+        BOOST_TEST_EQ( r, rc );
+
+        BOOST_TEST_EQ( X::instances, 1 );
+        BOOST_TEST_EQ( Y::instances, 2 );
+    }
+
+    BOOST_TEST_EQ( X::instances, 0 );
+    BOOST_TEST_EQ( Y::instances, 0 );
+
+    // and without exceptions, mixed assignment works as usual
+
+    {
+        result<X, Y> r( in_place_error, 1 );
+        result<X, Y> r2( in_place_value, 2 );
+
+        r = r2;
+
+        BOOST_TEST_EQ( r, r2 );
+
+        r = result<X, Y>( in_place_error, 3 );
+
+        BOOST_TEST_EQ( r, (result<X, Y>( in_place_error, 3 )) );
+
+        BOOST_TEST_EQ( X::instances, 1 );
+        BOOST_TEST_EQ( Y::instances, 1 );
+    }
+
+    BOOST_TEST_EQ( X::instances, 0 );
+    BOOST_TEST_EQ( Y::instances, 0 );
+
+    return boost::report_errors();
+}
@@ -0,0 +1,314 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result_channel.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <system_error>
+#include <iterator>
+#include <string>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <cerrno>
+
+using namespace boost::result;
+
+struct X
+{
+    static int instances;
+
+    int v;
+
+    explicit X( int v ): v( v )
+    {
+        if( v < 0 ) throw v;
+        ++instances;
+    }
+
+    X( X const& r ): v( r.v ) { ++instances; }
+
+    X& operator=( X const& ) = default;
+
+    ~X() { --instances; }
+};
+
+int X::instances = 0;
+
+int main()
+{
+    auto ec = std::error_code( EINVAL, std::generic_category() );
+    auto ec2 = std::error_code( ECANCELED, std::generic_category() );
+
+    {
+        result_channel<int> ch( 3 );
+
+        BOOST_TEST_EQ( ch.capacity(), 4u );
+        BOOST_TEST( !ch.is_closed() );
+
+        result<int> r;
+
+        BOOST_TEST( ch.try_pop( r ) == channel_status::empty );
+
+        BOOST_TEST( ch.try_emplace_value( 1 ) == channel_status::ok );
+        BOOST_TEST( ch.try_emplace_error( ec ) == channel_status::ok );
+        BOOST_TEST( ch.try_push( result<int>( 3 ) ) == channel_status::ok );
+        BOOST_TEST( ch.try_push( r ) == channel_status::ok );
+        BOOST_TEST( ch.try_emplace_value( 5 ) == channel_status::full );
+
+        BOOST_TEST( ch.try_pop( r ) == channel_status::ok );
+        BOOST_TEST_EQ( *r, 1 );
+
+        BOOST_TEST( ch.try_pop( r ) == channel_status::ok );
+        BOOST_TEST_EQ( r.error(), ec );
+
+        BOOST_TEST( ch.try_emplace_value( 5 ) == channel_status::ok );
+
+        BOOST_TEST( ch.try_pop( r ) == channel_status::ok );
+        BOOST_TEST_EQ( *r, 3 );
+
+        BOOST_TEST( ch.try_pop( r ) == channel_status::ok );
+        BOOST_TEST_EQ( *r, 0 );
+
+        BOOST_TEST( ch.try_pop( r ) == channel_status::ok );
+        BOOST_TEST_EQ( *r, 5 );
+
+        BOOST_TEST( ch.try_pop( r ) == channel_status::empty );
+    }
+
+    // close
+
+    {
+        result_channel<std::string> ch( 4 );
+
+        ch.push( std::string( "a" ) );
+        ch.emplace_value( "b" );
+
+        BOOST_TEST( ch.close( ec2 ) );
+        BOOST_TEST( !ch.close( ec ) );
+        BOOST_TEST( ch.is_closed() );
+
+        BOOST_TEST( ch.try_emplace_value( "c" ) == channel_status::closed );
+        BOOST_TEST( !ch.push( std::string( "c" ) ) );
+
+        result<std::string> r;
+
+        BOOST_TEST( ch.pop( r ) );
+        BOOST_TEST_EQ( *r, std::string( "a" ) );
+
+        BOOST_TEST( ch.try_pop( r ) == channel_status::ok );
+        BOOST_TEST_EQ( *r, std::string( "b" ) );
+
+        BOOST_TEST( ch.try_pop( r ) == channel_status::closed );
+        BOOST_TEST_EQ( r.error(), ec2 );
+
+        BOOST_TEST( !ch.pop( r ) );
+        BOOST_TEST_EQ( r.error(), ec2 );
+    }
+
+    // batches
+
+    {
+        result_channel<int> ch( 8 );
+
+        std::vector< result<int> > v{ 1, 2, ec, 4, 5 };
+
+        BOOST_TEST_EQ( ch.try_push_n( v.begin(), v.size() ), 5u );
+        BOOST_TEST_EQ( ch.try_push_n( v.begin(), v.size() ), 3u );
+
+        std::vector< result<int> > w;
+
+        BOOST_TEST_EQ( ch.try_pop_n( std::back_inserter( w ), 6 ), 6u );
+        BOOST_TEST_EQ( ch.try_pop_n( std::back_inserter( w ), 6 ), 2u );
+        BOOST_TEST_EQ( ch.try_pop_n( std::back_inserter( w ), 6 ), 0u );
+
+        BOOST_TEST_EQ( w.size(), 8u );
+        BOOST_TEST_EQ( *w[ 4 ], 5 );
+        BOOST_TEST_EQ( *w[ 5 ], 1 );
+        BOOST_TEST_EQ( w[ 7 ].error(), ec );
+    }
+
+    {
+        // move-only, moved from in a batch push
+
+        result_channel<std::unique_ptr<int>> ch( 4 );
+
+        std::vector< result<std::unique_ptr<int>> > v;
+
+        v.emplace_back( new int( 1 ) );
+        v.emplace_back( new int( 2 ) );
+
+        BOOST_TEST_EQ( ch.try_push_n( v.begin(), 2 ), 2u );
+        BOOST_TEST( *v[ 0 ] == nullptr );
+
+        result<std::unique_ptr<int>> r;
+
+        BOOST_TEST( ch.try_pop( r ) == channel_status::ok );
+        BOOST_TEST_EQ( **r, 1 );
+    }
+
+    // a throwing constructor leaves an error in the slot
+
+    {
+        result_channel<X> ch( 4 );
+
+        BOOST_TEST_THROWS( ch.try_emplace_value( -1 ), int );
+        BOOST_TEST( ch.try_emplace_value( 2 ) == channel_status::ok );
+
+        result<X> r( in_place_value, 0 );
+
+        BOOST_TEST( ch.try_pop( r ) == channel_status::ok );
+        BOOST_TEST( r.has_error() );
+
+        BOOST_TEST( ch.try_pop( r ) == channel_status::ok );
+        BOOST_TEST_EQ( r->v, 2 );
+    }
+
+    // results left in the channel are destroyed
+
+    {
+        {
+            result_channel<X> ch( 4 );
+
+            ch.emplace_value( 1 );
+            ch.emplace_value( 2 );
+            ch.close();
+
+            BOOST_TEST_EQ( X::instances, 2 );
+        }
+
+        BOOST_TEST_EQ( X::instances, 0 );
+    }
+
+    // threads
+
+    {
+        int const P = 4, C = 3, N = 20000;
+
+        result_channel<int> ch( 64 );
+
+        std::atomic<long> sum( 0 );
+        std::atomic<int> errors( 0 ), terminal( 0 );
+
+        std::vector<std::thread> producers, consumers;
+
+        for( int i = 0; i < P; ++i )
+        {
+            producers.emplace_back( [&, i]{
+
+                for( int j = 0; j < N; ++j )
+                {
+                    if( j % 10 == 0 )
+                    {
+                        ch.emplace_error( ec );
+                    }
+                    else if( j % 7 == 0 )
+                    {
+                        std::vector< result<int> > v( 3, result<int>( j ) );
+
+                        for( std::size_t k = 0; k < v.size(); )
+                        {
+                            k += ch.try_push_n( v.begin() + k, v.size() - k );
+                            std::this_thread::yield();
+                        }
+                    }
+                    else
+                    {
+                        ch.emplace_value( i + j );
+                    }
+                }
+
+            });
+        }
+
+        for( int i = 0; i < C; ++i )
+        {
+            consumers.emplace_back( [&, i]{
+
+                result<int> r;
+                std::vector< result<int> > v;
+
+                for( ;; )
+                {
+                    if( i == 0 )
+                    {
+                        v.clear();
+
+                        if( ch.try_pop_n( std::back_inserter( v ), 5 ) == 0 )
+                        {
+                            channel_status st = ch.try_pop( r );
+
+                            if( st == channel_status::closed ) break;
+                            if( st == channel_status::ok ) v.push_back( r );
+                        }
+
+                        for( auto& x: v )
+                        {
+                            if( x ) sum += *x; else ++errors;
+                        }
+                    }
+                    else
+                    {
+                        if( !ch.pop( r ) ) break;
+
+                        if( r ) sum += *r; else ++errors;
+                    }
+                }
+
+                if( r.error() == ec2 ) ++terminal;
+
+            });
+        }
+
+        for( auto& th: producers ) th.join();
+
+        ch.close( ec2 );
+
+        for( auto& th: consumers ) th.join();
+
+        long expected = 0;
+        int expected_errors = 0;
+
+        for( int i = 0; i < P; ++i )
+        {
+            for( int j = 0; j < N; ++j )
+            {
+                if( j % 10 == 0 ) ++expected_errors;
+                else if( j % 7 == 0 ) expected += 3 * j;
+                else expected += i + j;
+            }
+        }
+
+        BOOST_TEST_EQ( sum.load(), expected );
+        BOOST_TEST_EQ( errors.load(), expected_errors );
+        BOOST_TEST_EQ( terminal.load(), C );
+    }
+
+    // the construction of the terminal error throws
+
+    {
+        result_channel<int, X> ch( 2 );
+
+        BOOST_TEST_THROWS( ch.close( -1 ), int );
+        BOOST_TEST( !ch.is_closed() );
+
+        BOOST_TEST( ch.try_emplace_value( 1 ) == channel_status::ok );
+
+        BOOST_TEST( ch.close( 2 ) );
+        BOOST_TEST( ch.is_closed() );
+        BOOST_TEST( !ch.close( 3 ) );
+
+        result<int, X> r( in_place_value, 0 );
+
+        BOOST_TEST( ch.pop( r ) );
+        BOOST_TEST_EQ( *r, 1 );
+
+        BOOST_TEST( !ch.pop( r ) );
+        BOOST_TEST_EQ( r.error().v, 2 );
+    }
+
+    BOOST_TEST_EQ( X::instances, 0 );
+
+    return boost::report_errors();
+}
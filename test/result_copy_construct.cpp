@@ -145,5 +145,22 @@ int main()
 
     BOOST_TEST_EQ( X::instances, 0 );
 
+    {
+        int x = 1;
+
+        result<int&> r( x );
+        result<int&> r2( r );
+
+        BOOST_TEST_EQ( r, r2 );
+        BOOST_TEST_EQ( &*r2, &x );
+    }
+
+    {
+        result<int&> r( ENOENT, std::generic_category() );
+        result<int&> r2( r );
+
+        BOOST_TEST_EQ( r, r2 );
+    }
+
     return boost::report_errors();
 }
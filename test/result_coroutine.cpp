@@ -0,0 +1,228 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/coroutine.hpp>
+#include <boost/config/pragma_message.hpp>
+
+#if !defined(BOOST_RESULT_HAS_COROUTINES)
+
+BOOST_PRAGMA_MESSAGE( "Skipping test because BOOST_RESULT_HAS_COROUTINES is not defined" )
+
+int main() {}
+
+#else
+
+#include <boost/result/compact_error_code.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <system_error>
+#include <stdexcept>
+#include <string>
+#include <memory>
+#include <coroutine>
+#include <cerrno>
+
+using namespace boost::result;
+
+static std::error_code const e1( EINVAL, std::generic_category() );
+
+static int destroyed = 0;
+
+struct X
+{
+    int v;
+
+    explicit X( int v ): v( v ) {}
+
+    ~X() { ++destroyed; }
+};
+
+result<int> parse( std::string const& s )
+{
+    if( s.empty() || s.find_first_not_of( "0123456789" ) != std::string::npos ) return e1;
+    return std::stoi( s );
+}
+
+result<int> sum( std::string const& a, std::string const& b )
+{
+    X x( 1 );
+
+    int v1 = co_await parse( a );
+    int v2 = co_await parse( b );
+
+    co_return v1 + v2 + x.v;
+}
+
+result<void> check( int x )
+{
+    if( x < 0 ) co_return e1;
+    co_return {};
+}
+
+result<int> checked( int x )
+{
+    co_await check( x );
+    co_return x;
+}
+
+// lvalues are copied from, rvalues moved from
+
+result<std::string> concat( result<std::string>& r1, result<std::string> r2 )
+{
+    std::string s1 = co_await r1;
+    std::string s2 = co_await std::move( r2 );
+
+    co_return s1 + s2;
+}
+
+result<std::unique_ptr<int>> make( int x )
+{
+    if( x < 0 ) co_return e1;
+    co_return std::unique_ptr<int>( new int( x ) );
+}
+
+result<int> deref( int x )
+{
+    std::unique_ptr<int> p = co_await make( x );
+    co_return *p;
+}
+
+// references
+
+result<int&> at( int* p, std::size_t i, std::size_t n )
+{
+    if( i >= n ) return e1;
+    return p[ i ];
+}
+
+result<int> increment( int* p, std::size_t i, std::size_t n )
+{
+    int& x = co_await at( p, i, n );
+    co_return ++x;
+}
+
+// error conversion, as by BOOST_RESULT_TRY
+
+result<int, compact_error_code> parse2( std::string const& s )
+{
+    co_return co_await parse( s );
+}
+
+result<int> thrower( int x )
+{
+    if( x > 0 ) throw std::runtime_error( "x" );
+    co_return co_await parse( "" );
+}
+
+// checks that the compiler converts the return object after the body has
+// run, which coroutine.hpp relies on
+
+static bool converted = false;
+static bool converted_before_body = true;
+
+struct order_check
+{
+};
+
+struct order_check_return_object
+{
+    operator order_check() const
+    {
+        converted = true;
+        return {};
+    }
+};
+
+struct order_check_promise
+{
+    order_check_return_object get_return_object() noexcept { return {}; }
+
+    std::suspend_never initial_suspend() const noexcept { return {}; }
+    std::suspend_never final_suspend() const noexcept { return {}; }
+
+    void unhandled_exception() {}
+
+    void return_void() noexcept {}
+};
+
+template<class... A> struct std::coroutine_traits<order_check, A...>
+{
+    using promise_type = order_check_promise;
+};
+
+order_check check_conversion_order()
+{
+    converted_before_body = converted;
+    co_return;
+}
+
+int main()
+{
+    check_conversion_order();
+
+    BOOST_TEST( converted );
+    BOOST_TEST( !converted_before_body );
+
+    {
+        destroyed = 0;
+
+        BOOST_TEST_EQ( *sum( "1", "2" ), 4 );
+        BOOST_TEST_EQ( destroyed, 1 );
+    }
+
+    {
+        // locals are destroyed when the coroutine short-circuits
+
+        destroyed = 0;
+
+        BOOST_TEST_EQ( sum( "x", "2" ).error(), e1 );
+        BOOST_TEST_EQ( destroyed, 1 );
+
+        BOOST_TEST_EQ( sum( "1", "" ).error(), e1 );
+        BOOST_TEST_EQ( destroyed, 2 );
+    }
+
+    {
+        BOOST_TEST( check( 1 ).has_value() );
+        BOOST_TEST_EQ( check( -1 ).error(), e1 );
+
+        BOOST_TEST_EQ( *checked( 5 ), 5 );
+        BOOST_TEST_EQ( checked( -5 ).error(), e1 );
+    }
+
+    {
+        result<std::string> r1( "a" );
+
+        BOOST_TEST_EQ( *concat( r1, std::string( "b" ) ), std::string( "ab" ) );
+        BOOST_TEST_EQ( *r1, std::string( "a" ) );
+
+        BOOST_TEST_EQ( concat( r1, e1 ).error(), e1 );
+    }
+
+    {
+        BOOST_TEST_EQ( *deref( 7 ), 7 );
+        BOOST_TEST_EQ( deref( -1 ).error(), e1 );
+    }
+
+    {
+        int a[] = { 1, 2 };
+
+        BOOST_TEST_EQ( *increment( a, 1, 2 ), 3 );
+        BOOST_TEST_EQ( a[ 1 ], 3 );
+        BOOST_TEST_EQ( increment( a, 2, 2 ).error(), e1 );
+    }
+
+    {
+        BOOST_TEST_EQ( *parse2( "12" ), 12 );
+        BOOST_TEST( parse2( "" ).error() == e1 );
+    }
+
+    {
+        BOOST_TEST_THROWS( thrower( 1 ), std::runtime_error );
+        BOOST_TEST_EQ( thrower( 0 ).error(), e1 );
+    }
+
+    return boost::report_errors();
+}
+
+#endif
@@ -0,0 +1,224 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <system_error>
+#include <string>
+#include <vector>
+#include <cerrno>
+
+using namespace boost::result;
+
+struct X
+{
+    static int instances;
+    static int assignments;
+
+    int v_;
+
+    X( int v = 0 ): v_( v ) { ++instances; }
+    X( int v1, int v2 ): v_( v1 + v2 ) { ++instances; }
+
+    X( X const& r ): v_( r.v_ ) { ++instances; }
+
+    X& operator=( X const& r )
+    {
+        v_ = r.v_;
+        ++assignments;
+        return *this;
+    }
+
+    X& operator=( int v )
+    {
+        v_ = v;
+        ++assignments;
+        return *this;
+    }
+
+    ~X() { --instances; }
+};
+
+int X::instances = 0;
+int X::assignments = 0;
+
+struct Y
+{
+    int v_;
+
+    Y( int v, char ): v_( v ) {}
+
+    Y( Y const& ) = default;
+    Y& operator=( Y const& ) = default;
+};
+
+int main()
+{
+    auto ec = std::error_code( EINVAL, std::generic_category() );
+
+    // assignment into the active value keeps its capacity
+
+    {
+        result<std::string> r( std::string( 100, 'x' ) );
+
+        char const* p = r->data();
+        std::size_t n = r->capacity();
+
+        r = "abc";
+
+        BOOST_TEST_EQ( *r, std::string( "abc" ) );
+        BOOST_TEST_EQ( r->data(), p );
+        BOOST_TEST_EQ( r->capacity(), n );
+
+        r.emplace_value( "abcd" );
+
+        BOOST_TEST_EQ( *r, std::string( "abcd" ) );
+        BOOST_TEST_EQ( r->data(), p );
+
+        r = ec;
+
+        BOOST_TEST( r.has_error() );
+        BOOST_TEST_EQ( r.error(), ec );
+
+        r = "ab";
+
+        BOOST_TEST_EQ( *r, std::string( "ab" ) );
+    }
+
+    {
+        std::vector<int> v1( 100, 1 ), v2( 3, 2 );
+
+        result<std::vector<int>> r( v1 );
+
+        int const* p = r->data();
+
+        r = v2;
+
+        BOOST_TEST( *r == v2 );
+        BOOST_TEST_EQ( r->data(), p );
+
+        r.emplace_value( v1 );
+
+        BOOST_TEST( *r == v1 );
+        BOOST_TEST_EQ( r->data(), p );
+
+        r.emplace_value( 5, 3 );
+
+        BOOST_TEST( *r == std::vector<int>( 5, 3 ) );
+    }
+
+    // assignment into the active error
+
+    {
+        result<int, std::string> r( in_place_error, std::string( 100, 'x' ) );
+
+        char const* p = r.error().data();
+
+        r = std::string( "error" );
+
+        BOOST_TEST_EQ( r.error(), std::string( "error" ) );
+        BOOST_TEST_EQ( r.error().data(), p );
+
+        r.emplace_error( "error 2" );
+
+        BOOST_TEST_EQ( r.error(), std::string( "error 2" ) );
+        BOOST_TEST_EQ( r.error().data(), p );
+
+        r = 5;
+
+        BOOST_TEST_EQ( *r, 5 );
+
+        r.emplace_error( 3, 'e' );
+
+        BOOST_TEST_EQ( r.error(), std::string( "eee" ) );
+    }
+
+    // no temporaries
+
+    {
+        X::assignments = 0;
+
+        result<X, Y> r( 1 );
+
+        BOOST_TEST_EQ( X::instances, 1 );
+
+        r = 2;
+
+        BOOST_TEST_EQ( r->v_, 2 );
+        BOOST_TEST_EQ( X::instances, 1 );
+        BOOST_TEST_EQ( X::assignments, 1 );
+
+        X& x = r.emplace_value( 3 );
+
+        BOOST_TEST_EQ( &x, &*r );
+        BOOST_TEST_EQ( x.v_, 3 );
+        BOOST_TEST_EQ( X::instances, 1 );
+        BOOST_TEST_EQ( X::assignments, 2 );
+
+        r.emplace_value( 1, 3 );
+
+        BOOST_TEST_EQ( r->v_, 4 );
+        BOOST_TEST_EQ( X::instances, 1 );
+        BOOST_TEST_EQ( X::assignments, 2 );
+
+        Y& y = r.emplace_error( 5, 'y' );
+
+        BOOST_TEST( r.has_error() );
+        BOOST_TEST_EQ( y.v_, 5 );
+        BOOST_TEST_EQ( X::instances, 0 );
+
+        r.emplace_value( 6 );
+
+        BOOST_TEST_EQ( r->v_, 6 );
+        BOOST_TEST_EQ( X::instances, 1 );
+    }
+
+    BOOST_TEST_EQ( X::instances, 0 );
+
+    // result<void, E>
+
+    {
+        result<void, std::string> r;
+
+        r = std::string( "error" );
+
+        BOOST_TEST_EQ( r.error(), std::string( "error" ) );
+
+        r.emplace_error( "error 2" );
+
+        BOOST_TEST_EQ( r.error(), std::string( "error 2" ) );
+
+        r.emplace_value();
+
+        BOOST_TEST( r.has_value() );
+    }
+
+    // result<U&, E>
+
+    {
+        int x1 = 1, x2 = 2;
+
+        result<int&> r( x1 );
+
+        r = x2;
+
+        BOOST_TEST_EQ( &*r, &x2 );
+        BOOST_TEST_EQ( x1, 1 );
+
+        r = ec;
+
+        BOOST_TEST_EQ( r.error(), ec );
+
+        int& x = r.emplace_value( x1 );
+
+        BOOST_TEST_EQ( &x, &x1 );
+        BOOST_TEST_EQ( &*r, &x1 );
+
+        r.emplace_error( EDOM, std::generic_category() );
+
+        BOOST_TEST_EQ( r.error(), std::error_code( EDOM, std::generic_category() ) );
+    }
+
+    return boost::report_errors();
+}
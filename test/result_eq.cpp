@@ -134,5 +134,51 @@ int main()
         BOOST_TEST_NE( r1, r2 );
     }
 
+    {
+        result<void> r1;
+        result<void> r2;
+
+        BOOST_TEST_EQ( r1, r2 );
+    }
+
+    {
+        result<void> r1( 1, std::generic_category() );
+        result<void> r2( 2, std::generic_category() );
+
+        BOOST_TEST_EQ( r1, r1 );
+        BOOST_TEST_NE( r1, r2 );
+    }
+
+    {
+        result<void> r1;
+        result<void> r2( 2, std::generic_category() );
+
+        BOOST_TEST_EQ( r1, r1 );
+        BOOST_TEST_NE( r1, r2 );
+    }
+
+    {
+        int x1 = 1, x2 = 2, x3 = 1;
+
+        result<int&> r1( x1 );
+        result<int&> r2( x2 );
+        result<int&> r3( x3 );
+
+        BOOST_TEST_EQ( r1, r1 );
+        BOOST_TEST_NE( r1, r2 );
+        BOOST_TEST_EQ( r1, r3 );
+    }
+
+    {
+        int x1 = 1;
+
+        result<int&> r1( x1 );
+        result<int&> r2( 1, std::generic_category() );
+
+        BOOST_TEST_EQ( r1, r1 );
+        BOOST_TEST_NE( r1, r2 );
+        BOOST_TEST_EQ( r2, r2 );
+    }
+
     return boost::report_errors();
 }
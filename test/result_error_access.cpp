@@ -6,6 +6,8 @@
 #include <boost/core/lightweight_test.hpp>
 #include <boost/core/lightweight_test_trait.hpp>
 #include <string>
+#include <memory>
+#include <utility>
 
 using namespace boost::result;
 
@@ -19,6 +21,13 @@ struct X
     X& operator=( X const& ) = delete;
 };
 
+struct Y
+{
+    int v_;
+
+    explicit Y( int v ): v_( v ) {}
+};
+
 int main()
 {
     {
@@ -27,7 +36,7 @@ int main()
         BOOST_TEST( r.has_value() );
         BOOST_TEST( !r.has_error() );
 
-        BOOST_TEST_EQ( r.error(), std::error_code() );
+        BOOST_TEST_EQ( r.error_or_default(), std::error_code() );
     }
 
     {
@@ -36,14 +45,14 @@ int main()
         BOOST_TEST( r.has_value() );
         BOOST_TEST( !r.has_error() );
 
-        BOOST_TEST_EQ( r.error(), std::error_code() );
+        BOOST_TEST_EQ( r.error_or_default(), std::error_code() );
     }
 
     {
         BOOST_TEST( result<int>().has_value() );
         BOOST_TEST( !result<int>().has_error() );
 
-        BOOST_TEST_EQ( result<int>().error(), std::error_code() );
+        BOOST_TEST_EQ( result<int>().error_or_default(), std::error_code() );
     }
 
     {
@@ -52,7 +61,7 @@ int main()
         BOOST_TEST( r.has_value() );
         BOOST_TEST( !r.has_error() );
 
-        BOOST_TEST_EQ( r.error(), std::error_code() );
+        BOOST_TEST_EQ( r.error_or_default(), std::error_code() );
     }
 
     {
@@ -61,14 +70,14 @@ int main()
         BOOST_TEST( r.has_value() );
         BOOST_TEST( !r.has_error() );
 
-        BOOST_TEST_EQ( r.error(), std::error_code() );
+        BOOST_TEST_EQ( r.error_or_default(), std::error_code() );
     }
 
     {
         BOOST_TEST( result<int>( 1 ).has_value() );
         BOOST_TEST( !result<int>( 1 ).has_error() );
 
-        BOOST_TEST_EQ( result<int>( 1 ).error(), std::error_code() );
+        BOOST_TEST_EQ( result<int>( 1 ).error_or_default(), std::error_code() );
     }
 
     {
@@ -133,7 +142,7 @@ int main()
         BOOST_TEST( r.has_value() );
         BOOST_TEST( !r.has_error() );
 
-        BOOST_TEST_EQ( r.error().v_, 0 );
+        BOOST_TEST_EQ( r.error_or_default().v_, 0 );
     }
 
     {
@@ -142,14 +151,131 @@ int main()
         BOOST_TEST( r.has_value() );
         BOOST_TEST( !r.has_error() );
 
-        BOOST_TEST_EQ( r.error().v_, 0 );
+        BOOST_TEST_EQ( r.error_or_default().v_, 0 );
     }
 
     {
         BOOST_TEST(( result<std::string, X>( "s" ).has_value() ));
         BOOST_TEST(( !result<std::string, X>( "s" ).has_error() ));
 
-        BOOST_TEST_EQ( (result<std::string, X>( "s" ).error().v_), 0 );
+        BOOST_TEST_EQ( (result<std::string, X>( "s" ).error_or_default().v_), 0 );
+    }
+
+    {
+        result<void> r;
+
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST( !r.has_error() );
+
+        BOOST_TEST_EQ( r.error_or_default(), std::error_code() );
+    }
+
+    {
+        auto ec = make_error_code( std::errc::invalid_argument );
+
+        result<void> const r( ec );
+
+        BOOST_TEST( !r.has_value() );
+        BOOST_TEST( r.has_error() );
+
+        BOOST_TEST_EQ( r.error(), ec );
+    }
+
+    {
+        result<void, X> r( 1 );
+
+        BOOST_TEST( !r.has_value() );
+        BOOST_TEST( r.has_error() );
+
+        BOOST_TEST_EQ( r.error().v_, 1 );
+    }
+
+    {
+        BOOST_TEST(( result<void, X>().has_value() ));
+        BOOST_TEST_EQ( (result<void, X>().error_or_default().v_), 0 );
+    }
+
+    {
+        int x = 1;
+
+        result<int&> r( x );
+
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST( !r.has_error() );
+
+        BOOST_TEST_EQ( r.error_or_default(), std::error_code() );
+    }
+
+    {
+        auto ec = make_error_code( std::errc::invalid_argument );
+
+        result<int&> const r( ec );
+
+        BOOST_TEST( !r.has_value() );
+        BOOST_TEST( r.has_error() );
+
+        BOOST_TEST_EQ( r.error(), ec );
+    }
+
+    {
+        auto ec = make_error_code( std::errc::invalid_argument );
+
+        result<int> r( ec );
+
+        BOOST_TEST_EQ( r.error_or_default(), ec );
+    }
+
+    {
+        result<std::string, X> r( 1 );
+
+        result<std::string, X> const& cr = r;
+
+        BOOST_TEST_EQ( &r.error(), &cr.error() );
+
+        r.error().v_ = 2;
+
+        BOOST_TEST_EQ( r.error().v_, 2 );
+    }
+
+    {
+        result<int, std::unique_ptr<int>> r( new int( 1 ) );
+
+        BOOST_TEST( r.has_error() );
+        BOOST_TEST_EQ( *r.error(), 1 );
+
+        std::unique_ptr<int> p = std::move( r ).error();
+
+        BOOST_TEST_EQ( *p, 1 );
+        BOOST_TEST( r.has_error() );
+        BOOST_TEST( r.error() == 0 );
+    }
+
+    {
+        result<void, std::unique_ptr<int>> r( new int( 1 ) );
+
+        std::unique_ptr<int> p = std::move( r ).error();
+
+        BOOST_TEST_EQ( *p, 1 );
+        BOOST_TEST( r.error() == 0 );
+    }
+
+    {
+        result<int, Y> r( in_place_error, 1 );
+
+        BOOST_TEST_EQ( r.error().v_, 1 );
+        BOOST_TEST_EQ( std::move( r ).error().v_, 1 );
+    }
+
+    {
+        int x = 1;
+
+        result<int&, Y> const r( in_place_error, 1 );
+
+        BOOST_TEST_EQ( r.error().v_, 1 );
+
+        result<int&, Y> r2( in_place_value, x );
+
+        BOOST_TEST( r2.has_value() );
     }
 
     return boost::report_errors();
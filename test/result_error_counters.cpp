@@ -0,0 +1,198 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#if !defined(BOOST_RESULT_ENABLE_ERROR_COUNTERS)
+# define BOOST_RESULT_ENABLE_ERROR_COUNTERS
+#endif
+
+#include <boost/result/result.hpp>
+#include <boost/result/try.hpp>
+#include <boost/result/compact_error_code.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <system_error>
+#include <exception>
+#include <sstream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cerrno>
+
+using namespace boost::result;
+
+static std::uint64_t count_of( std::error_category const& cat, int value )
+{
+    for( error_count const& e: error_counts() )
+    {
+        if( e.category == &cat && e.value == value ) return e.count;
+    }
+
+    return 0;
+}
+
+result<int> f( int x )
+{
+    if( x < 0 ) return std::error_code( EINVAL, std::generic_category() );
+    return x;
+}
+
+result<long> g( int x )
+{
+    BOOST_RESULT_TRY( int y, f( x ) );
+    return y + 1;
+}
+
+int main()
+{
+    std::error_category const& cat = std::generic_category();
+
+    BOOST_TEST_EQ( count_of( cat, EINVAL ), 0 );
+
+    // values aren't counted
+
+    f( 1 );
+    BOOST_TEST_EQ( count_of( cat, EINVAL ), 0 );
+
+    // every error constructor
+
+    f( -1 );
+    BOOST_TEST_EQ( count_of( cat, EINVAL ), 1 );
+
+    {
+        result<int> r1( EINVAL, cat );
+        result<int> r2( in_place_error, EINVAL, cat );
+        result<void> r3 = std::error_code( EINVAL, cat );
+        result<void> r4( in_place_error, EINVAL, cat );
+
+        int x = 0;
+        result<int&> r5( EINVAL, cat );
+        result<int&> r6( x );
+
+        BOOST_TEST( r1.has_error() && r2.has_error() && r3.has_error() && r4.has_error() && r5.has_error() && r6.has_value() );
+    }
+
+    BOOST_TEST_EQ( count_of( cat, EINVAL ), 6 );
+
+    // assignment and emplace_error
+
+    {
+        result<int> r( 1 );
+
+        r = std::error_code( EINVAL, cat );
+        r.emplace_error( EINVAL, cat );
+    }
+
+    BOOST_TEST_EQ( count_of( cat, EINVAL ), 8 );
+
+    // copies and propagation aren't counted
+
+    {
+        result<int> r = f( -1 );
+        result<int> r2( r );
+
+        BOOST_TEST_EQ( count_of( cat, EINVAL ), 9 );
+
+        g( -1 );
+        BOOST_TEST_EQ( count_of( cat, EINVAL ), 10 );
+
+        r.and_then( []( int y ){ return result<int>( y ); } );
+        r.transform( []( int y ){ return y + 1; } );
+        BOOST_TEST_EQ( count_of( cat, EINVAL ), 10 );
+
+        // a transformed error is a new one
+        r.transform_error( []( std::error_code const& ){ return std::error_code( EDOM, std::generic_category() ); } );
+        BOOST_TEST_EQ( count_of( cat, EDOM ), 1 );
+    }
+
+    // other error types
+
+    {
+        result<int, compact_error_code> r( ENOENT, cat );
+        BOOST_TEST_EQ( count_of( cat, ENOENT ), 1 );
+
+        result<int, std::io_errc> r4( std::io_errc::stream );
+        BOOST_TEST( r4.has_error() );
+        BOOST_TEST_EQ( count_of( std::iostream_category(), static_cast<int>( std::io_errc::stream ) ), 1 );
+
+        result<int, std::exception_ptr> r2( std::exception_ptr{} );
+        result<int, std::string> r3( in_place_error, "error" );
+    }
+
+    // constant evaluation
+
+    {
+        constexpr result<int, int> r( in_place_error, 5 );
+        BOOST_TEST( r.has_error() );
+
+#if defined(__cpp_lib_is_constant_evaluated) && __cpp_lib_is_constant_evaluated >= 201811L
+
+        // not counted
+
+        constexpr result<int, std::errc> r2( std::errc::result_out_of_range );
+        BOOST_TEST( r2.has_error() );
+        BOOST_TEST_EQ( count_of( cat, ERANGE ), 0 );
+
+#endif
+    }
+
+    // threads, including exited ones
+
+    {
+        std::vector<std::thread> th;
+
+        for( int t = 0; t < 4; ++t )
+        {
+            th.emplace_back( []{ for( int i = 0; i < 1000; ++i ) f( -1 ); } );
+        }
+
+        for( auto& x: th ) x.join();
+
+        BOOST_TEST_EQ( count_of( cat, EINVAL ), 4010 );
+    }
+
+    // overflow
+
+    {
+        std::thread th( []{ for( int i = 0; i < BOOST_RESULT_ERROR_COUNTER_SLOTS + 10; ++i ) result<int>( 1000 + i, std::system_category() ); } );
+        th.join();
+
+        std::uint64_t n = 0;
+
+        for( error_count const& e: error_counts() )
+        {
+            if( e.category == 0 ) n += e.count;
+        }
+
+        BOOST_TEST_EQ( n, 10 );
+    }
+
+    // Prometheus
+
+    {
+        std::ostringstream os;
+        write_prometheus_error_counts( os );
+
+        std::string s = os.str();
+
+        BOOST_TEST( s.find( "# TYPE boost_result_errors_total counter\n" ) != std::string::npos );
+        BOOST_TEST( s.find( "boost_result_errors_total{category=\"generic\",value=\"" + std::to_string( EINVAL ) + "\",message=\"" + cat.message( EINVAL ) + "\"} 4010\n" ) != std::string::npos );
+        BOOST_TEST( s.find( "boost_result_errors_total{category=\"(other)\",value=\"\",message=\"\"} 10\n" ) != std::string::npos );
+
+        char const* path = "result_error_counters.prom";
+
+        BOOST_TEST( write_prometheus_error_counts( path ) );
+
+        std::ifstream is( path );
+        std::string s2( ( std::istreambuf_iterator<char>( is ) ), std::istreambuf_iterator<char>() );
+
+        BOOST_TEST_EQ( s, s2 );
+
+        is.close();
+        std::remove( path );
+    }
+
+    return boost::report_errors();
+}
@@ -0,0 +1,252 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result_future.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <system_error>
+#include <future>
+#include <string>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cerrno>
+
+using namespace boost::result;
+
+struct E2
+{
+    int v;
+};
+
+int main()
+{
+    auto ec = std::error_code( EINVAL, std::generic_category() );
+
+    // single thread
+
+    {
+        result_promise<int> p;
+        result_future<int> f = p.get_future();
+
+        BOOST_TEST( f.valid() );
+        BOOST_TEST( !f.is_ready() );
+        BOOST_TEST( f.try_get() == nullptr );
+
+        p.set_value( 5 );
+
+        BOOST_TEST( f.is_ready() );
+        BOOST_TEST( f.try_get() != nullptr );
+        BOOST_TEST_EQ( **f.try_get(), 5 );
+
+        BOOST_TEST_EQ( *f.get(), 5 );
+        BOOST_TEST( !f.valid() );
+    }
+
+    {
+        result_promise<std::string> p;
+        result_future<std::string> f = p.get_future();
+
+        p.set_error( ec );
+
+        BOOST_TEST_EQ( f.get().error(), ec );
+    }
+
+    {
+        result_promise<std::unique_ptr<int>> p;
+        result_future<std::unique_ptr<int>> f = p.get_future();
+
+        p.set_result( result<std::unique_ptr<int>>( new int( 3 ) ) );
+
+        BOOST_TEST_EQ( **f.get(), 3 );
+    }
+
+    {
+        // the future outlives the promise
+
+        result_future<int> f;
+
+        {
+            result_promise<int> p;
+            f = p.get_future();
+            p.set_value( 1 );
+        }
+
+        BOOST_TEST_EQ( *f.get(), 1 );
+    }
+
+    {
+        // the promise outlives the future, or has none
+
+        result_promise<int> p;
+
+        {
+            result_future<int> f = p.get_future();
+        }
+
+        p.set_value( 1 );
+
+        result_promise<int> p2;
+        p2.set_value( 2 );
+    }
+
+    // broken promise
+
+    {
+        result_future<int> f;
+
+        {
+            result_promise<int> p;
+            f = p.get_future();
+        }
+
+        BOOST_TEST_EQ( f.get().error(), std::make_error_code( std::future_errc::broken_promise ) );
+    }
+
+    {
+        result_future<int, E2> f;
+
+        {
+            result_promise<int, E2> p;
+            f = p.get_future();
+        }
+
+        BOOST_TEST( f.is_ready() );
+        BOOST_TEST_THROWS( f.try_get(), std::future_error );
+        BOOST_TEST_THROWS( f.get(), std::future_error );
+    }
+
+    // continuations
+
+    {
+        result_promise<int> p;
+        result<int> r( 0 );
+
+        p.get_future().then( [&]( result<int>&& x ){ r = std::move( x ); } );
+
+        BOOST_TEST_EQ( *r, 0 );
+
+        p.set_value( 7 );
+
+        BOOST_TEST_EQ( *r, 7 );
+    }
+
+    {
+        // already ready; a large function object goes to the heap
+
+        result_promise<std::string> p;
+        result_future<std::string> f = p.get_future();
+
+        p.set_value( "abc" );
+
+        std::string r;
+        char pad[ 64 ] = {};
+
+        f.then( [&r, pad]( result<std::string>&& x ){ r = *x + pad; } );
+
+        BOOST_TEST_EQ( r, std::string( "abc" ) );
+        BOOST_TEST( !f.valid() );
+    }
+
+    {
+        // a continuation moves the value out
+
+        result_promise<std::unique_ptr<int>> p;
+        std::unique_ptr<int> q;
+
+        p.get_future().then( [&]( result<std::unique_ptr<int>>&& x ){ q = std::move( *x ); } );
+        p.set_value( new int( 4 ) );
+
+        BOOST_TEST_EQ( *q, 4 );
+    }
+
+    {
+        int calls = 0;
+
+        {
+            result_promise<int> p;
+            p.get_future().then( [&]( result<int>&& x ){ ++calls; BOOST_TEST( x.has_error() ); } );
+        }
+
+        BOOST_TEST_EQ( calls, 1 );
+
+        {
+            result_promise<int, E2> p;
+            p.get_future().then( [&]( result<int, E2>&& ){ ++calls; } );
+        }
+
+        BOOST_TEST_EQ( calls, 1 );
+    }
+
+    // threads
+
+    {
+        int const N = 1000;
+
+        std::vector< result_promise<int> > p( N );
+        std::vector< result_future<int> > f;
+
+        for( int i = 0; i < N; ++i ) f.push_back( p[ i ].get_future() );
+
+        std::thread th( [&]{
+
+            for( int i = 0; i < N; ++i )
+            {
+                if( i % 3 == 0 )
+                {
+                    p[ i ].set_error( std::error_code( i, std::generic_category() ) );
+                }
+                else
+                {
+                    p[ i ].set_value( i );
+                }
+            }
+
+        });
+
+        for( int i = 0; i < N; ++i )
+        {
+            result<int> r = f[ i ].get();
+
+            if( i % 3 == 0 )
+            {
+                BOOST_TEST_EQ( r.error().value(), i );
+            }
+            else
+            {
+                BOOST_TEST_EQ( *r, i );
+            }
+        }
+
+        th.join();
+    }
+
+    {
+        // continuations racing with set_value
+
+        int const N = 1000;
+
+        std::vector< result_promise<int> > p( N );
+        std::vector<int> r( N );
+
+        std::thread th( [&]{
+
+            for( int i = 0; i < N; ++i ) p[ i ].set_value( i );
+
+        });
+
+        for( int i = 0; i < N; ++i )
+        {
+            p[ i ].get_future().then( [&r, i]( result<int>&& x ){ r[ i ] = *x + 1; } );
+        }
+
+        th.join();
+
+        for( int i = 0; i < N; ++i )
+        {
+            BOOST_TEST_EQ( r[ i ], i + 1 );
+        }
+    }
+
+    return boost::report_errors();
+}
@@ -0,0 +1,123 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/core/lightweight_test_trait.hpp>
+#include <system_error>
+#include <type_traits>
+#include <string>
+#include <cstddef>
+
+using namespace boost::result;
+
+struct X
+{
+    int v_;
+};
+
+struct alignas( 8 ) Y
+{
+    char v_[ 24 ];
+};
+
+enum En
+{
+    e1 = 1
+};
+
+// a type whose move constructor can throw
+struct Z
+{
+    int v_;
+
+    explicit Z( int v = 0 ): v_( v ) {}
+
+    Z( Z const& r ): v_( r.v_ ) {}
+    Z( Z&& r ): v_( r.v_ ) { r.v_ = 0; }
+
+    Z& operator=( Z const& ) = default;
+    Z& operator=( Z&& ) = default;
+};
+
+struct Z2
+{
+    std::string v_;
+
+    Z2( Z2 const& r ): v_( r.v_ ) {}
+    Z2( Z2&& r ): v_( std::move( r.v_ ) ) {}
+};
+
+constexpr std::size_t max_( std::size_t x, std::size_t y )
+{
+    return x < y? y: x;
+}
+
+// size of a single buffer for T and E plus a one byte index
+template<class T, class E> constexpr std::size_t single_buffer()
+{
+    return ( max_( sizeof( T ), sizeof( E ) ) + 1 + max_( alignof( T ), alignof( E ) ) - 1 ) / max_( alignof( T ), alignof( E ) ) * max_( alignof( T ), alignof( E ) );
+}
+
+// size of an E plus a discriminator, padded to the alignment of E
+template<class E> constexpr std::size_t error_plus_index()
+{
+    return single_buffer<char, E>();
+}
+
+// n, plus the site of the error when it's recorded
+constexpr std::size_t with_site( std::size_t n )
+{
+#if defined(BOOST_RESULT_HAS_SOURCE_LOCATION)
+
+    return ( n + alignof( std::source_location ) - 1 ) / alignof( std::source_location ) * alignof( std::source_location ) + sizeof( std::source_location );
+
+#else
+
+    return n;
+
+#endif
+}
+
+int main()
+{
+    // result<void, E> stores no value, only the error and an index
+
+    BOOST_TEST_EQ( sizeof( result<void> ), with_site( error_plus_index<std::error_code>() ) );
+    BOOST_TEST_EQ( sizeof( result<void, int> ), with_site( error_plus_index<int>() ) );
+    BOOST_TEST_EQ( sizeof( result<void, En> ), with_site( error_plus_index<En>() ) );
+    BOOST_TEST_EQ( sizeof( result<void, X> ), with_site( error_plus_index<X>() ) );
+    BOOST_TEST_EQ( sizeof( result<void, Y> ), with_site( error_plus_index<Y>() ) );
+
+    BOOST_TEST_LE( sizeof( result<void> ), sizeof( result<int> ) );
+    BOOST_TEST_LE( sizeof( result<void, Y> ), sizeof( result<int, Y> ) );
+
+    // result<U&, E> stores a U*, and is trivially copyable when E is
+
+    BOOST_TEST_EQ( sizeof( result<Y&, int> ), sizeof( result<Y*, int> ) );
+    BOOST_TEST_EQ( sizeof( result<Y const&, En> ), sizeof( result<Y const*, En> ) );
+    BOOST_TEST_EQ( sizeof( result<Y&> ), sizeof( result<Y*> ) );
+
+    BOOST_TEST_LE( sizeof( result<Y&, int> ), with_site( 2 * sizeof( void* ) ) );
+
+    BOOST_TEST_TRAIT_TRUE((std::is_trivially_copyable< result<Y&, int> >));
+    BOOST_TEST_TRAIT_TRUE((std::is_trivially_copyable< result<Y const&, En> >));
+    BOOST_TEST_TRAIT_TRUE((std::is_trivially_copyable< result<Y&, X> >));
+    BOOST_TEST_TRAIT_TRUE((std::is_trivially_copyable< result<Y&> >));
+
+    // a single buffer is used regardless of whether the moves can throw
+
+    BOOST_TEST_EQ( sizeof( result<int> ), with_site( single_buffer<int, std::error_code>() ) );
+    BOOST_TEST_EQ( sizeof( result<int, int> ), with_site( single_buffer<int, int>() ) );
+    BOOST_TEST_EQ( sizeof( result<char, char> ), with_site( single_buffer<char, char>() ) );
+    BOOST_TEST_EQ( sizeof( result<Z> ), with_site( single_buffer<Z, std::error_code>() ) );
+    BOOST_TEST_EQ( sizeof( result<Z, Z> ), with_site( single_buffer<Z, Z>() ) );
+    BOOST_TEST_EQ( sizeof( result<std::string> ), with_site( single_buffer<std::string, std::error_code>() ) );
+    BOOST_TEST_EQ( sizeof( result<std::string, Z> ), with_site( single_buffer<std::string, Z>() ) );
+    BOOST_TEST_EQ( sizeof( result<Z2, Z> ), with_site( single_buffer<Z2, Z>() ) );
+    BOOST_TEST_EQ( sizeof( result<Z2, Z2> ), with_site( single_buffer<Z2, Z2>() ) );
+    BOOST_TEST_EQ( sizeof( result<Y, Z2> ), with_site( single_buffer<Y, Z2>() ) );
+
+    return boost::report_errors();
+}
@@ -0,0 +1,259 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/core/lightweight_test_trait.hpp>
+#include <system_error>
+#include <type_traits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <cerrno>
+
+using namespace boost::result;
+
+// counts copies
+
+struct X
+{
+    static int copies;
+
+    int v_;
+
+    explicit X( int v = 0 ): v_( v ) {}
+
+    X( X const& r ): v_( r.v_ ) { ++copies; }
+    X( X&& r ): v_( r.v_ ) { r.v_ = 0; }
+
+    X& operator=( X const& ) = delete;
+    X& operator=( X&& ) = delete;
+};
+
+int X::copies = 0;
+
+result<int> half( int x )
+{
+    if( x % 2 != 0 ) return std::error_code( EINVAL, std::generic_category() );
+    return x / 2;
+}
+
+#if !defined(BOOST_NO_CXX14_CONSTEXPR)
+
+constexpr int twice( int x )
+{
+    return x * 2;
+}
+
+constexpr result<int, int> checked_twice( int x )
+{
+    return x < 100? result<int, int>( in_place_value, x * 2 ): result<int, int>( in_place_error, x );
+}
+
+#endif
+
+int main()
+{
+    auto ec = std::error_code( EINVAL, std::generic_category() );
+
+    // and_then
+
+    {
+        result<int> r( 8 );
+
+        BOOST_TEST_EQ( r.and_then( half ).and_then( half ), result<int>( 2 ) );
+        BOOST_TEST_EQ( r.and_then( half ).and_then( half ).and_then( half ).and_then( half ), result<int>( ec ) );
+
+        result<int> const cr( ec );
+
+        BOOST_TEST_EQ( cr.and_then( half ), result<int>( ec ) );
+        BOOST_TEST_EQ( and_then( r, half ), result<int>( 4 ) );
+    }
+
+    {
+        result<std::unique_ptr<int>> r( new int( 3 ) );
+
+        result<int> r2 = std::move( r ).and_then( []( std::unique_ptr<int> p ){ return result<int>( *p ); } );
+
+        BOOST_TEST_EQ( r2, result<int>( 3 ) );
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST( *r == 0 );
+    }
+
+    {
+        result<void> r;
+
+        BOOST_TEST_EQ( r.and_then( []{ return result<int>( 1 ); } ), result<int>( 1 ) );
+
+        result<void> r2( ec );
+
+        BOOST_TEST_EQ( r2.and_then( []{ return result<int>( 1 ); } ), result<int>( ec ) );
+    }
+
+    {
+        int x = 4;
+
+        result<int&> r( x );
+
+        BOOST_TEST_EQ( r.and_then( half ), result<int>( 2 ) );
+    }
+
+    // transform
+
+    {
+        result<int> r( 1 );
+
+        auto r2 = r.transform( []( int x ){ return std::to_string( x ); } );
+
+        BOOST_TEST_TRAIT_SAME( decltype( r2 ), result<std::string> );
+        BOOST_TEST_EQ( r2, result<std::string>( "1" ) );
+
+        BOOST_TEST_EQ( result<int>( ec ).transform( []( int x ){ return x + 1; } ), result<int>( ec ) );
+        BOOST_TEST_EQ( transform( r, []( int x ){ return x + 1; } ), result<int>( 2 ) );
+    }
+
+    {
+        int n = 0;
+
+        result<int> r( 1 );
+
+        auto r2 = r.transform( [&]( int x ){ n += x; } );
+
+        BOOST_TEST_TRAIT_SAME( decltype( r2 ), result<void> );
+        BOOST_TEST( r2.has_value() );
+        BOOST_TEST_EQ( n, 1 );
+
+        result<void> r3( ec );
+
+        BOOST_TEST_EQ( r3.transform( [&]{ ++n; return 5; } ), result<int>( ec ) );
+        BOOST_TEST_EQ( n, 1 );
+
+        BOOST_TEST_EQ( result<void>().transform( [&]{ ++n; return 5; } ), result<int>( 5 ) );
+        BOOST_TEST_EQ( n, 2 );
+    }
+
+    // or_else
+
+    {
+        result<int> r( ec );
+
+        BOOST_TEST_EQ( r.or_else( []( std::error_code const& ){ return result<int>( 0 ); } ), result<int>( 0 ) );
+        BOOST_TEST_EQ( result<int>( 1 ).or_else( []( std::error_code const& ){ return result<int>( 0 ); } ), result<int>( 1 ) );
+
+        auto r2 = r.or_else( []( std::error_code const& e ){ return result<int, int>( in_place_error, e.value() ); } );
+
+        BOOST_TEST_TRAIT_SAME( decltype( r2 ), result<int, int> );
+        BOOST_TEST_EQ( r2.error(), EINVAL );
+
+        BOOST_TEST_EQ( or_else( result<void>(), []( std::error_code const& ){ return result<void, int>( in_place_error, 1 ); } ), (result<void, int>()) );
+    }
+
+    {
+        int n = 0;
+
+        result<int> r( ec );
+
+        auto r2 = r.or_else( [&]( std::error_code const& ){ ++n; } );
+
+        BOOST_TEST_TRAIT_SAME( decltype( r2 ), result<int> );
+        BOOST_TEST_EQ( r2, r );
+        BOOST_TEST_EQ( n, 1 );
+
+        result<std::string, std::string> r3( in_place_error, "error" );
+
+        auto r4 = std::move( r3 ).or_else( [&]( std::string e ){ n += static_cast<int>( e.size() ); } );
+
+        BOOST_TEST_EQ( r4.error(), std::string( "error" ) );
+        BOOST_TEST_EQ( n, 6 );
+    }
+
+    // transform_error
+
+    {
+        result<int> r( ec );
+
+        auto r2 = r.transform_error( []( std::error_code const& e ){ return e.value(); } );
+
+        BOOST_TEST_TRAIT_SAME( decltype( r2 ), result<int, int> );
+        BOOST_TEST_EQ( r2.error(), EINVAL );
+
+        BOOST_TEST_EQ( result<int>( 1 ).transform_error( []( std::error_code const& e ){ return e.value(); } ), (result<int, int>( in_place_value, 1 )) );
+        BOOST_TEST_EQ( transform_error( result<void>( ec ), []( std::error_code const& e ){ return e.value(); } ).error(), EINVAL );
+
+        int x = 1;
+
+        result<int&> r3( x );
+
+        BOOST_TEST_EQ( &*r3.transform_error( []( std::error_code const& e ){ return e.value(); } ), &x );
+    }
+
+    // value_or, value_or_else
+
+    {
+        BOOST_TEST_EQ( result<int>( 1 ).value_or( 2 ), 1 );
+        BOOST_TEST_EQ( result<int>( ec ).value_or( 2 ), 2 );
+
+        result<std::string> r( "s" );
+
+        BOOST_TEST_EQ( r.value_or( "t" ), std::string( "s" ) );
+        BOOST_TEST_EQ( value_or( result<std::string>( ec ), "t" ), std::string( "t" ) );
+
+        BOOST_TEST_EQ( result<int>( 1 ).value_or_else( []( std::error_code const& ){ return 2; } ), 1 );
+        BOOST_TEST_EQ( result<int>( ec ).value_or_else( []( std::error_code const& e ){ return -e.value(); } ), -EINVAL );
+        BOOST_TEST_EQ( value_or_else( result<int>( ec ), []( std::error_code const& ){ return 3; } ), 3 );
+
+        int x = 1, y = 2;
+
+        result<int&> r2( x ), r3( ec );
+
+        BOOST_TEST_EQ( &r2.value_or( y ), &x );
+        BOOST_TEST_EQ( &r3.value_or( y ), &y );
+        BOOST_TEST_EQ( &r3.value_or_else( [&]( std::error_code const& ) -> int& { return y; } ), &y );
+    }
+
+    // rvalue chains move T and E through
+
+    {
+        X::copies = 0;
+
+        result<X, X> r( in_place_value, 1 );
+
+        result<X, X> r2 = std::move( r )
+            .and_then( []( X x ){ return result<X, X>( in_place_value, x.v_ + 1 ); } )
+            .transform( []( X x ){ return X( x.v_ * 2 ); } )
+            .or_else( []( X x ){ return result<X, X>( in_place_error, std::move( x ) ); } );
+
+        BOOST_TEST_EQ( r2->v_, 4 );
+        BOOST_TEST_EQ( X::copies, 0 );
+
+        result<X, X> r3( in_place_error, 5 );
+
+        result<X, X> r4 = std::move( r3 )
+            .and_then( []( X x ){ return result<X, X>( in_place_value, std::move( x ) ); } )
+            .transform( []( X x ){ return X( x.v_ * 2 ); } )
+            .transform_error( []( X x ){ return X( x.v_ + 1 ); } );
+
+        BOOST_TEST_EQ( r4.error().v_, 6 );
+        BOOST_TEST_EQ( std::move( r4 ).value_or( X( 7 ) ).v_, 7 );
+        BOOST_TEST_EQ( X::copies, 0 );
+    }
+
+#if !defined(BOOST_NO_CXX14_CONSTEXPR)
+
+    {
+        constexpr result<int, int> r( in_place_value, 1 );
+
+        constexpr int x = r.and_then( checked_twice ).transform( twice ).value_or( 0 );
+        static_assert( x == 4, "x == 4" );
+
+        constexpr result<int, int> r2( in_place_value, 60 );
+
+        constexpr int y = r2.and_then( checked_twice ).and_then( checked_twice ).error();
+        static_assert( y == 120, "y == 120" );
+    }
+
+#endif
+
+    return boost::report_errors();
+}
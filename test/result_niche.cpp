@@ -0,0 +1,322 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/core/lightweight_test_trait.hpp>
+#include <type_traits>
+#include <iosfwd>
+#include <cstddef>
+
+using namespace boost::result;
+
+// an error enum that never holds 255
+
+enum class En
+{
+    e1 = 1,
+    e2 = 2
+};
+
+std::ostream& operator<<( std::ostream& os, En e )
+{
+    os << "En:" << static_cast<int>( e );
+    return os;
+}
+
+namespace boost
+{
+namespace result
+{
+
+template<> struct niche_traits<En>: niche_value<En, static_cast<En>( 255 )>
+{
+};
+
+} // namespace result
+} // namespace boost
+
+// a record whose pointer member is never null
+
+struct R
+{
+    int k_;
+    int const* p_;
+};
+
+bool operator==( R const& r1, R const& r2 )
+{
+    return r1.k_ == r2.k_ && r1.p_ == r2.p_;
+}
+
+std::ostream& operator<<( std::ostream& os, R const& r )
+{
+    os << "R:" << r.k_;
+    return os;
+}
+
+namespace boost
+{
+namespace result
+{
+
+template<> struct niche_traits<R>: niche_at<R, offsetof( R, p_ ), int const*, nullptr>
+{
+};
+
+} // namespace result
+} // namespace boost
+
+// a non-trivial type whose pointer is never null, not even when moved from
+
+struct W
+{
+    static int instances;
+    static int const sentinel;
+
+    int const* p_;
+
+    explicit W( int v ): p_( new int( v ) ) { ++instances; }
+
+    W( W const& r ): p_( new int( *r.p_ ) ) { ++instances; }
+    W( W&& r ) noexcept: p_( r.p_ ) { r.p_ = &sentinel; ++instances; }
+
+    W& operator=( W const& r )
+    {
+        W( r ).swap( *this );
+        return *this;
+    }
+
+    W& operator=( W&& r ) noexcept
+    {
+        W( std::move( r ) ).swap( *this );
+        return *this;
+    }
+
+    void swap( W& r ) noexcept
+    {
+        std::swap( p_, r.p_ );
+    }
+
+    ~W()
+    {
+        if( p_ != &sentinel ) delete p_;
+        --instances;
+    }
+
+    int value() const { return *p_; }
+};
+
+int W::instances = 0;
+int const W::sentinel = 0;
+
+bool operator==( W const& w1, W const& w2 )
+{
+    return w1.value() == w2.value();
+}
+
+std::ostream& operator<<( std::ostream& os, W const& w )
+{
+    os << "W:" << w.value();
+    return os;
+}
+
+namespace boost
+{
+namespace result
+{
+
+template<> struct niche_traits<W>: niche_at<W, 0, int const*, nullptr>
+{
+};
+
+} // namespace result
+} // namespace boost
+
+struct Z
+{
+};
+
+bool operator==( Z, Z )
+{
+    return true;
+}
+
+std::ostream& operator<<( std::ostream& os, Z )
+{
+    os << "Z";
+    return os;
+}
+
+// n, plus the site of the error when it's recorded
+constexpr std::size_t with_site( std::size_t n )
+{
+#if defined(BOOST_RESULT_HAS_SOURCE_LOCATION)
+
+    return ( n + alignof( std::source_location ) - 1 ) / alignof( std::source_location ) * alignof( std::source_location ) + sizeof( std::source_location );
+
+#else
+
+    return n;
+
+#endif
+}
+
+int main()
+{
+    // layout
+
+    BOOST_TEST_EQ( sizeof( result<void, En> ), with_site( sizeof( En ) ) );
+    BOOST_TEST_EQ( sizeof( result<Z, En> ), with_site( sizeof( En ) ) );
+    BOOST_TEST_EQ( sizeof( result<R, int> ), with_site( sizeof( R ) ) );
+    BOOST_TEST_EQ( sizeof( result<R, En> ), with_site( sizeof( R ) ) );
+    BOOST_TEST_EQ( sizeof( result<W, Z> ), with_site( sizeof( W ) ) );
+
+    BOOST_TEST_TRAIT_TRUE((std::is_trivially_copyable< result<void, En> >));
+    BOOST_TEST_TRAIT_TRUE((std::is_trivially_copyable< result<R, int> >));
+    BOOST_TEST_TRAIT_TRUE((std::is_trivially_destructible< result<R, int> >));
+    BOOST_TEST_TRAIT_FALSE((std::is_trivially_copyable< result<W, Z> >));
+
+    // result<void, E> with a niche in E
+
+    {
+        result<void, En> r;
+
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST( !r.has_error() );
+    }
+
+    {
+        result<void, En> r( En::e1 );
+
+        BOOST_TEST( !r.has_value() );
+        BOOST_TEST( r.has_error() );
+
+        BOOST_TEST_EQ( r.error(), En::e1 );
+    }
+
+    {
+        result<void, En> r1, r1c( r1 );
+        result<void, En> r2( En::e2 ), r2c( r2 );
+
+        BOOST_TEST_EQ( r1, r1c );
+        BOOST_TEST_EQ( r2, r2c );
+        BOOST_TEST_NE( r1, r2 );
+
+        r1.swap( r2 );
+
+        BOOST_TEST_EQ( r1, r2c );
+        BOOST_TEST_EQ( r2, r1c );
+
+        r1 = r2;
+
+        BOOST_TEST_EQ( r1, r1c );
+    }
+
+    // a niche in T, with E in the bytes before it
+
+    {
+        int x = 1;
+
+        result<R, int> r( R{ 7, &x } );
+
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST_EQ( r->k_, 7 );
+        BOOST_TEST_EQ( r->p_, &x );
+    }
+
+    {
+        result<R, int> r( in_place_error, 5 );
+
+        BOOST_TEST( r.has_error() );
+        BOOST_TEST_EQ( r.error(), 5 );
+        BOOST_TEST_EQ( r.operator->(), static_cast<R*>( 0 ) );
+    }
+
+    {
+        int x = 1;
+
+        result<R, int> r1( R{ 7, &x } ), r1c( r1 );
+        result<R, int> r2( in_place_error, 5 ), r2c( r2 );
+
+        BOOST_TEST_EQ( r1, r1c );
+        BOOST_TEST_EQ( r2, r2c );
+        BOOST_TEST_NE( r1, r2 );
+
+        swap( r1, r2 );
+
+        BOOST_TEST_EQ( r1, r2c );
+        BOOST_TEST_EQ( r2, r1c );
+
+        r1 = r2;
+
+        BOOST_TEST_EQ( r1, r1c );
+        BOOST_TEST( r1.has_value() );
+    }
+
+    // a niche in a non-trivial T
+
+    BOOST_TEST_EQ( W::instances, 0 );
+
+    {
+        result<W, Z> r( in_place_value, 1 );
+
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST_EQ( r->value(), 1 );
+
+        BOOST_TEST_EQ( W::instances, 1 );
+    }
+
+    BOOST_TEST_EQ( W::instances, 0 );
+
+    {
+        result<W, Z> r( in_place_error );
+
+        BOOST_TEST( r.has_error() );
+
+        BOOST_TEST_EQ( W::instances, 0 );
+    }
+
+    {
+        result<W, Z> r1( in_place_value, 1 ), r1c( r1 );
+        result<W, Z> r2( in_place_error ), r2c( r2 );
+
+        BOOST_TEST_EQ( W::instances, 2 );
+
+        BOOST_TEST_EQ( r1, r1c );
+        BOOST_TEST_EQ( r2, r2c );
+        BOOST_TEST_NE( r1, r2 );
+
+        r1.swap( r2 );
+
+        BOOST_TEST_EQ( r1, r2c );
+        BOOST_TEST_EQ( r2, r1c );
+
+        BOOST_TEST_EQ( W::instances, 2 );
+
+        r1 = r2;
+
+        BOOST_TEST_EQ( r1, r1c );
+        BOOST_TEST_EQ( W::instances, 3 );
+
+        r2 = r2c;
+
+        BOOST_TEST_EQ( r2, r2c );
+        BOOST_TEST_EQ( W::instances, 2 );
+
+        result<W, Z> r3( std::move( r1 ) );
+
+        BOOST_TEST_EQ( r3, r1c );
+        BOOST_TEST_EQ( W::instances, 3 );
+
+        r2 = std::move( r3 );
+
+        BOOST_TEST_EQ( r2, r1c );
+        BOOST_TEST_EQ( W::instances, 4 );
+    }
+
+    BOOST_TEST_EQ( W::instances, 0 );
+
+    return boost::report_errors();
+}
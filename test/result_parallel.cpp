@@ -0,0 +1,190 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/parallel.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/core/lightweight_test_trait.hpp>
+#include <system_error>
+#include <stdexcept>
+#include <numeric>
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+using namespace boost::result;
+
+static std::vector<int> make_input( std::size_t n )
+{
+    std::vector<int> v( n );
+    std::iota( v.begin(), v.end(), 0 );
+    return v;
+}
+
+// fails on the multiples of m
+
+struct F
+{
+    int m;
+    std::atomic<int>* calls;
+
+    result<long, int> operator()( int x ) const
+    {
+        if( calls ) ++*calls;
+
+        if( m != 0 && x != 0 && x % m == 0 ) return result<long, int>( in_place_error, x );
+        return result<long, int>( in_place_value, x * 2L );
+    }
+};
+
+static long plus( long x, long y )
+{
+    return x + y;
+}
+
+int main()
+{
+    std::vector<int> const v = make_input( 100000 );
+    unsigned const threads[] = { 0, 1, 2, 3, 8 };
+
+    for( unsigned t: threads )
+    {
+        // parallel_collect
+
+        {
+            auto r = parallel_collect( v, F{ 0, nullptr }, t );
+
+            BOOST_TEST_TRAIT_SAME( decltype( r ), result<std::vector<long>, int> );
+            BOOST_TEST_EQ( r->size(), v.size() );
+            BOOST_TEST_EQ( (*r)[ 0 ], 0 );
+            BOOST_TEST_EQ( (*r)[ 99999 ], 199998 );
+        }
+
+        {
+            // the error at the lowest index wins, whatever the scheduling
+
+            for( int j = 0; j < 10; ++j )
+            {
+                auto r = parallel_collect( v, F{ 9973, nullptr }, t );
+                BOOST_TEST_EQ( r.error(), 9973 );
+            }
+        }
+
+        // parallel_collect_all
+
+        {
+            auto r = parallel_collect_all( v, F{ 0, nullptr }, t );
+
+            BOOST_TEST_TRAIT_SAME( decltype( r ), result<std::vector<long>, indexed_errors<int>> );
+            BOOST_TEST_EQ( r->size(), v.size() );
+        }
+
+        {
+            auto r = parallel_collect_all( v, F{ 9973, nullptr }, t );
+
+            BOOST_TEST( r.has_error() );
+            BOOST_TEST_EQ( r.error().size(), 10u );
+
+            for( std::size_t i = 0; i < r.error().size(); ++i )
+            {
+                BOOST_TEST_EQ( r.error()[ i ].first, ( i + 1 ) * 9973 );
+                BOOST_TEST_EQ( r.error()[ i ].second, static_cast<int>( ( i + 1 ) * 9973 ) );
+            }
+        }
+
+        // parallel_reduce
+
+        {
+            auto r = parallel_reduce( v, F{ 0, nullptr }, 7, plus, t );
+
+            BOOST_TEST_TRAIT_SAME( decltype( r ), result<long, int> );
+            BOOST_TEST_EQ( *r, 7 + 99999L * 100000L );
+        }
+
+        {
+            auto r = parallel_reduce( v, F{ 12345, nullptr }, 0, plus, t );
+            BOOST_TEST_EQ( r.error(), 12345 );
+        }
+
+        // parallel_reduce_all
+
+        {
+            auto r = parallel_reduce_all( v, F{ 0, nullptr }, 0, plus, t );
+            BOOST_TEST_EQ( *r, 99999L * 100000L );
+        }
+
+        {
+            auto r = parallel_reduce_all( v, F{ 30000, nullptr }, 0, plus, t );
+
+            BOOST_TEST_EQ( r.error().size(), 3u );
+            BOOST_TEST_EQ( r.error()[ 0 ].second, 30000 );
+            BOOST_TEST_EQ( r.error()[ 2 ].second, 90000 );
+        }
+
+        // the _all variants visit every element
+
+        {
+            std::atomic<int> calls( 0 );
+
+            parallel_collect_all( v, F{ 2, &calls }, t );
+            BOOST_TEST_EQ( calls.load(), 100000 );
+        }
+
+        // exceptions propagate
+
+        {
+            BOOST_TEST_THROWS( parallel_collect( v, []( int x ) -> result<int> { if( x == 5000 ) throw std::runtime_error( "" ); return x; }, t ), std::runtime_error );
+        }
+
+        // bool values, which std::vector<bool> would pack into shared words
+
+        {
+            auto r = parallel_collect( v, []( int x ){ return result<bool, int>( in_place_value, x % 3 == 0 ); }, t );
+
+            BOOST_TEST_TRAIT_SAME( decltype( r ), result<std::vector<bool>, int> );
+
+            if( BOOST_TEST_EQ( r->size(), v.size() ) )
+            {
+                for( std::size_t i = 0; i < v.size(); ++i )
+                {
+                    if( !BOOST_TEST_EQ( (*r)[ i ], i % 3 == 0 ) ) break;
+                }
+            }
+
+            auto r2 = parallel_reduce( v, []( int x ){ return result<bool, int>( in_place_value, x != 0 ); }, true, []( bool x, bool y ){ return x && y; }, t );
+
+            BOOST_TEST_EQ( *r2, false );
+        }
+
+        // empty input
+
+        {
+            std::vector<int> const w;
+
+            BOOST_TEST( parallel_collect( w, F{ 0, nullptr }, t )->empty() );
+            BOOST_TEST_EQ( *parallel_reduce( w, F{ 0, nullptr }, 3, plus, t ), 3 );
+        }
+    }
+
+    // an early error cancels the rest of the work
+
+    {
+        std::atomic<int> calls( 0 );
+
+        auto r = parallel_collect( v, F{ 1, &calls }, 1 );
+
+        BOOST_TEST_EQ( r.error(), 1 );
+        BOOST_TEST_EQ( calls.load(), 2 );
+    }
+
+    {
+        std::atomic<int> calls( 0 );
+
+        auto r = parallel_reduce( v, F{ 1, &calls }, 0, plus, 4 );
+
+        BOOST_TEST_EQ( r.error(), 1 );
+        BOOST_TEST_LT( calls.load(), 100000 );
+    }
+
+    return boost::report_errors();
+}
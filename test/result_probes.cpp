@@ -0,0 +1,233 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#if !defined(BOOST_RESULT_ENABLE_PROBES)
+# define BOOST_RESULT_ENABLE_PROBES
+#endif
+
+#include <boost/result/result.hpp>
+#include <boost/config/pragma_message.hpp>
+
+#if !defined(BOOST_RESULT_HAS_PROBES)
+
+BOOST_PRAGMA_MESSAGE( "Skipping test because BOOST_RESULT_HAS_PROBES is not defined" )
+
+int main() {}
+
+#elif !defined(__linux__) || !defined(__LP64__)
+
+BOOST_PRAGMA_MESSAGE( "Skipping test because it reads the ELF notes of a 64 bit Linux executable" )
+
+int main() {}
+
+#else
+
+#include <boost/core/lightweight_test.hpp>
+#include <system_error>
+#include <ios>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <elf.h>
+#include <link.h>
+
+using namespace boost::result;
+
+struct probe
+{
+    std::string provider;
+    std::string name;
+    std::string args;
+    std::uint64_t pc;
+    std::uint64_t semaphore;
+};
+
+// reads the .note.stapsdt section of the running executable
+
+static std::vector<probe> read_probes()
+{
+    std::vector<probe> r;
+
+    std::ifstream is( "/proc/self/exe", std::ios_base::binary );
+    std::vector<char> f( ( std::istreambuf_iterator<char>( is ) ), std::istreambuf_iterator<char>() );
+
+    if( !BOOST_TEST_GE( f.size(), sizeof( Elf64_Ehdr ) ) ) return r;
+
+    Elf64_Ehdr eh;
+    std::memcpy( &eh, f.data(), sizeof( eh ) );
+
+    if( !BOOST_TEST_EQ( eh.e_ident[ EI_CLASS ], ELFCLASS64 ) ) return r;
+
+    std::vector<Elf64_Shdr> sh( eh.e_shnum );
+    std::memcpy( sh.data(), f.data() + eh.e_shoff, eh.e_shnum * sizeof( Elf64_Shdr ) );
+
+    char const* shstr = f.data() + sh[ eh.e_shstrndx ].sh_offset;
+
+    for( Elf64_Shdr const& s: sh )
+    {
+        if( s.sh_type != SHT_NOTE || std::strcmp( shstr + s.sh_name, ".note.stapsdt" ) != 0 ) continue;
+
+        char const* p = f.data() + s.sh_offset;
+        char const* last = p + s.sh_size;
+
+        while( p + sizeof( Elf64_Nhdr ) <= last )
+        {
+            Elf64_Nhdr nh;
+            std::memcpy( &nh, p, sizeof( nh ) );
+
+            char const* name = p + sizeof( nh );
+            char const* desc = name + ( ( nh.n_namesz + 3 ) & ~3u );
+
+            p = desc + ( ( nh.n_descsz + 3 ) & ~3u );
+
+            if( nh.n_type != 3 || std::strcmp( name, "stapsdt" ) != 0 ) continue;
+
+            probe pr;
+
+            std::memcpy( &pr.pc, desc, 8 );
+            std::memcpy( &pr.semaphore, desc + 16, 8 );
+
+            char const* q = desc + 24;
+
+            pr.provider = q; q += pr.provider.size() + 1;
+            pr.name = q; q += pr.name.size() + 1;
+            pr.args = q;
+
+            r.push_back( pr );
+        }
+    }
+
+    return r;
+}
+
+static std::uintptr_t load_bias()
+{
+    std::uintptr_t r = 0;
+
+    // the first object is the executable
+
+    dl_iterate_phdr( []( dl_phdr_info* info, std::size_t, void* p ) -> int {
+
+        *static_cast<std::uintptr_t*>( p ) = info->dlpi_addr;
+        return 1;
+
+    }, &r );
+
+    return r;
+}
+
+static void check_probe( std::vector<probe> const& v, char const* name )
+{
+    int n = 0;
+
+    for( probe const& pr: v )
+    {
+        if( pr.provider != "boost_result" || pr.name != name ) continue;
+
+        ++n;
+
+        // ( char const* category, int value )
+
+        BOOST_TEST_EQ( pr.args.compare( 0, 2, "8@" ), 0 );
+        BOOST_TEST_NE( pr.args.find( " -4@" ), std::string::npos );
+
+#if defined(__x86_64__)
+
+        // the probe site is a NOP
+
+        unsigned char const* pc = reinterpret_cast<unsigned char const*>( pr.pc + load_bias() );
+        BOOST_TEST_EQ( *pc, 0x90 );
+
+#endif
+
+#if defined(BOOST_RESULT_HAS_PROBE_SEMAPHORES)
+
+        // the semaphore is zero when no tracer is attached
+
+        if( BOOST_TEST_NE( pr.semaphore, 0u ) )
+        {
+            unsigned short volatile const* sem = reinterpret_cast<unsigned short volatile const*>( pr.semaphore + load_bias() );
+            BOOST_TEST_EQ( *sem, 0 );
+        }
+
+#endif
+    }
+
+    BOOST_TEST_GE( n, 1 );
+}
+
+enum class E
+{
+    a = 1
+};
+
+int main()
+{
+    {
+        result<int> r( std::error_code( 5, std::generic_category() ) );
+        BOOST_TEST( r.has_error() );
+        BOOST_TEST_THROWS( r.value(), std::system_error );
+    }
+
+    {
+        result<void> r( std::io_errc::stream );
+        BOOST_TEST( r.has_error() );
+        BOOST_TEST_THROWS( r.value(), std::system_error );
+    }
+
+    {
+        result<int, std::errc> r( std::errc::invalid_argument );
+        BOOST_TEST( r.has_error() );
+        BOOST_TEST_THROWS( r.value(), std::system_error );
+    }
+
+    {
+        // no probe for errors that aren't error codes
+
+        result<int, E> r( E::a );
+        BOOST_TEST( r.has_error() );
+        BOOST_TEST_THROWS( r.value(), bad_result_access<E> );
+    }
+
+    {
+        result<int> r( 1 );
+        BOOST_TEST_EQ( r.value(), 1 );
+
+        r = std::error_code( 5, std::generic_category() );
+        BOOST_TEST( r.has_error() );
+    }
+
+#if defined(BOOST_RESULT_HAS_PROBE_SEMAPHORES)
+
+    {
+        // as if a tracer were attached
+
+        boost_result_error_semaphore = 1;
+        boost_result_throw_semaphore = 1;
+
+        result<int> r( std::error_code( 5, std::generic_category() ) );
+        BOOST_TEST( r.has_error() );
+        BOOST_TEST_THROWS( r.value(), std::system_error );
+
+        result<int, std::errc> r2( std::errc::invalid_argument );
+        BOOST_TEST_THROWS( r2.value(), std::system_error );
+
+        boost_result_error_semaphore = 0;
+        boost_result_throw_semaphore = 0;
+    }
+
+#endif
+
+    std::vector<probe> v = read_probes();
+
+    check_probe( v, "error" );
+    check_probe( v, "throw" );
+
+    return boost::report_errors();
+}
+
+#endif
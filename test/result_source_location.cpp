@@ -0,0 +1,141 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#if !defined(BOOST_RESULT_ENABLE_SOURCE_LOCATION)
+# define BOOST_RESULT_ENABLE_SOURCE_LOCATION
+#endif
+
+#include <boost/result/result.hpp>
+#include <boost/config/pragma_message.hpp>
+
+#if !defined(BOOST_RESULT_HAS_SOURCE_LOCATION)
+
+BOOST_PRAGMA_MESSAGE( "Skipping test because BOOST_RESULT_HAS_SOURCE_LOCATION is not defined" )
+
+int main() {}
+
+#else
+
+#include <boost/result/try.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <system_error>
+#include <string>
+#include <cstring>
+#include <cerrno>
+
+using namespace boost::result;
+
+static std::error_code const e1( EINVAL, std::generic_category() );
+
+static int const line_f = __LINE__ + 4;
+
+result<int> f( int x )
+{
+    if( x < 0 ) return e1;
+    return x;
+}
+
+static int const line_g = __LINE__ + 4;
+
+result<int> g()
+{
+    return { EINVAL, std::generic_category() };
+}
+
+static int const line_h = __LINE__ + 4;
+
+result<int> h()
+{
+    return result<int>( in_place_error, e1 );
+}
+
+result<long> k( int x )
+{
+    BOOST_RESULT_TRY( int y, f( x ) );
+    return y + 1;
+}
+
+static int const line_v = __LINE__ + 4;
+
+result<void> v()
+{
+    return e1;
+}
+
+static int x = 0;
+
+static int const line_rr = __LINE__ + 4;
+
+result<int&> rr( bool e )
+{
+    if( e ) return result<int&>( e1 );
+    return x;
+}
+
+static bool function_is( std::source_location const& loc, char const* name )
+{
+    return std::strstr( loc.function_name(), name ) != 0;
+}
+
+int main()
+{
+    {
+        result<int> r = f( -1 );
+
+        BOOST_TEST_EQ( r.error_location().line(), line_f );
+        BOOST_TEST( function_is( r.error_location(), "f" ) );
+        BOOST_TEST( std::strstr( r.error_location().file_name(), "result_source_location.cpp" ) != 0 );
+    }
+
+    {
+        result<int> r = f( 1 );
+        BOOST_TEST_EQ( r.error_location().line(), 0 );
+    }
+
+    BOOST_TEST_EQ( g().error_location().line(), line_g );
+    BOOST_TEST_EQ( h().error_location().line(), line_h );
+    BOOST_TEST_EQ( v().error_location().line(), line_v );
+    BOOST_TEST_EQ( rr( true ).error_location().line(), line_rr );
+
+    // propagation keeps the original site
+
+    BOOST_TEST_EQ( k( -1 ).error_location().line(), line_f );
+
+    BOOST_TEST_EQ( f( -1 ).and_then( []( int y ){ return result<int>( y ); } ).error_location().line(), line_f );
+    BOOST_TEST_EQ( f( -1 ).transform( []( int y ){ return y + 1; } ).error_location().line(), line_f );
+    BOOST_TEST_EQ( f( -1 ).transform_error( []( std::error_code const& e ){ return e.value(); } ).error_location().line(), line_f );
+
+    // copies and swap
+
+    {
+        result<int> r1 = f( -1 );
+        result<int> r2 = r1;
+
+        BOOST_TEST_EQ( r2.error_location().line(), line_f );
+
+        result<int> r3 = g();
+
+        swap( r2, r3 );
+
+        BOOST_TEST_EQ( r2.error_location().line(), line_g );
+        BOOST_TEST_EQ( r3.error_location().line(), line_f );
+    }
+
+    // assignment and emplace_error leave the site empty
+
+    {
+        result<int> r = f( -1 );
+
+        r = e1;
+        BOOST_TEST_EQ( r.error_location().line(), 0 );
+
+        r = f( -1 );
+        r.emplace_error( e1 );
+        BOOST_TEST_EQ( r.error_location().line(), 0 );
+    }
+
+    return boost::report_errors();
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include <boost/result/result.hpp>
 #include <boost/core/lightweight_test.hpp>
 #include <system_error>
+#include <memory>
 #include <iosfwd>
 #include <cerrno>
 
@@ -84,6 +85,38 @@ std::ostream& operator<<( std::ostream& os, Y const & y )
 
 int Y::instances = 0;
 
+// owns a heap value; declared trivially relocatable, so swapped by bytes
+
+struct Z
+{
+    std::unique_ptr<int> p_;
+
+    explicit Z( int v ): p_( new int( v ) ) {}
+};
+
+bool operator==( Z const & z1, Z const & z2 )
+{
+    return *z1.p_ == *z2.p_;
+}
+
+std::ostream& operator<<( std::ostream& os, Z const & z )
+{
+    os << "Z:" << *z.p_;
+    return os;
+}
+
+namespace boost
+{
+namespace result
+{
+
+template<> struct is_trivially_relocatable<Z>: std::true_type
+{
+};
+
+} // namespace result
+} // namespace boost
+
 int main()
 {
     {
@@ -215,5 +248,103 @@ int main()
     BOOST_TEST_EQ( X::instances, 0 );
     BOOST_TEST_EQ( Y::instances, 0 );
 
+    {
+        result<void> r1, r1c( r1 );
+        result<void> r2( ENOENT, std::generic_category() ), r2c( r2 );
+
+        r1.swap( r2 );
+
+        BOOST_TEST_EQ( r1, r2c );
+        BOOST_TEST_EQ( r2, r1c );
+
+        swap( r1, r2 );
+
+        BOOST_TEST_EQ( r1, r1c );
+        BOOST_TEST_EQ( r2, r2c );
+    }
+
+    {
+        result<void, Y> r1( in_place_error, 1 ), r1c( in_place_error, 1 );
+        result<void, Y> r2( in_place_error, 2 ), r2c( in_place_error, 2 );
+
+        BOOST_TEST_EQ( Y::instances, 4 );
+
+        r1.swap( r2 );
+
+        BOOST_TEST_EQ( r1, r2c );
+        BOOST_TEST_EQ( r2, r1c );
+
+        BOOST_TEST_EQ( Y::instances, 4 );
+    }
+
+    BOOST_TEST_EQ( Y::instances, 0 );
+
+    {
+        int x1 = 1, x2 = 2;
+
+        result<int&> r1( x1 ), r1c( r1 );
+        result<int&> r2( x2 ), r2c( r2 );
+
+        r1.swap( r2 );
+
+        BOOST_TEST_EQ( &*r1, &x2 );
+        BOOST_TEST_EQ( &*r2, &x1 );
+
+        swap( r1, r2 );
+
+        BOOST_TEST_EQ( &*r1, &x1 );
+        BOOST_TEST_EQ( &*r2, &x2 );
+
+        BOOST_TEST_EQ( x1, 1 );
+        BOOST_TEST_EQ( x2, 2 );
+    }
+
+    {
+        int x1 = 1;
+
+        result<int&> r1( x1 ), r1c( r1 );
+        result<int&> r2( ENOENT, std::generic_category() ), r2c( r2 );
+
+        r1.swap( r2 );
+
+        BOOST_TEST_EQ( r1, r2c );
+        BOOST_TEST_EQ( r2, r1c );
+    }
+
+    BOOST_TEST( is_trivially_relocatable< result<int> >::value );
+    BOOST_TEST( is_trivially_relocatable< result<int&> >::value );
+    BOOST_TEST( is_trivially_relocatable< result<void> >::value );
+    BOOST_TEST(( is_trivially_relocatable< result<Z, Z> >::value ));
+    BOOST_TEST(( !is_trivially_relocatable< result<X, Z> >::value ));
+
+    {
+        result<Z, Z> r1( in_place_value, 1 ), r1c( in_place_value, 1 );
+        result<Z, Z> r2( in_place_value, 2 ), r2c( in_place_value, 2 );
+        result<Z, Z> r3( in_place_error, 3 ), r3c( in_place_error, 3 );
+        result<Z, Z> r4( in_place_error, 4 ), r4c( in_place_error, 4 );
+
+        BOOST_TEST( noexcept( r1.swap( r2 ) ) );
+
+        r1.swap( r2 );
+
+        BOOST_TEST_EQ( r1, r2c );
+        BOOST_TEST_EQ( r2, r1c );
+
+        r1.swap( r3 );
+
+        BOOST_TEST_EQ( r1, r3c );
+        BOOST_TEST_EQ( r3, r2c );
+
+        swap( r4, r1 );
+
+        BOOST_TEST_EQ( r1, r4c );
+        BOOST_TEST_EQ( r4, r3c );
+
+        swap( r4, r1 );
+
+        BOOST_TEST_EQ( r1, r3c );
+        BOOST_TEST_EQ( r4, r4c );
+    }
+
     return boost::report_errors();
 }
@@ -0,0 +1,133 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <system_error>
+#include <exception>
+#include <stdexcept>
+#include <memory>
+#include <cerrno>
+
+using namespace boost::result;
+
+int throw_from_second_tu();
+
+// no throw_exception_from_error overload
+
+enum class En
+{
+    e1 = 1
+};
+
+// an overload found by argument dependent lookup
+
+namespace app
+{
+
+struct my_error
+{
+    int code_;
+};
+
+struct my_exception: std::exception
+{
+    int code_;
+
+    explicit my_exception( int code ): code_( code ) {}
+};
+
+BOOST_NORETURN void throw_exception_from_error( my_error const& e )
+{
+    throw my_exception( e.code_ );
+}
+
+} // namespace app
+
+int main()
+{
+    {
+        result<int> r( ENOENT, std::generic_category() );
+
+        BOOST_TEST_THROWS( r.value(), std::system_error );
+    }
+
+    {
+        result<int, std::errc> r( std::errc::invalid_argument );
+
+        try
+        {
+            r.value();
+            BOOST_ERROR( "value() didn't throw" );
+        }
+        catch( std::system_error const& x )
+        {
+            BOOST_TEST( x.code() == std::errc::invalid_argument );
+        }
+    }
+
+    {
+        result<int, std::exception_ptr> r( std::make_exception_ptr( std::range_error( "r" ) ) );
+
+        BOOST_TEST_THROWS( r.value(), std::range_error );
+    }
+
+    {
+        result<int, std::exception_ptr> r( in_place_error );
+
+        BOOST_TEST_THROWS( r.value(), bad_result_access<void> );
+    }
+
+    {
+        result<int, En> r( En::e1 );
+
+        try
+        {
+            r.value();
+            BOOST_ERROR( "value() didn't throw" );
+        }
+        catch( bad_result_access<En> const& x )
+        {
+            BOOST_TEST( x.error() == En::e1 );
+        }
+    }
+
+    {
+        result<void, int> r( 5 );
+
+        try
+        {
+            r.value();
+            BOOST_ERROR( "value() didn't throw" );
+        }
+        catch( bad_result_access<int> const& x )
+        {
+            BOOST_TEST_EQ( x.error(), 5 );
+        }
+    }
+
+    {
+        result<int, std::unique_ptr<int>> r( new int( 1 ) );
+
+        BOOST_TEST_THROWS( r.value(), bad_result_access<void> );
+    }
+
+    {
+        result<int&, app::my_error> r( app::my_error{ 3 } );
+
+        try
+        {
+            r.value();
+            BOOST_ERROR( "value() didn't throw" );
+        }
+        catch( app::my_exception const& x )
+        {
+            BOOST_TEST_EQ( x.code_, 3 );
+        }
+    }
+
+    BOOST_TEST_THROWS( throw_from_second_tu(), std::system_error );
+
+    return boost::report_errors();
+}
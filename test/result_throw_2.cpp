@@ -0,0 +1,18 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// A second translation unit for result_throw.cpp, checking that
+// result.hpp can be included from more than one
+
+#include <boost/result/result.hpp>
+#include <system_error>
+#include <cerrno>
+
+using namespace boost::result;
+
+int throw_from_second_tu()
+{
+    result<int> r( ENOENT, std::generic_category() );
+    return r.value();
+}
@@ -0,0 +1,102 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result.hpp>
+#include <boost/result/compact_error_code.hpp>
+#include <boost/config.hpp>
+#include <boost/config/pragma_message.hpp>
+
+#if defined( BOOST_LIBSTDCXX_VERSION ) && BOOST_LIBSTDCXX_VERSION < 50000
+
+BOOST_PRAGMA_MESSAGE( "Skipping test because libstdc++ lacks std::is_trivially_*" )
+
+#else
+
+#include <type_traits>
+
+using namespace boost::result;
+
+enum En
+{
+    e1 = 1
+};
+
+enum class En2: unsigned char
+{
+    e1 = 1
+};
+
+struct X
+{
+    int v_;
+};
+
+template<class R> struct is_trivial_result: std::integral_constant<bool,
+    std::is_trivially_copyable<R>::value &&
+    std::is_trivially_copy_constructible<R>::value &&
+    std::is_trivially_move_constructible<R>::value &&
+    std::is_trivially_copy_assignable<R>::value &&
+    std::is_trivially_move_assignable<R>::value &&
+    std::is_trivially_destructible<R>::value
+>
+{
+};
+
+// trivially copyable, and small enough to travel in two registers
+template<class R> struct is_register_result: std::integral_constant<bool,
+    is_trivial_result<R>::value && sizeof( R ) <= 2 * sizeof( void* )
+>
+{
+};
+
+#define TEST_TRIVIAL(...) static_assert( is_trivial_result< __VA_ARGS__ >::value, #__VA_ARGS__ " is not trivial" )
+#define TEST_REGISTER(...) static_assert( is_register_result< __VA_ARGS__ >::value, #__VA_ARGS__ " is not returned in registers" )
+
+TEST_TRIVIAL( result<int, int> );
+TEST_TRIVIAL( result<int, En> );
+TEST_TRIVIAL( result<int, En2> );
+TEST_TRIVIAL( result<int*, En> );
+TEST_TRIVIAL( result<En, int*> );
+TEST_TRIVIAL( result<X, En> );
+TEST_TRIVIAL( result<double, X> );
+TEST_TRIVIAL( result<int, compact_error_code> );
+TEST_TRIVIAL( result<X*, compact_error_code> );
+TEST_TRIVIAL( result<int, std::error_code> );
+TEST_TRIVIAL( result<void, int> );
+TEST_TRIVIAL( result<void, En> );
+TEST_TRIVIAL( result<void, compact_error_code> );
+TEST_TRIVIAL( result<void> );
+TEST_TRIVIAL( result<X&, En> );
+TEST_TRIVIAL( result<X const&, compact_error_code> );
+TEST_TRIVIAL( result<int&> );
+
+#if !defined(BOOST_RESULT_HAS_SOURCE_LOCATION)
+
+// the site of the error would take a third word
+
+TEST_REGISTER( result<int, int> );
+TEST_REGISTER( result<int, En> );
+TEST_REGISTER( result<int, En2> );
+TEST_REGISTER( result<int*, En> );
+TEST_REGISTER( result<X, En> );
+TEST_REGISTER( result<int, compact_error_code> );
+TEST_REGISTER( result<X*, compact_error_code> );
+TEST_REGISTER( result<void, compact_error_code> );
+TEST_REGISTER( result<X&, En> );
+
+#endif
+
+// copies of trivial results are constant expressions
+
+constexpr result<int, En> r1( 1 );
+constexpr result<int, En> r2( r1 );
+
+static_assert( r2.has_value(), "r2.has_value()" );
+
+constexpr result<int, En> r3( in_place_error, e1 );
+constexpr result<int, En> r4( r3 );
+
+static_assert( r4.has_error(), "r4.has_error()" );
+
+#endif
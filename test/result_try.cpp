@@ -0,0 +1,160 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/try.hpp>
+#include <boost/result/compact_error_code.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <system_error>
+#include <memory>
+#include <string>
+#include <cerrno>
+
+using namespace boost::result;
+
+// a parser error, converted to std::error_code by a specialization
+
+struct parse_error
+{
+    int pos_;
+};
+
+namespace boost
+{
+namespace result
+{
+
+template<> struct error_converter<parse_error, std::error_code>
+{
+    static std::error_code convert( parse_error const& e )
+    {
+        return std::error_code( e.pos_, std::generic_category() );
+    }
+};
+
+} // namespace result
+} // namespace boost
+
+result<int, parse_error> parse_digit( char ch )
+{
+    if( ch >= '0' && ch <= '9' ) return { in_place_value, ch - '0' };
+    return parse_error{ EINVAL };
+}
+
+result<int> number( char c1, char c2 )
+{
+    BOOST_RESULT_TRY( int x1, parse_digit( c1 ) );
+    BOOST_RESULT_TRY( int x2, parse_digit( c2 ) );
+
+    return x1 * 10 + x2;
+}
+
+result<void> check( char c1, char c2 )
+{
+    BOOST_RESULT_TRY( auto x, number( c1, c2 ) );
+
+    if( x > 50 ) return std::error_code( ERANGE, std::generic_category() );
+
+    return {};
+}
+
+result<int> twice( char c1, char c2 )
+{
+    result<void> r = check( c1, c2 );
+    BOOST_RESULT_TRY( r );
+
+    BOOST_RESULT_TRY( int x, number( c1, c2 ) );
+
+    return x * 2;
+}
+
+// move-only value, E converted by the default error_converter
+
+result<std::unique_ptr<int>, compact_error_code> make( int x )
+{
+    if( x < 0 ) return compact_error_code( EINVAL, std::generic_category() );
+    return std::unique_ptr<int>( new int( x ) );
+}
+
+result<int> deref( int x )
+{
+    BOOST_RESULT_TRY( std::unique_ptr<int> p, make( x ) );
+    return *p;
+}
+
+// lvalue results are copied from, not moved from
+
+result<std::size_t> length( result<std::string> const& r1, result<std::string>& r2 )
+{
+    BOOST_RESULT_TRY( std::string s1, r1 );
+    BOOST_RESULT_TRY( std::string s2, r2 );
+
+    return s1.size() + s2.size();
+}
+
+// references
+
+result<int&> first( int* p, int n )
+{
+    if( n == 0 ) return std::error_code( EDOM, std::generic_category() );
+    return *p;
+}
+
+result<int*> first_ptr( int* p, int n )
+{
+    BOOST_RESULT_TRY( int& x, first( p, n ) );
+    return &x;
+}
+
+#if defined(BOOST_RESULT_HAS_TRY_EXPR)
+
+result<int> sum( char c1, char c2, char c3 )
+{
+    BOOST_RESULT_TRY_EXPR( check( c1, c2 ) );
+    return BOOST_RESULT_TRY_EXPR( number( c1, c2 ) ) + BOOST_RESULT_TRY_EXPR( parse_digit( c3 ) );
+}
+
+#endif
+
+int main()
+{
+    BOOST_TEST_EQ( number( '1', '2' ), result<int>( 12 ) );
+    BOOST_TEST_EQ( number( 'x', '2' ), result<int>( std::error_code( EINVAL, std::generic_category() ) ) );
+    BOOST_TEST_EQ( number( '1', 'x' ), result<int>( std::error_code( EINVAL, std::generic_category() ) ) );
+
+    BOOST_TEST( check( '1', '2' ).has_value() );
+    BOOST_TEST_EQ( check( '7', '0' ), result<void>( std::error_code( ERANGE, std::generic_category() ) ) );
+    BOOST_TEST_EQ( check( '7', 'x' ), result<void>( std::error_code( EINVAL, std::generic_category() ) ) );
+
+    BOOST_TEST_EQ( twice( '1', '2' ), result<int>( 24 ) );
+    BOOST_TEST_EQ( twice( '7', '0' ), result<int>( std::error_code( ERANGE, std::generic_category() ) ) );
+
+    BOOST_TEST_EQ( deref( 3 ), result<int>( 3 ) );
+    BOOST_TEST_EQ( deref( -1 ), result<int>( std::error_code( EINVAL, std::generic_category() ) ) );
+
+    {
+        result<std::string> const r1( "abc" );
+        result<std::string> r2( "de" );
+
+        BOOST_TEST_EQ( length( r1, r2 ), result<std::size_t>( 5 ) );
+        BOOST_TEST_EQ( *r1, std::string( "abc" ) );
+        BOOST_TEST_EQ( *r2, std::string( "de" ) );
+    }
+
+    {
+        int a[] = { 1, 2 };
+
+        BOOST_TEST_EQ( first_ptr( a, 2 ), result<int*>( a ) );
+        BOOST_TEST_EQ( first_ptr( a, 0 ), result<int*>( std::error_code( EDOM, std::generic_category() ) ) );
+    }
+
+#if defined(BOOST_RESULT_HAS_TRY_EXPR)
+
+    BOOST_TEST_EQ( sum( '1', '2', '3' ), result<int>( 15 ) );
+    BOOST_TEST_EQ( sum( '7', '2', '3' ), result<int>( std::error_code( ERANGE, std::generic_category() ) ) );
+    BOOST_TEST_EQ( sum( '1', '2', 'x' ), result<int>( std::error_code( EINVAL, std::generic_category() ) ) );
+
+#endif
+
+    return boost::report_errors();
+}
@@ -255,5 +255,139 @@ int main()
         BOOST_TEST_EQ( (result<X, Y>( ec ).operator->()), static_cast<X*>(0) );
     }
 
+    {
+        result<void> r;
+
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST( !r.has_error() );
+
+        BOOST_TEST( r );
+        BOOST_TEST_NOT( !r );
+
+        r.value();
+        *r;
+
+        BOOST_TEST( r.operator->() != 0 );
+    }
+
+    {
+        result<void> const r;
+
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST( !r.has_error() );
+
+        BOOST_TEST( r );
+        BOOST_TEST_NOT( !r );
+
+        r.value();
+        *r;
+
+        BOOST_TEST( r.operator->() != 0 );
+    }
+
+    {
+        auto ec = make_error_code( std::errc::invalid_argument );
+
+        result<void> r( ec );
+
+        BOOST_TEST( !r.has_value() );
+        BOOST_TEST( r.has_error() );
+
+        BOOST_TEST_NOT( r );
+        BOOST_TEST( !r );
+
+        BOOST_TEST_THROWS( r.value(), std::system_error );
+
+        BOOST_TEST_EQ( r.operator->(), static_cast<void*>(0) );
+    }
+
+    {
+        auto ec = make_error_code( std::errc::invalid_argument );
+
+        result<void> const r( ec );
+
+        BOOST_TEST( !r.has_value() );
+        BOOST_TEST( r.has_error() );
+
+        BOOST_TEST_NOT( r );
+        BOOST_TEST( !r );
+
+        BOOST_TEST_THROWS( r.value(), std::system_error );
+
+        BOOST_TEST_EQ( r.operator->(), static_cast<void const*>(0) );
+    }
+
+    {
+        auto ec = Y();
+
+        result<void, Y> r( ec );
+
+        BOOST_TEST( !r.has_value() );
+        BOOST_TEST( r.has_error() );
+
+        BOOST_TEST_THROWS( r.value(), E );
+    }
+
+    {
+        int x = 1;
+
+        result<int&> const r( x );
+
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST( !r.has_error() );
+
+        BOOST_TEST( r );
+        BOOST_TEST_NOT( !r );
+
+        BOOST_TEST_EQ( &r.value(), &x );
+        BOOST_TEST_EQ( &*r, &x );
+
+        BOOST_TEST_EQ( r.operator->(), &x );
+
+        *r = 2;
+        BOOST_TEST_EQ( x, 2 );
+    }
+
+    {
+        X x( 1 );
+
+        result<X const&> r( x );
+
+        BOOST_TEST_EQ( r.value().v_, 1 );
+        BOOST_TEST_EQ( (*r).v_, 1 );
+        BOOST_TEST_EQ( r->v_, 1 );
+
+        BOOST_TEST_EQ( r.operator->(), &x );
+    }
+
+    {
+        auto ec = make_error_code( std::errc::invalid_argument );
+
+        result<int&> r( ec );
+
+        BOOST_TEST( !r.has_value() );
+        BOOST_TEST( r.has_error() );
+
+        BOOST_TEST_NOT( r );
+        BOOST_TEST( !r );
+
+        BOOST_TEST_THROWS( r.value(), std::system_error );
+
+        BOOST_TEST_EQ( r.operator->(), static_cast<int*>(0) );
+    }
+
+    {
+        auto ec = Y();
+
+        result<X&, Y> r( ec );
+
+        BOOST_TEST( !r.has_value() );
+        BOOST_TEST( r.has_error() );
+
+        BOOST_TEST_THROWS( r.value(), E );
+
+        BOOST_TEST_EQ( r.operator->(), static_cast<X*>(0) );
+    }
+
     return boost::report_errors();
 }
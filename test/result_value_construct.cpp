@@ -121,5 +121,68 @@ int main()
         BOOST_TEST_TRAIT_FALSE((std::is_convertible<int, result<X>>));
     }
 
+    {
+        int x = 1;
+
+        result<int&> r( x );
+
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST( !r.has_error() );
+
+        BOOST_TEST_EQ( &r.value(), &x );
+    }
+
+    {
+        int x = 1;
+
+        result<int const&> r = x;
+
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST( !r.has_error() );
+
+        BOOST_TEST_EQ( &*r, &x );
+    }
+
+    {
+        int x = 1;
+
+        result<int&, int> r( in_place_value, x );
+
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST( !r.has_error() );
+
+        BOOST_TEST_EQ( &*r, &x );
+    }
+
+    BOOST_TEST_EQ( X::instances, 0 );
+
+    {
+        X x( 1 );
+
+        result<X&> r( x );
+
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST( !r.has_error() );
+
+        BOOST_TEST_EQ( r->v_, 1 );
+
+        BOOST_TEST_EQ( X::instances, 1 );
+    }
+
+    BOOST_TEST_EQ( X::instances, 0 );
+
+    {
+        BOOST_TEST_TRAIT_TRUE((std::is_constructible<result<int&>, int&>));
+        BOOST_TEST_TRAIT_TRUE((std::is_convertible<int&, result<int&>>));
+
+        BOOST_TEST_TRAIT_TRUE((std::is_constructible<result<int const&>, int&>));
+        BOOST_TEST_TRAIT_TRUE((std::is_convertible<int&, result<int const&>>));
+
+        BOOST_TEST_TRAIT_FALSE((std::is_constructible<result<int&>, int const&>));
+        BOOST_TEST_TRAIT_FALSE((std::is_constructible<result<int&>, int>));
+        BOOST_TEST_TRAIT_FALSE((std::is_constructible<result<int const&>, int>));
+        BOOST_TEST_TRAIT_FALSE((std::is_constructible<result<int const&>, long&>));
+    }
+
     return boost::report_errors();
 }
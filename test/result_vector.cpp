@@ -0,0 +1,210 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/result_vector.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <system_error>
+#include <string>
+#include <vector>
+#include <cerrno>
+
+using namespace boost::result;
+
+int main()
+{
+    auto ec = std::error_code( EINVAL, std::generic_category() );
+
+    {
+        result_vector<int> v;
+
+        BOOST_TEST( v.empty() );
+        BOOST_TEST_EQ( v.size(), 0u );
+        BOOST_TEST_EQ( v.count_errors(), 0u );
+        BOOST_TEST_EQ( v.find_first_error(), 0u );
+        BOOST_TEST( v.begin() == v.end() );
+    }
+
+    {
+        result_vector<int> v;
+
+        v.push_back( 1 );
+        v.push_back( ec );
+        v.emplace_back_value( 3 );
+
+        BOOST_TEST_EQ( v.size(), 3u );
+
+        BOOST_TEST( v[0].has_value() );
+        BOOST_TEST_EQ( *v[0], 1 );
+        BOOST_TEST_EQ( v[0].value(), 1 );
+
+        BOOST_TEST( v[1].has_error() );
+        BOOST_TEST( !v[1] );
+        BOOST_TEST_EQ( v[1].error(), ec );
+        BOOST_TEST_EQ( v[1].operator->(), static_cast<int*>( 0 ) );
+        BOOST_TEST_THROWS( v[1].value(), std::system_error );
+
+        BOOST_TEST_EQ( v[2], result<int>( 3 ) );
+        BOOST_TEST_NE( v[2], result<int>( ec ) );
+
+        result<int> r = v[1];
+
+        BOOST_TEST_EQ( r, result<int>( ec ) );
+
+        *v[0] = 5;
+
+        BOOST_TEST_EQ( v.data()[0], 5 );
+
+        v[1] = result<int>( 7 );
+
+        BOOST_TEST( v[1].has_value() );
+        BOOST_TEST_EQ( *v[1], 7 );
+        BOOST_TEST_EQ( v.count_errors(), 0u );
+
+        v[2] = result<int>( ec );
+
+        BOOST_TEST_EQ( v[2].error(), ec );
+        BOOST_TEST_EQ( v.count_errors(), 1u );
+        BOOST_TEST_EQ( v.find_first_error(), 2u );
+
+        v[0] = v[2];
+
+        BOOST_TEST_EQ( v[0].error(), ec );
+        BOOST_TEST_EQ( v.count_errors(), 2u );
+        BOOST_TEST_EQ( v.find_first_error(), 0u );
+        BOOST_TEST_EQ( v.find_next_error( 1 ), 2u );
+        BOOST_TEST_EQ( v.find_next_error( 3 ), 3u );
+
+        v.pop_back();
+
+        BOOST_TEST_EQ( v.size(), 2u );
+        BOOST_TEST_EQ( v.count_errors(), 1u );
+        BOOST_TEST_EQ( v.find_next_error( 1 ), 2u );
+
+        result_vector<int> const& cv = v;
+
+        result_vector<int>::const_reference cr = cv[0];
+
+        BOOST_TEST_EQ( cr.error(), ec );
+        BOOST_TEST_EQ( *cv[1], 7 );
+    }
+
+    // bitmap scans across words
+
+    {
+        result_vector<int> v;
+
+        std::size_t const N = 1000;
+
+        v.reserve( N );
+
+        for( std::size_t i = 0; i < N; ++i )
+        {
+            if( i % 97 == 3 || i == 64 || i == 127 || i == 999 )
+            {
+                v.emplace_back_error( static_cast<int>( i ), std::generic_category() );
+            }
+            else
+            {
+                v.emplace_back_value( static_cast<int>( i ) );
+            }
+        }
+
+        std::vector<std::size_t> expected;
+
+        for( std::size_t i = 0; i < N; ++i )
+        {
+            if( i % 97 == 3 || i == 64 || i == 127 || i == 999 ) expected.push_back( i );
+        }
+
+        BOOST_TEST_EQ( v.count_errors(), expected.size() );
+        BOOST_TEST_EQ( v.count_errors( 0, N ), expected.size() );
+        BOOST_TEST_EQ( v.count_errors( 0, 64 ), 1u ); // 3
+        BOOST_TEST_EQ( v.count_errors( 64, 65 ), 1u );
+        BOOST_TEST_EQ( v.count_errors( 65, 127 ), 1u ); // 100
+        BOOST_TEST_EQ( v.count_errors( 65, 128 ), 2u );
+        BOOST_TEST_EQ( v.count_errors( 5, 5 ), 0u );
+        BOOST_TEST_EQ( v.count_errors( 998, 1000 ), 1u );
+
+        std::vector<std::size_t> found;
+
+        for( std::size_t i = v.find_first_error(); i < v.size(); i = v.find_next_error( i + 1 ) )
+        {
+            found.push_back( i );
+            BOOST_TEST_EQ( v[ i ].error().value(), static_cast<int>( i ) );
+        }
+
+        BOOST_TEST( found == expected );
+
+        long long s1 = 0, s2 = 0;
+
+        v.for_each_value( [&]( int x ){ s1 += x; } );
+
+        for( auto r: v )
+        {
+            if( r ) s2 += *r;
+        }
+
+        BOOST_TEST_EQ( s1, s2 );
+
+        std::size_t n = 0;
+
+        for( auto it = v.begin(); it != v.end(); ++it )
+        {
+            if( (*it).has_error() )
+            {
+                BOOST_TEST_EQ( it.index(), expected[ n ] );
+                ++n;
+            }
+        }
+
+        BOOST_TEST_EQ( n, expected.size() );
+
+        while( !v.empty() ) v.pop_back();
+
+        BOOST_TEST_EQ( v.count_errors(), 0u );
+        BOOST_TEST_EQ( v.find_first_error(), 0u );
+    }
+
+    // non-trivial T and E
+
+    {
+        result_vector<std::string, std::string> v;
+
+        v.push_back( result<std::string, std::string>( in_place_value, "a" ) );
+        v.push_back( result<std::string, std::string>( in_place_error, "e" ) );
+        v.emplace_back_error( 3, 'f' );
+
+        BOOST_TEST_EQ( *v[0], std::string( "a" ) );
+        BOOST_TEST_EQ( v[1].error(), std::string( "e" ) );
+        BOOST_TEST_EQ( v[2].error(), std::string( "fff" ) );
+        BOOST_TEST_EQ( v[2].error_or_default(), std::string( "fff" ) );
+        BOOST_TEST_EQ( v[0].error_or_default(), std::string() );
+
+        v.set_error( 1, "g" );
+
+        BOOST_TEST_EQ( v[1].error(), std::string( "g" ) );
+
+        v.set_error( 0, "h" );
+        v.set_value( 2, "b" );
+
+        BOOST_TEST_EQ( v[0].error(), std::string( "h" ) );
+        BOOST_TEST_EQ( v[1].error(), std::string( "g" ) );
+        BOOST_TEST_EQ( *v[2], std::string( "b" ) );
+        BOOST_TEST_EQ( v.count_errors(), 2u );
+
+        result_vector<std::string, std::string> v2;
+
+        swap( v, v2 );
+
+        BOOST_TEST( v.empty() );
+        BOOST_TEST_EQ( v2.size(), 3u );
+
+        v2.clear();
+
+        BOOST_TEST( v2.empty() );
+        BOOST_TEST_EQ( v2.count_errors(), 0u );
+    }
+
+    return boost::report_errors();
+}
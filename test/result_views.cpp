@@ -0,0 +1,181 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/views.hpp>
+#include <boost/result/result_vector.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/core/lightweight_test_trait.hpp>
+#include <system_error>
+#include <string>
+#include <vector>
+#include <list>
+#include <memory>
+#include <cerrno>
+
+using namespace boost::result;
+
+template<class V> auto to_vector( V&& v ) -> std::vector< typename std::decay<decltype( *v.begin() )>::type >
+{
+    std::vector< typename std::decay<decltype( *v.begin() )>::type > r;
+
+    for( auto&& x: v ) r.push_back( x );
+
+    return r;
+}
+
+static result<int> half( int x )
+{
+    if( x % 2 ) return std::error_code( EDOM, std::generic_category() );
+    return x / 2;
+}
+
+int main()
+{
+    auto e1 = std::error_code( EINVAL, std::generic_category() );
+    auto e2 = std::error_code( ENOENT, std::generic_category() );
+
+    std::vector< result<int> > const v{ 1, e1, 2, 3, e2, 4 };
+
+    // values
+
+    {
+        BOOST_TEST( to_vector( views::values( v ) ) == std::vector<int>( { 1, 2, 3, 4 } ) );
+        BOOST_TEST( to_vector( v | views::values ) == std::vector<int>( { 1, 2, 3, 4 } ) );
+        BOOST_TEST( to_vector( views::values( v.begin(), v.end() ) ) == std::vector<int>( { 1, 2, 3, 4 } ) );
+
+        BOOST_TEST_TRAIT_SAME( decltype( *views::values( v ).begin() ), int const& );
+    }
+
+    {
+        std::vector< result<int> > w{ e1, 1, e2, 2 };
+
+        // the values are referred to, not copied
+
+        for( int& x: w | views::values ) x *= 10;
+
+        BOOST_TEST_EQ( *w[ 1 ], 10 );
+        BOOST_TEST_EQ( *w[ 3 ], 20 );
+        BOOST_TEST_EQ( w[ 0 ].error(), e1 );
+    }
+
+    {
+        std::vector< result<int> > w{ e1, e2 };
+        BOOST_TEST( to_vector( w | views::values ).empty() );
+
+        w.clear();
+        BOOST_TEST( to_vector( w | views::values ).empty() );
+    }
+
+    // errors
+
+    {
+        BOOST_TEST( to_vector( views::errors( v ) ) == std::vector<std::error_code>( { e1, e2 } ) );
+        BOOST_TEST( to_vector( v | views::errors ) == std::vector<std::error_code>( { e1, e2 } ) );
+
+        BOOST_TEST_TRAIT_SAME( decltype( *views::errors( v ).begin() ), std::error_code const& );
+    }
+
+    // take_while_ok
+
+    {
+        BOOST_TEST( to_vector( v | views::take_while_ok ) == std::vector<int>( { 1 } ) );
+        BOOST_TEST( to_vector( views::take_while_ok( v.begin() + 2, v.end() ) ) == std::vector<int>( { 2, 3 } ) );
+
+        std::vector< result<int> > w{ 1, 2 };
+        BOOST_TEST( to_vector( w | views::take_while_ok ) == std::vector<int>( { 1, 2 } ) );
+
+        std::vector< result<int> > w2{ e1, 2 };
+        BOOST_TEST( to_vector( w2 | views::take_while_ok ).empty() );
+    }
+
+    // and_then
+
+    {
+        auto r = v | views::and_then( half );
+
+        BOOST_TEST_TRAIT_SAME( decltype( *r.begin() ), result<int> );
+        BOOST_TEST_EQ( to_vector( r ).size(), 6u );
+
+        BOOST_TEST( to_vector( v | views::and_then( half ) | views::values ) == std::vector<int>( { 1, 2 } ) );
+        BOOST_TEST_EQ( to_vector( views::and_then( v, half ) | views::errors ).size(), 4u );
+        BOOST_TEST( to_vector( views::and_then( v.begin() + 2, v.end(), half ) | views::take_while_ok ) == std::vector<int>( { 1 } ) );
+
+        BOOST_TEST_TRAIT_SAME( decltype( *( v | views::and_then( half ) | views::values ).begin() ), int );
+    }
+
+    {
+        // a lambda, over plain values
+
+        int k = 3;
+
+        std::list<int> w{ 6, 9, 10 };
+
+        auto r = w | views::and_then( [&]( int x ) -> result<int> { if( x % k ) return e1; return x / k; } ) | views::values;
+
+        BOOST_TEST( to_vector( r ) == std::vector<int>( { 2, 3 } ) );
+    }
+
+    // move-only values are yielded by reference
+
+    {
+        std::vector< result<std::unique_ptr<int>> > w;
+
+        w.emplace_back( new int( 1 ) );
+        w.emplace_back( e1 );
+        w.emplace_back( new int( 2 ) );
+
+        int s = 0;
+
+        for( auto& p: w | views::values ) s += *p;
+
+        BOOST_TEST_EQ( s, 3 );
+    }
+
+    // result_vector
+
+    {
+        result_vector<std::string> w;
+
+        w.push_back( std::string( "a" ) );
+        w.push_back( e1 );
+        w.push_back( std::string( "b" ) );
+
+        BOOST_TEST( to_vector( w | views::values ) == std::vector<std::string>( { "a", "b" } ) );
+        BOOST_TEST( to_vector( w | views::errors ) == std::vector<std::error_code>( { e1 } ) );
+        BOOST_TEST( to_vector( w | views::take_while_ok ) == std::vector<std::string>( { "a" } ) );
+
+        auto f = []( std::string const& s ) -> result<std::size_t> { return s.size(); };
+
+        BOOST_TEST( to_vector( w | views::and_then( f ) | views::values ) == std::vector<std::size_t>( { 1, 1 } ) );
+    }
+
+    // an rvalue range is moved into the view
+
+    {
+        auto r = std::vector< result<int> >{ 1, e1, 5 } | views::values;
+        BOOST_TEST( to_vector( r ) == std::vector<int>( { 1, 5 } ) );
+    }
+
+#if defined(BOOST_RESULT_HAS_STD_RANGES)
+
+    // composition with std::ranges
+
+    {
+        static_assert( std::ranges::view< decltype( v | views::values ) >, "values must model view" );
+        static_assert( std::ranges::forward_range< decltype( v | views::values ) >, "values must model forward_range" );
+        static_assert( std::ranges::view< decltype( v | views::and_then( []( int x ){ return half( x ); } ) ) >, "and_then must model view" );
+
+        auto r = v | std::views::take( 4 ) | views::values | std::views::transform( []( int x ){ return x * 2; } );
+        BOOST_TEST( to_vector( r ) == std::vector<int>( { 2, 4, 6 } ) );
+
+        auto r2 = v | std::views::take_while( []( result<int> const& x ){ return x != result<int>( 4 ); } ) | views::errors;
+        BOOST_TEST( to_vector( r2 ) == std::vector<std::error_code>( { e1, e2 } ) );
+
+        BOOST_TEST_EQ( std::ranges::distance( v | views::errors ), 2 );
+    }
+
+#endif
+
+    return boost::report_errors();
+}
@@ -0,0 +1,175 @@
+// Copyright 2021 Peter Dimov.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/result/traced_error_code.hpp>
+#include <boost/result/result.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/core/lightweight_test_trait.hpp>
+#include <boost/config.hpp>
+#include <system_error>
+#include <type_traits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cerrno>
+
+using namespace boost::result;
+
+BOOST_NOINLINE result<int, traced_error_code> f( int x )
+{
+    if( x < 0 ) return std::error_code( EINVAL, std::generic_category() );
+    return x;
+}
+
+BOOST_NOINLINE result<int, traced_error_code> g( int x )
+{
+    if( x < 0 ) return std::error_code( EINVAL, std::system_category() );
+    return x;
+}
+
+static std::string to_string( traced_error_code const& e )
+{
+    std::ostringstream os;
+    os << e;
+    return os.str();
+}
+
+int main()
+{
+    BOOST_TEST_EQ( sizeof( traced_error_code ), 16 );
+    BOOST_TEST_TRAIT_TRUE((std::is_trivially_copyable<traced_error_code>));
+
+    {
+        traced_error_code e;
+
+        BOOST_TEST( !e );
+        BOOST_TEST( e == std::error_code() );
+        BOOST_TEST( !e.has_stack_trace() );
+    }
+
+    // off by default
+
+    {
+        BOOST_TEST_EQ( stack_trace_sampling( std::generic_category() ), 0 );
+
+        result<int, traced_error_code> r = f( -1 );
+
+        BOOST_TEST( r.has_error() );
+        BOOST_TEST( r.error() == std::error_code( EINVAL, std::generic_category() ) );
+        BOOST_TEST( !r.error().has_stack_trace() );
+        BOOST_TEST_EQ( to_string( r.error() ), "generic:" + std::to_string( EINVAL ) );
+
+        BOOST_TEST_THROWS( r.value(), std::system_error );
+    }
+
+#if defined(BOOST_RESULT_HAS_STACK_TRACE)
+
+    set_stack_trace_sampling( std::generic_category(), 1 );
+
+    {
+        BOOST_TEST_EQ( stack_trace_sampling( std::generic_category() ), 1 );
+
+        result<int, traced_error_code> r = f( -1 );
+
+        BOOST_TEST( r.error().has_stack_trace() );
+
+        void* frames[ 64 ];
+        std::size_t n = r.error().stack_trace( frames, 64 );
+
+        BOOST_TEST_GE( n, 2 );
+        BOOST_TEST_EQ( r.error().stack_trace( frames, 1 ), 1 );
+
+        std::string s = to_string( r.error() );
+
+        BOOST_TEST_EQ( s.substr( 0, s.find( '\n' ) ), "generic:" + std::to_string( EINVAL ) );
+        BOOST_TEST( s.find( "\n    #0 0x" ) != std::string::npos );
+        BOOST_TEST( s.find( "\n    #1 0x" ) != std::string::npos );
+
+        // copies share the trace
+
+        traced_error_code e2 = r.error();
+        BOOST_TEST_EQ( e2.stack_trace( frames, 64 ), n );
+
+        // the other categories are not affected
+
+        BOOST_TEST( !g( -1 ).error().has_stack_trace() );
+
+        // success doesn't capture
+
+        BOOST_TEST( f( 1 ).has_value() );
+    }
+
+    // one in three, per thread
+
+    {
+        set_stack_trace_sampling( std::generic_category(), 3 );
+
+        // reset the thread's count
+        for( int i = 0; i < 3 && !f( -1 ).error().has_stack_trace(); ++i );
+
+        int k = 0;
+
+        for( int i = 0; i < 30; ++i )
+        {
+            if( f( -1 ).error().has_stack_trace() ) ++k;
+        }
+
+        BOOST_TEST_EQ( k, 10 );
+    }
+
+    // traces expire when the ring wraps around
+
+    {
+        set_stack_trace_sampling( std::generic_category(), 1 );
+
+        traced_error_code e = f( -1 ).error();
+
+        for( int i = 0; i < BOOST_RESULT_STACK_TRACE_SLOTS; ++i )
+        {
+            f( -1 );
+        }
+
+        void* frames[ 64 ];
+
+        BOOST_TEST( e.has_stack_trace() );
+        BOOST_TEST_EQ( e.stack_trace( frames, 64 ), 0 );
+        BOOST_TEST_EQ( to_string( e ), "generic:" + std::to_string( EINVAL ) + " (stack trace expired)" );
+    }
+
+    // several threads
+
+    {
+        std::vector<std::thread> th;
+
+        for( int t = 0; t < 4; ++t )
+        {
+            th.emplace_back( []{
+
+                for( int i = 0; i < 1000; ++i )
+                {
+                    traced_error_code e = f( -1 ).error();
+
+                    void* frames[ 64 ];
+                    std::size_t n = e.stack_trace( frames, 64 );
+
+                    // the trace may have expired, but is never torn
+                    BOOST_TEST( n == 0 || frames[ n - 1 ] != 0 );
+
+                    to_string( e );
+                }
+            });
+        }
+
+        for( auto& x: th ) x.join();
+    }
+
+    set_stack_trace_sampling( std::generic_category(), 0 );
+
+    BOOST_TEST( !f( -1 ).error().has_stack_trace() );
+
+#endif
+
+    return boost::report_errors();
+}